@@ -0,0 +1,196 @@
+/*
+ * \brief  Bump-pointer allocator for short-lived objects
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BASE__ARENA_H_
+#define _INCLUDE__BASE__ARENA_H_
+
+#include <util/noncopyable.h>
+#include <util/misc_math.h>
+#include <base/allocator.h>
+#include <base/ram_allocator.h>
+#include <region_map/region_map.h>
+
+namespace Genode { class Arena; }
+
+
+/**
+ * Allocator that hands out memory by advancing a pointer
+ *
+ * The arena is meant for objects that live no longer than a certain
+ * operation, e.g., the handling of a request or the evaluation of a
+ * configuration. An allocation merely advances a pointer within the current
+ * chunk of backing store. Individual blocks are never freed. Instead, all
+ * blocks allocated since a 'Mark' are released at once by resetting the
+ * arena to this mark, which is an O(1) operation. Marks can be nested but
+ * must be reset in reverse order. The 'Scope' utility resets the arena to
+ * the state at its construction when leaving the scope.
+ *
+ * The backing store is obtained from a RAM allocator in chunks of at least
+ * 'chunk_size' bytes. Chunks are retained on reset and reused for
+ * subsequent allocations, so an arena that is reset after each request
+ * reaches a steady state without interacting with the RAM allocator. The
+ * 'trim' method releases the chunks that are not in use.
+ *
+ * The arena is not thread safe.
+ */
+class Genode::Arena : public Allocator, Noncopyable
+{
+	private:
+
+		enum { ALIGN_LOG2 = 4 };
+
+		struct Chunk
+		{
+			Ram_dataspace_capability const ds;
+			size_t                   const size;
+			Chunk                         *next = nullptr;
+
+			Chunk(Ram_dataspace_capability ds, size_t size)
+			: ds(ds), size(size) { }
+
+			/**
+			 * Size of the chunk header, which keeps the blocks aligned
+			 */
+			static size_t header_size() {
+				return align_addr(sizeof(Chunk), ALIGN_LOG2); }
+
+			addr_t base() const { return (addr_t)this + header_size(); }
+			addr_t end()  const { return (addr_t)this + size; }
+		};
+
+		Ram_allocator &_ram;
+		Region_map    &_rm;
+		size_t const   _chunk_size;
+
+		Chunk  *_first      = nullptr; /* chunks in the order of their use */
+		Chunk  *_curr       = nullptr; /* chunk of the last allocation     */
+		addr_t  _top        = 0;       /* first unused byte of '_curr'     */
+		size_t  _used       = 0;       /* bytes handed out                 */
+		size_t  _high_water = 0;       /* maximum of '_used'               */
+		size_t  _consumed   = 0;       /* bytes of backing store           */
+
+		/**
+		 * Continue allocating at a chunk that provides 'size' bytes
+		 */
+		bool _advance(size_t size);
+
+		void _free_chunk(Chunk &chunk);
+
+	public:
+
+		enum { DEFAULT_CHUNK_SIZE = 64*1024 };
+
+		/**
+		 * Position within an arena
+		 */
+		class Mark
+		{
+			private:
+
+				friend class Arena;
+
+				Chunk  *_chunk = nullptr;
+				addr_t  _top   = 0;
+				size_t  _used  = 0;
+		};
+
+		/**
+		 * Guard that resets the arena when leaving the scope
+		 */
+		class Scope : Noncopyable
+		{
+			private:
+
+				Arena      &_arena;
+				Mark const  _mark;
+
+			public:
+
+				Scope(Arena &arena) : _arena(arena), _mark(arena.mark()) { }
+
+				~Scope() { _arena.reset(_mark); }
+		};
+
+		/**
+		 * Constructor
+		 *
+		 * \param chunk_size  minimum size of the backing-store chunks
+		 */
+		Arena(Ram_allocator &ram, Region_map &rm,
+		      size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+		~Arena();
+
+		/**
+		 * Return current position
+		 */
+		Mark mark() const;
+
+		/**
+		 * Release all blocks allocated since 'mark' was taken
+		 */
+		void reset(Mark const &mark);
+
+		/**
+		 * Release all blocks
+		 */
+		void reset() { reset(Mark()); }
+
+		/**
+		 * Release the backing store that is currently not in use
+		 */
+		void trim();
+
+		/**
+		 * Return number of bytes currently handed out
+		 */
+		size_t used() const { return _used; }
+
+		/**
+		 * Return maximum number of bytes handed out at a time
+		 */
+		size_t high_water_mark() const { return _high_water; }
+
+
+		/*************************
+		 ** Allocator interface **
+		 *************************/
+
+		bool alloc(size_t size, void **out_addr) override
+		{
+			size = align_addr(size, ALIGN_LOG2);
+
+			if (!_curr || _top + size > _curr->end())
+				if (!_advance(size))
+					return false;
+
+			*out_addr = (void *)_top;
+			_top     += size;
+			_used    += size;
+			if (_used > _high_water)
+				_high_water = _used;
+
+			return true;
+		}
+
+		/**
+		 * Blocks are released only by resetting the arena
+		 */
+		void free(void *, size_t) override { }
+
+		size_t consumed()           const override { return _consumed; }
+		size_t overhead(size_t)     const override { return 0; }
+		bool   need_size_for_free() const override { return false; }
+};
+
+#endif /* _INCLUDE__BASE__ARENA_H_ */
@@ -64,6 +64,9 @@ class Genode::Entrypoint : Genode::Noncopyable
 				ep(ep)
 			{ start(); }
 
+			Signal_proxy_thread(Env &env, Entrypoint &ep,
+			                    Affinity::Location location);
+
 			void entry() override { ep._process_incoming_signals(); }
 		};
 
@@ -133,6 +136,16 @@ class Genode::Entrypoint : Genode::Noncopyable
 
 		Entrypoint(Env &env, size_t stack_size, char const *name);
 
+		/**
+		 * Constructor
+		 *
+		 * \param location  CPU affinity of the entrypoint and its signal
+		 *                  proxy, relative to the affinity space of the
+		 *                  component's CPU session
+		 */
+		Entrypoint(Env &env, size_t stack_size, char const *name,
+		           Affinity::Location location);
+
 		~Entrypoint()
 		{
 			_rpc_ep->dissolve(&_signal_proxy);
@@ -71,6 +71,20 @@ class Genode::Heap : public Allocator
 				ram_alloc = ram, region_map = rm; }
 		};
 
+		/*
+		 * Small blocks are served from slab pages, each dedicated to one size
+		 * class. This way, their allocation and release neither walk the AVL
+		 * tree of the local allocator nor need a meta-data entry per block.
+		 */
+		enum {
+			SMALL_PAGE_SIZE_LOG2 = 12,
+			SMALL_PAGE_SIZE      = 1 << SMALL_PAGE_SIZE_LOG2,
+			SMALL_MAX_SIZE       = 1024,
+			SMALL_NUM_CLASSES    = 20,
+		};
+
+		struct Small_page;
+
 		Lock                           _lock;
 		Reconstructible<Allocator_avl> _alloc;        /* local allocator    */
 		Dataspace_pool                 _ds_pool;      /* list of dataspaces */
@@ -78,6 +92,11 @@ class Genode::Heap : public Allocator
 		size_t                         _quota_used;
 		size_t                         _chunk_size;
 
+		Small_page  *_small_avail[SMALL_NUM_CLASSES] { }; /* pages with free slots */
+		Small_page **_small_pages     = nullptr;          /* slab pages by address */
+		unsigned     _small_pages_num = 0;
+		unsigned     _small_pages_max = 0;
+
 		/**
 		 * Allocate a new dataspace of the specified size
 		 *
@@ -95,16 +114,45 @@ class Genode::Heap : public Allocator
 		 *
 		 * \return true on success
 		 *
-		 * This method is a utility used by '_unsynchronized_alloc' to
+		 * This method is a utility used by '_unsynchronized_local_alloc' to
 		 * avoid code duplication.
 		 */
-		bool _try_local_alloc(size_t size, void **out_addr);
+		bool _try_local_alloc(size_t size, void **out_addr, unsigned align_log2);
+
+		/**
+		 * Allocate block at our local allocator, expand it if needed
+		 *
+		 * The block is not accounted as used quota.
+		 */
+		bool _unsynchronized_local_alloc(size_t size, void **out_addr,
+		                                 unsigned align_log2);
 
 		/**
 		 * Unsynchronized implementation of 'alloc'
 		 */
 		bool _unsynchronized_alloc(size_t size, void **out_addr);
 
+		/**
+		 * Return size class for blocks of up to 'SMALL_MAX_SIZE' bytes
+		 */
+		static unsigned _small_class(size_t size);
+
+		/**
+		 * Return size of the blocks of size class 'cls'
+		 */
+		static size_t _small_class_size(unsigned cls);
+
+		/**
+		 * Return slab page that contains 'addr' or nullptr
+		 */
+		unsigned    _small_page_pos(addr_t base) const;
+		Small_page *_small_page(void const *addr) const;
+
+		Small_page *_new_small_page(unsigned cls);
+		void        _release_small_page(Small_page &);
+		bool        _small_alloc(unsigned cls, void **out_addr);
+		void        _small_free(Small_page &, void *addr);
+
 	public:
 
 		enum { UNLIMITED = ~0 };
@@ -141,7 +189,7 @@ class Genode::Heap : public Allocator
 		bool   alloc(size_t, void **) override;
 		void   free(void *, size_t) override;
 		size_t consumed() const override { return _quota_used; }
-		size_t overhead(size_t size) const override { return _alloc->overhead(size); }
+		size_t overhead(size_t size) const override;
 		bool   need_size_for_free() const override { return false; }
 };
 
@@ -0,0 +1,226 @@
+/*
+ * \brief  Pre-indexed view of an XML document
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__UTIL__XML_INDEX_H_
+#define _INCLUDE__UTIL__XML_INDEX_H_
+
+#include <util/xml_node.h>
+#include <util/noncopyable.h>
+#include <base/allocator.h>
+
+
+/**
+ * Index of the nodes and attributes of an XML document
+ *
+ * Constructing an 'Xml_node' scans the whole content of the node to find
+ * its end tag, and each sub-node access scans the content again. Nested
+ * traversals of large documents thereby become expensive. The index scans
+ * the document once and records the tags and attributes of all nodes. The
+ * 'Xml_node' returned by 'xml()' and all nodes obtained from it navigate
+ * along the recorded entries and never scan the content again.
+ *
+ * Only the top-level node is indexed, data following its end tag is
+ * ignored. In contrast to 'Xml_node', which validates a node only when
+ * accessing it, the index requires the whole document to be well formed.
+ *
+ * The entries are allocated from the allocator passed to the constructor.
+ * Because they all share the lifetime of the index, a 'Genode::Arena' is
+ * the natural choice. The XML data must stay unmodified while the index
+ * exists.
+ */
+class Genode::Xml_index : Noncopyable
+{
+	public:
+
+		typedef Xml_node::Invalid_syntax Invalid_syntax;
+
+	private:
+
+		typedef Xml_node::Token   Token;
+		typedef Xml_node::Tag     Tag;
+		typedef Xml_node::Comment Comment;
+
+		typedef Xml_index_entry Entry;
+
+		Allocator &_alloc;
+
+		char const  * const _addr;
+		size_t        const _max_len;
+		char const  * const _limit;  /* end of XML data */
+
+		Entry  *_first     = nullptr;  /* entries in document order */
+		Entry  *_last      = nullptr;
+		size_t  _num_nodes = 0;
+
+		static char const *_end_of_data(char const *addr, size_t max_len)
+		{
+			/* the default 'max_len' denotes unlimited data */
+			addr_t const limit = (addr_t)addr + max_len;
+			return limit < (addr_t)addr ? (char const *)~0UL : (char const *)limit;
+		}
+
+		Entry &_create(Tag const &tag, Entry *parent)
+		{
+			char const * const start = tag.token().start();
+
+			Entry &entry = *new (_alloc) Entry { };
+
+			entry.start    = start;
+			entry.end      = start;
+			entry.max_len  = _limit - start;
+			entry.name_len = tag.name().len();
+			entry.parent   = parent;
+
+			/* append to document order */
+			if (_last) _last->next_in_order = &entry;
+			else       _first = &entry;
+			_last = &entry;
+			_num_nodes++;
+
+			if (parent) {
+				if (parent->last_sub_node) parent->last_sub_node->next = &entry;
+				else                       parent->first_sub_node = &entry;
+				parent->last_sub_node = &entry;
+				parent->num_sub_nodes++;
+			}
+
+			/* the attributes were validated by the 'Tag' constructor */
+			Entry::Attribute **link = &entry.first_attribute;
+			for (Token t = tag.name().next(); t.eat_whitespace().type() == Token::IDENT; ) {
+				Xml_attribute const a(t);
+
+				Entry::Attribute &attr = *new (_alloc) Entry::Attribute { };
+				attr.name     = a._name.start();
+				attr.name_len = a._name.len();
+				*link = &attr;
+				link  = &attr.next;
+
+				t = a._next();
+			}
+
+			return entry;
+		}
+
+		/**
+		 * Record all nodes in a single pass over the tokens
+		 *
+		 * The tokens are processed in the same way as done by
+		 * 'Xml_node::_init_end_tag'.
+		 */
+		void _build()
+		{
+			Tag const top_tag(Xml_node::skip_non_tag_characters(Token(_addr, _max_len)));
+			if (!top_tag.node())
+				throw Invalid_syntax();
+
+			Entry *curr = &_create(top_tag, nullptr);
+			if (top_tag.type() == Tag::EMPTY)
+				return;
+
+			Token t = top_tag.next_token();
+			while (t.type() != Token::END) {
+
+				/* eat XML comment */
+				Comment const comment(t);
+				if (comment.valid()) {
+					t = comment.next_token();
+					continue;
+				}
+
+				/* skip all tokens that are no tags */
+				Tag const tag(t);
+				if (tag.type() == Tag::INVALID) {
+					t = t.next();
+					continue;
+				}
+
+				if (tag.node()) {
+					Entry &entry = _create(tag, curr);
+					if (tag.type() == Tag::START)
+						curr = &entry;
+				} else {
+
+					/* end tag must correspond to the start tag */
+					Token const name = tag.name();
+					if (name.len() != curr->name_len
+					 || strcmp(name.start(), curr->start + 1, name.len()))
+						throw Invalid_syntax();
+
+					curr->end = tag.token().start();
+					curr = curr->parent;
+
+					/* reached the end of the top-level node */
+					if (!curr)
+						return;
+				}
+
+				t = tag.next_token();
+			}
+
+			/* top-level node lacks its end tag */
+			throw Invalid_syntax();
+		}
+
+		void _destroy_entries()
+		{
+			for (Entry *e = _first, *next = nullptr; e; e = next) {
+				next = e->next_in_order;
+
+				for (Entry::Attribute *a = e->first_attribute, *n = nullptr; a; a = n) {
+					n = a->next;
+					destroy(_alloc, a);
+				}
+				destroy(_alloc, e);
+			}
+			_first = _last = nullptr;
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param alloc    allocator of the index entries
+		 * \param addr     begin of XML data
+		 * \param max_len  length of XML data in characters
+		 *
+		 * \throw Invalid_syntax
+		 * \throw Out_of_ram
+		 * \throw Out_of_caps
+		 */
+		Xml_index(Allocator &alloc, char const *addr, size_t max_len = ~0UL)
+		:
+			_alloc(alloc), _addr(addr), _max_len(max_len),
+			_limit(_end_of_data(addr, max_len))
+		{
+			try { _build(); }
+			catch (...) {
+				_destroy_entries();
+				throw;
+			}
+		}
+
+		~Xml_index() { _destroy_entries(); }
+
+		/**
+		 * Return top-level node of the document
+		 */
+		Xml_node xml() const { return Xml_node(*_first, _addr, _max_len); }
+
+		/**
+		 * Return number of indexed nodes
+		 */
+		size_t num_nodes() const { return _num_nodes; }
+};
+
+#endif /* _INCLUDE__UTIL__XML_INDEX_H_ */
@@ -20,9 +20,50 @@
 namespace Genode {
 	class Xml_attribute;
 	class Xml_node;
+	class Xml_index;
+	struct Xml_index_entry;
 }
 
 
+/**
+ * Node of a pre-indexed XML document
+ *
+ * The entries are created by 'Xml_index' and refer to the unmodified XML
+ * data. An 'Xml_node' that is backed by an entry navigates along the
+ * entries instead of scanning its content.
+ */
+struct Genode::Xml_index_entry
+{
+	struct Attribute
+	{
+		char const *name;      /* first character of attribute name */
+		size_t      name_len;
+		Attribute  *next;
+
+		bool has_type(char const *type) const {
+			return strlen(type) == name_len && strcmp(type, name, name_len) == 0; }
+	};
+
+	char const *start;          /* '<' of the start tag                    */
+	char const *end;            /* '<' of the end tag, 'start' if empty    */
+	size_t      max_len;        /* length of XML data following 'start'    */
+	size_t      name_len;
+	unsigned    num_sub_nodes;
+
+	Xml_index_entry *parent;
+	Xml_index_entry *first_sub_node;
+	Xml_index_entry *next;           /* next sibling                     */
+	Xml_index_entry *last_sub_node;  /* used while building the index    */
+	Xml_index_entry *next_in_order;  /* next entry in document order     */
+	Attribute       *first_attribute;
+
+	bool empty() const { return end == start; }
+
+	bool has_type(char const *type) const {
+		return strlen(type) == name_len && strcmp(type, start + 1, name_len) == 0; }
+};
+
+
 /**
  * Representation of an XML-node attribute
  *
@@ -49,6 +90,7 @@ class Genode::Xml_attribute
 		Token _value;
 
 		friend class Xml_node;
+		friend class Xml_index;
 
 		/*
 		 * Even though 'Tag' is part of 'Xml_node', the friendship
@@ -260,13 +302,16 @@ class Genode::Xml_node
 					if (_name.type() != Token::IDENT)
 						return;
 
-					/* skip attributes to find tag delimiter */
+					/*
+					 * Skip attributes to find tag delimiter. The end of the
+					 * attribute sequence is detected up front instead of
+					 * catching 'Nonexistent_attribute', whose cost would
+					 * otherwise dominate the scanning of large documents.
+					 */
 					Token delimiter = _name.next();
 					if (supposed_type != END)
-						try {
-							for (Xml_attribute a = _name.next(); ; a = a._next())
-								delimiter = a._next();
-						} catch (Nonexistent_attribute) { }
+						for (Token t = delimiter; t.eat_whitespace().type() == Token::IDENT; )
+							delimiter = t = Xml_attribute(t)._next();
 
 					delimiter = delimiter.eat_whitespace();
 
@@ -291,6 +336,12 @@ class Genode::Xml_node
 					_type  = supposed_type;
 				}
 
+				/**
+				 * Constructor used for tags that are known to be valid
+				 */
+				Tag(Token token, Token name, Type type)
+				: _token(token), _name(name), _type(type) { }
+
 				/**
 				 * Default constructor produces invalid Tag
 				 */
@@ -449,6 +500,11 @@ class Genode::Xml_node
 		Tag         _start_tag;
 		Tag         _end_tag;
 
+		/* index entry of the node, or nullptr if the node is not indexed */
+		Xml_index_entry const *_entry = nullptr;
+
+		friend class Xml_index;
+
 		/**
 		 * Search for end tag of XML node and initialize '_num_sub_nodes'
 		 *
@@ -565,6 +621,85 @@ class Genode::Xml_node
 			return Xml_node(at, _max_len - (at - addr()));
 		}
 
+		static Tag _end_tag_of(Xml_index_entry const &entry)
+		{
+			size_t const offset = entry.end - entry.start;
+			size_t const max_len = entry.max_len - offset;
+
+			return Tag(Token(entry.end, max_len),
+			           Token(entry.end + 2, max_len - 2), Tag::END);
+		}
+
+		/**
+		 * Constructor of an indexed node
+		 *
+		 * \param addr     begin of node, may precede the start tag
+		 * \param max_len  length of XML data following 'addr'
+		 *
+		 * In contrast to the public constructor, the tags are taken from
+		 * the index entry without searching the content.
+		 */
+		Xml_node(Xml_index_entry const &entry, char const *addr, size_t max_len)
+		:
+			_addr(addr),
+			_max_len(max_len),
+			_num_sub_nodes(entry.num_sub_nodes),
+			_start_tag(Token(entry.start, entry.max_len),
+			           Token(entry.start + 1, entry.max_len - 1),
+			           entry.empty() ? Tag::EMPTY : Tag::START),
+			_end_tag(entry.empty() ? _start_tag : _end_tag_of(entry)),
+			_entry(&entry)
+		{ }
+
+		Xml_node(Xml_index_entry const &entry)
+		: Xml_node(entry, entry.start, entry.max_len) { }
+
+		/**
+		 * Return indexed sub node
+		 *
+		 * Like a sub node obtained by scanning, the first sub node begins
+		 * right after the start tag of its parent.
+		 */
+		Xml_node _indexed_sub_node(Xml_index_entry const &entry) const
+		{
+			if (&entry != _entry->first_sub_node)
+				return Xml_node(entry);
+
+			char const * const at = content_addr();
+			return Xml_node(entry, at, _max_len - (at - addr()));
+		}
+
+		/**
+		 * Look up indexed sub node or attribute of specified type
+		 *
+		 * \return  entry, or nullptr if no such entry exists
+		 *
+		 * In contrast to the public accessors, the lookup does not throw
+		 * an exception for absent nodes or attributes, which keeps the
+		 * probing for optional nodes and attributes cheap.
+		 */
+		Xml_index_entry const *_indexed_sub_node(char const *type) const
+		{
+			for (Xml_index_entry const *e = _entry->first_sub_node; e; e = e->next)
+				if (e->has_type(type))
+					return e;
+			return nullptr;
+		}
+
+		Xml_index_entry::Attribute const *_indexed_attribute(char const *type) const
+		{
+			for (Xml_index_entry::Attribute const *a = _entry->first_attribute; a; a = a->next)
+				if (a->has_type(type))
+					return a;
+			return nullptr;
+		}
+
+		/**
+		 * Return attribute of indexed node
+		 */
+		Xml_attribute _attribute(Xml_index_entry::Attribute const &a) const {
+			return Xml_attribute(Token(a.name, _max_len - (a.name - _addr))); }
+
 	public:
 
 		/**
@@ -720,6 +855,14 @@ class Genode::Xml_node
 		 */
 		Xml_node next() const
 		{
+			/* the top-level node of an index has no indexed siblings */
+			if (_entry && _entry->parent) {
+				if (!_entry->next)
+					throw Nonexistent_sub_node();
+
+				return Xml_node(*_entry->next);
+			}
+
 			Token after_node = _end_tag.next_token();
 			after_node = skip_non_tag_characters(after_node);
 			try { return _sub_node(after_node.start()); }
@@ -765,6 +908,14 @@ class Genode::Xml_node
 		 */
 		Xml_node sub_node(unsigned idx = 0U) const
 		{
+			if (_entry) {
+				for (Xml_index_entry const *e = _entry->first_sub_node; e; e = e->next)
+					if (idx-- == 0)
+						return _indexed_sub_node(*e);
+
+				throw Nonexistent_sub_node();
+			}
+
 			if (_num_sub_nodes > 0) {
 
 				/* look up node at specified index */
@@ -786,6 +937,13 @@ class Genode::Xml_node
 		 */
 		Xml_node sub_node(const char *type) const
 		{
+			if (_entry) {
+				if (Xml_index_entry const *e = _indexed_sub_node(type))
+					return _indexed_sub_node(*e);
+
+				throw Nonexistent_sub_node();
+			}
+
 			if (_num_sub_nodes > 0) {
 
 				/* search for sub node of specified type */
@@ -806,6 +964,17 @@ class Genode::Xml_node
 		template <typename FN>
 		void for_each_sub_node(char const *type, FN const &fn) const
 		{
+			if (_entry) {
+				for (Xml_index_entry const *e = _entry->first_sub_node; e; e = e->next) {
+					if (type && !e->has_type(type))
+						continue;
+
+					Xml_node node = _indexed_sub_node(*e);
+					fn(node);
+				}
+				return;
+			}
+
 			if (_num_sub_nodes == 0)
 				return;
 
@@ -839,6 +1008,14 @@ class Genode::Xml_node
 		 */
 		Xml_attribute attribute(unsigned idx) const
 		{
+			if (_entry) {
+				for (Xml_index_entry::Attribute const *a = _entry->first_attribute; a; a = a->next)
+					if (idx-- == 0)
+						return _attribute(*a);
+
+				throw Nonexistent_attribute();
+			}
+
 			/* get first attribute of the node */
 			Xml_attribute a = _start_tag.attribute();
 
@@ -858,6 +1035,13 @@ class Genode::Xml_node
 		 */
 		Xml_attribute attribute(const char *type) const
 		{
+			if (_entry) {
+				if (Xml_index_entry::Attribute const *a = _indexed_attribute(type))
+					return _attribute(*a);
+
+				throw Nonexistent_attribute();
+			}
+
 			/* iterate, beginning with the first attribute of the node */
 			for (Xml_attribute a = _start_tag.attribute(); ; a = a.next())
 				if (a.has_type(type))
@@ -885,6 +1069,13 @@ class Genode::Xml_node
 		inline T attribute_value(char const *type, T default_value) const
 		{
 			T result = default_value;
+
+			if (_entry) {
+				if (Xml_index_entry::Attribute const *a = _indexed_attribute(type))
+					try { _attribute(*a).value(&result); } catch (...) { }
+				return result;
+			}
+
 			try { attribute(type).value(&result); } catch (...) { }
 			return result;
 		}
@@ -894,6 +1085,9 @@ class Genode::Xml_node
 		 */
 		inline bool has_attribute(char const *type) const
 		{
+			if (_entry)
+				return _indexed_attribute(type) != nullptr;
+
 			try { attribute(type); return true; } catch (...) { }
 			return false;
 		}
@@ -903,6 +1097,9 @@ class Genode::Xml_node
 		 */
 		inline bool has_sub_node(char const *type) const
 		{
+			if (_entry)
+				return _indexed_sub_node(type) != nullptr;
+
 			try { sub_node(type); return true; } catch (...) { }
 			return false;
 		}
@@ -0,0 +1,135 @@
+/*
+ * \brief  Bump-pointer allocator for short-lived objects
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <util/construct_at.h>
+#include <base/arena.h>
+#include <base/log.h>
+
+using namespace Genode;
+
+
+Arena::Arena(Ram_allocator &ram, Region_map &rm, size_t chunk_size)
+:
+	_ram(ram), _rm(rm), _chunk_size(chunk_size)
+{ }
+
+
+Arena::~Arena()
+{
+	while (Chunk *chunk = _first) {
+		_first = chunk->next;
+		_free_chunk(*chunk);
+	}
+}
+
+
+void Arena::_free_chunk(Chunk &chunk)
+{
+	Ram_dataspace_capability const ds = chunk.ds;
+
+	_consumed -= chunk.size;
+	chunk.~Chunk();
+	_rm.detach(&chunk);
+	_ram.free(ds);
+}
+
+
+bool Arena::_advance(size_t size)
+{
+	Chunk *&next = _curr ? _curr->next : _first;
+
+	/*
+	 * Reuse a retained chunk that is large enough. All chunks behind the
+	 * current one are unused, so the chunk can be moved to the front of them.
+	 */
+	for (Chunk **link = &next; *link; link = &(*link)->next) {
+
+		Chunk &chunk = **link;
+		if (chunk.base() + size > chunk.end())
+			continue;
+
+		*link      = chunk.next;
+		chunk.next = next;
+		next       = &chunk;
+		_curr      = &chunk;
+		_top       = chunk.base();
+		return true;
+	}
+	/* allocate a new chunk and put it in front of the retained ones */
+	size_t const chunk_size =
+		align_addr(max(_chunk_size, size + Chunk::header_size()), 12);
+
+	Ram_dataspace_capability ds;
+	Chunk *chunk = nullptr;
+	try {
+		ds    = _ram.alloc(chunk_size);
+		chunk = _rm.attach(ds);
+	}
+	catch (Region_map::Region_conflict) {
+		error("arena: region conflict while attaching dataspace");
+		_ram.free(ds);
+		return false;
+	}
+	catch (Region_map::Invalid_dataspace) {
+		error("arena: attempt to attach invalid dataspace");
+		_ram.free(ds);
+		return false;
+	}
+	catch (Out_of_ram) {
+		if (ds.valid())
+			_ram.free(ds);
+		return false;
+	}
+	catch (Out_of_caps) {
+		if (ds.valid())
+			_ram.free(ds);
+		return false;
+	}
+	construct_at<Chunk>(chunk, ds, chunk_size);
+
+	chunk->next = next;
+	next        = chunk;
+	_consumed  += chunk_size;
+	_curr       = chunk;
+	_top        = chunk->base();
+	return true;
+}
+
+
+Arena::Mark Arena::mark() const
+{
+	Mark mark;
+	mark._chunk = _curr;
+	mark._top   = _top;
+	mark._used  = _used;
+	return mark;
+}
+
+
+void Arena::reset(Mark const &mark)
+{
+	_curr = mark._chunk;
+	_top  = mark._top;
+	_used = mark._used;
+}
+
+
+void Arena::trim()
+{
+	Chunk *&unused = _curr ? _curr->next : _first;
+
+	while (Chunk *chunk = unused) {
+		unused = chunk->next;
+		_free_chunk(*chunk);
+	}
+}
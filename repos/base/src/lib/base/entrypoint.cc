@@ -329,3 +329,25 @@ Entrypoint::Entrypoint(Env &env, size_t stack_size, char const *name)
 	_signal_proxy_thread.construct(env, *this);
 }
 
+
+Entrypoint::Signal_proxy_thread::Signal_proxy_thread(Env                &env,
+                                                     Entrypoint         &ep,
+                                                     Affinity::Location  location)
+:
+	Thread(env, "signal_proxy", STACK_SIZE, location, Weight(), env.cpu()),
+	ep(ep)
+{
+	start();
+}
+
+
+Entrypoint::Entrypoint(Env &env, size_t stack_size, char const *name,
+                       Affinity::Location location)
+:
+	_env(env),
+	_rpc_ep(&env.pd(), stack_size, name, true, location),
+	_signalling_initialized(true)
+{
+	_signal_proxy_thread.construct(env, *this, location);
+}
+
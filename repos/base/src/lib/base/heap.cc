@@ -12,6 +12,7 @@
  */
 
 #include <util/construct_at.h>
+#include <util/string.h>
 #include <base/env.h>
 #include <base/log.h>
 #include <base/heap.h>
@@ -133,13 +134,9 @@ Heap::Dataspace *Heap::_allocate_dataspace(size_t size, bool enforce_separate_me
 }
 
 
-bool Heap::_try_local_alloc(size_t size, void **out_addr)
+bool Heap::_try_local_alloc(size_t size, void **out_addr, unsigned align_log2)
 {
-	if (_alloc->alloc_aligned(size, out_addr, log2(16)).error())
-		return false;
-
-	_quota_used += size;
-	return true;
+	return _alloc->alloc_aligned(size, out_addr, align_log2).ok();
 }
 
 
@@ -173,17 +170,31 @@ bool Heap::_unsynchronized_alloc(size_t size, void **out_addr)
 		return true;
 	}
 
+	if (!_unsynchronized_local_alloc(size, out_addr, log2(16)))
+		return false;
+
+	_quota_used += size;
+	return true;
+}
+
+
+bool Heap::_unsynchronized_local_alloc(size_t size, void **out_addr,
+                                       unsigned align_log2)
+{
 	/* try allocation at our local allocator */
-	if (_try_local_alloc(size, out_addr))
+	if (_try_local_alloc(size, out_addr, align_log2))
 		return true;
 
 	/*
 	 * Calculate block size of needed backing store. The block must hold the
 	 * requested 'size' and we add some space for meta data
-	 * ('Dataspace' structures, AVL-node slab blocks).
+	 * ('Dataspace' structures, AVL-node slab blocks) and for aligning the
+	 * block beyond the natural alignment of 16 bytes.
 	 * Finally, we align the size to a 4K page.
 	 */
-	dataspace_size = size + Allocator_avl::slab_block_size() + sizeof(Heap::Dataspace);
+	size_t dataspace_size = size + Allocator_avl::slab_block_size()
+	                      + sizeof(Heap::Dataspace)
+	                      + (1UL << align_log2) - 16;
 
 	/*
 	 * '_chunk_size' is a multiple of 4K, so 'dataspace_size' becomes
@@ -209,7 +220,190 @@ bool Heap::_unsynchronized_alloc(size_t size, void **out_addr)
 	}
 
 	/* allocate originally requested block */
-	return _try_local_alloc(size, out_addr);
+	return _try_local_alloc(size, out_addr, align_log2);
+}
+
+
+/**
+ * Header at the beginning of a slab page
+ *
+ * The remainder of the page is divided into slots of the size of the page's
+ * size class. Slots that were never allocated are taken from 'top', released
+ * slots are kept in the 'free_slots' list.
+ */
+struct Heap::Small_page
+{
+	unsigned    const cls;
+	unsigned    const capacity;        /* number of slots                   */
+	unsigned    used       = 0;
+	addr_t      top;                   /* first slot that was never used    */
+	void       *free_slots = nullptr;
+	Small_page *prev       = nullptr;  /* list of pages with free slots     */
+	Small_page *next       = nullptr;
+
+	enum { HEADER_SIZE = 64 };
+
+	Small_page(unsigned cls, size_t slot_size)
+	:
+		cls(cls),
+		capacity((SMALL_PAGE_SIZE - HEADER_SIZE) / slot_size),
+		top((addr_t)this + HEADER_SIZE)
+	{
+		static_assert(sizeof(Small_page) <= HEADER_SIZE,
+		              "slab-page header exceeds its reserved space");
+	}
+};
+
+
+unsigned Heap::_small_class(size_t size)
+{
+	/* 16-byte steps up to 128 bytes, four classes per power of two beyond */
+	if (size <= 128)
+		return size ? (unsigned)((size - 1) >> 4) : 0;
+
+	unsigned const msb = log2(size - 1);
+	return 8 + (msb - 7)*4 + (unsigned)(((size - 1) - (1UL << msb)) >> (msb - 2));
+}
+
+
+size_t Heap::_small_class_size(unsigned cls)
+{
+	if (cls < 8)
+		return (cls + 1)*16;
+
+	unsigned const msb = 7 + (cls - 8)/4;
+	return (1UL << msb) + ((cls - 8)%4 + 1)*(1UL << (msb - 2));
+}
+
+
+unsigned Heap::_small_page_pos(addr_t base) const
+{
+	/* binary search within the registry, which is sorted by address */
+	unsigned lo = 0, hi = _small_pages_num;
+	while (lo < hi) {
+		unsigned const mid = lo + (hi - lo)/2;
+		if ((addr_t)_small_pages[mid] < base)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+
+Heap::Small_page *Heap::_small_page(void const *addr) const
+{
+	/*
+	 * The address is looked up in '_small_pages' before any page header is
+	 * touched. So arbitrary pointers, e.g., nullptr or blocks of another
+	 * allocator, never cause a memory access.
+	 */
+	addr_t   const base = (addr_t)addr & ~(SMALL_PAGE_SIZE - 1UL);
+	unsigned const pos  = _small_page_pos(base);
+
+	return pos < _small_pages_num && (addr_t)_small_pages[pos] == base
+	       ? _small_pages[pos] : nullptr;
+}
+
+
+Heap::Small_page *Heap::_new_small_page(unsigned cls)
+{
+	/* grow page registry if needed */
+	if (_small_pages_num == _small_pages_max) {
+
+		unsigned const max = _small_pages_max ? 2*_small_pages_max : 64;
+
+		void *pages = nullptr;
+		if (!_unsynchronized_local_alloc(max*sizeof(Small_page *), &pages, log2(16)))
+			return nullptr;
+
+		if (_small_pages) {
+			memcpy(pages, _small_pages, _small_pages_num*sizeof(Small_page *));
+			_alloc->free(_small_pages);
+		}
+		_small_pages     = (Small_page **)pages;
+		_small_pages_max = max;
+	}
+
+	void *addr = nullptr;
+	if (!_unsynchronized_local_alloc(SMALL_PAGE_SIZE, &addr, SMALL_PAGE_SIZE_LOG2))
+		return nullptr;
+
+	Small_page *page = construct_at<Small_page>(addr, cls, _small_class_size(cls));
+
+	/* insert page into the registry in address order */
+	unsigned const pos = _small_page_pos((addr_t)page);
+	memmove(&_small_pages[pos + 1], &_small_pages[pos],
+	        (_small_pages_num - pos)*sizeof(Small_page *));
+	_small_pages[pos] = page;
+	_small_pages_num++;
+
+	_small_avail[cls] = page;
+	return page;
+}
+
+
+void Heap::_release_small_page(Small_page &page)
+{
+	/* remove page from list of pages with free slots */
+	if (page.prev)                           page.prev->next = page.next;
+	else if (_small_avail[page.cls] == &page) _small_avail[page.cls] = page.next;
+	if (page.next)                           page.next->prev = page.prev;
+
+	/* remove page from the registry, keeping the address order */
+	unsigned const pos = _small_page_pos((addr_t)&page);
+	_small_pages_num--;
+	memmove(&_small_pages[pos], &_small_pages[pos + 1],
+	        (_small_pages_num - pos)*sizeof(Small_page *));
+
+	page.~Small_page();
+	_alloc->free(&page);
+}
+
+
+bool Heap::_small_alloc(unsigned cls, void **out_addr)
+{
+	Small_page *page = _small_avail[cls];
+	if (!page) {
+		page = _new_small_page(cls);
+		if (!page)
+			return false;
+	}
+
+	if (page->free_slots) {
+		*out_addr        = page->free_slots;
+		page->free_slots = *(void **)page->free_slots;
+	} else {
+		*out_addr  = (void *)page->top;
+		page->top += _small_class_size(cls);
+	}
+
+	/* remove full page from list of pages with free slots */
+	if (++page->used == page->capacity) {
+		_small_avail[cls] = page->next;
+		if (page->next) page->next->prev = nullptr;
+		page->next = nullptr;
+	}
+	return true;
+}
+
+
+void Heap::_small_free(Small_page &page, void *addr)
+{
+	/* insert formerly full page into list of pages with free slots */
+	if (page.used == page.capacity) {
+		page.prev = nullptr;
+		page.next = _small_avail[page.cls];
+		if (page.next) page.next->prev = &page;
+		_small_avail[page.cls] = &page;
+	}
+
+	*(void **)addr  = page.free_slots;
+	page.free_slots = addr;
+
+	/* release empty page unless it is the last one of its size class */
+	if (--page.used == 0 && (page.prev || page.next))
+		_release_small_page(page);
 }
 
 
@@ -218,6 +412,22 @@ bool Heap::alloc(size_t size, void **out_addr)
 	/* serialize access of heap functions */
 	Lock::Guard lock_guard(_lock);
 
+	/* serve small blocks from the slab page of their size class */
+	if (size <= SMALL_MAX_SIZE) {
+
+		unsigned const cls        = _small_class(size);
+		size_t   const class_size = _small_class_size(cls);
+
+		if (class_size + _quota_used > _quota_limit)
+			return false;
+
+		if (!_small_alloc(cls, out_addr))
+			return false;
+
+		_quota_used += class_size;
+		return true;
+	}
+
 	/* check requested allocation against quota limit */
 	if (size + _quota_used > _quota_limit)
 		return false;
@@ -231,6 +441,12 @@ void Heap::free(void *addr, size_t)
 	/* serialize access of heap functions */
 	Lock::Guard lock_guard(_lock);
 
+	if (Small_page *page = _small_page(addr)) {
+		_quota_used -= _small_class_size(page->cls);
+		_small_free(*page, addr);
+		return;
+	}
+
 	/* try to find the size in our local allocator */
 	size_t const size = _alloc->size_at(addr);
 
@@ -258,10 +474,11 @@ void Heap::free(void *addr, size_t)
 		return;
 	}
 
+	/* account the dataspace and its meta data allocated by '_allocate_dataspace' */
+	_quota_used -= ds->size + sizeof(Heap::Dataspace);
+
 	_ds_pool.remove_and_free(*ds);
 	_alloc->free(ds);
-
-	_quota_used -= ds->size;
 }
 
 
@@ -281,8 +498,37 @@ Heap::Heap(Ram_allocator *ram_alloc,
 }
 
 
+size_t Heap::overhead(size_t size) const
+{
+	if (size > SMALL_MAX_SIZE)
+		return _alloc->overhead(size);
+
+	/* share of the slab page beyond the requested size */
+	size_t const class_size = _small_class_size(_small_class(size));
+	size_t const capacity   = (SMALL_PAGE_SIZE - Small_page::HEADER_SIZE)
+	                        / class_size;
+
+	return SMALL_PAGE_SIZE/capacity - size;
+}
+
+
 Heap::~Heap()
 {
+	/* release slab pages, which are blocks of the local allocator */
+	size_t dangling_small_blocks = 0;
+	while (_small_pages_num) {
+		Small_page &page = *_small_pages[_small_pages_num - 1];
+		dangling_small_blocks += page.used;
+		_release_small_page(page);
+	}
+	if (_small_pages)
+		_alloc->free(_small_pages);
+
+	if (dangling_small_blocks)
+		warning(dangling_small_blocks, " dangling small allocation",
+		        (dangling_small_blocks > 1) ? "s" : "",
+		        " at heap destruction time");
+
 	/*
 	 * Revert allocations of heap-internal 'Dataspace' objects. Otherwise, the
 	 * subsequent destruction of the 'Allocator_avl' would detect those blocks
@@ -0,0 +1,143 @@
+/*
+ * \brief  Arena allocator test
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * Besides validating the arena, the test compares the costs of allocating
+ * and releasing many small short-lived objects via the arena with the heap.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/arena.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+
+using Genode::size_t;
+using Genode::log;
+using Genode::error;
+
+
+struct Test_failed { };
+
+
+static void check(bool condition, char const *what)
+{
+	if (condition)
+		return;
+
+	error("arena test failed: ", what);
+	throw Test_failed();
+}
+
+
+/**
+ * Allocate 'num' blocks of sizes between 16 and 271 bytes
+ */
+static void **alloc_blocks(Genode::Allocator &alloc, void **blocks, unsigned num)
+{
+	for (unsigned i = 0; i < num; i++)
+		blocks[i] = alloc.alloc(16 + (i*37) % 256);
+
+	return blocks;
+}
+
+
+static void test_semantics(Genode::Env &env)
+{
+	log("test semantics");
+
+	Genode::Arena      arena(env.ram(), env.rm(), 4096);
+	Genode::Allocator &alloc = arena;
+
+	/* allocations are aligned and do not overlap */
+	char *a = (char *)alloc.alloc(3);
+	char *b = (char *)alloc.alloc(100);
+	check(((Genode::addr_t)a & 15) == 0 && ((Genode::addr_t)b & 15) == 0,
+	      "alignment");
+	check(b >= a + 3, "overlap");
+
+	/* nested scopes release their blocks only */
+	size_t const outer = arena.used();
+	{
+		Genode::Arena::Scope scope(arena);
+		alloc.alloc(1000);
+		{
+			Genode::Arena::Scope inner(arena);
+			alloc.alloc(5000);
+			check(arena.used() >= outer + 6000, "used bytes");
+		}
+		check(arena.used() == outer + 1008, "inner reset");
+	}
+	check(arena.used() == outer, "outer reset");
+	check(arena.high_water_mark() >= outer + 6000, "high-water mark");
+
+	/* chunks are retained on reset and released by trim */
+	size_t const consumed = arena.consumed();
+	arena.reset();
+	check(arena.used() == 0, "reset");
+	check(arena.consumed() == consumed, "retained chunks");
+	alloc.alloc(5000);
+	check(arena.consumed() == consumed, "chunk reuse");
+	arena.reset();
+	arena.trim();
+	check(arena.consumed() == 0, "trim");
+}
+
+
+static void test_performance(Genode::Env &env, Timer::Connection &timer)
+{
+	enum { ROUNDS = 1000, BLOCKS = 1000 };
+
+	log("benchmark ", (unsigned)ROUNDS, " rounds of ", (unsigned)BLOCKS,
+	    " short-lived blocks");
+
+	Genode::Heap  heap(env.ram(), env.rm());
+	Genode::Arena arena(env.ram(), env.rm());
+
+	static void *blocks[BLOCKS];
+
+	unsigned long start = timer.elapsed_ms();
+	for (unsigned r = 0; r < ROUNDS; r++) {
+		alloc_blocks(heap, blocks, BLOCKS);
+		for (unsigned i = 0; i < BLOCKS; i++)
+			heap.free(blocks[i], 16 + (i*37) % 256);
+	}
+	unsigned long const heap_ms = timer.elapsed_ms() - start;
+
+	start = timer.elapsed_ms();
+	for (unsigned r = 0; r < ROUNDS; r++) {
+		Genode::Arena::Scope scope(arena);
+		alloc_blocks(arena, blocks, BLOCKS);
+	}
+	unsigned long const arena_ms = timer.elapsed_ms() - start;
+
+	log(" heap:  ", heap_ms,  " ms");
+	log(" arena: ", arena_ms, " ms (high-water mark: ",
+	    arena.high_water_mark(), " bytes, consumed: ", arena.consumed(),
+	    " bytes)");
+}
+
+
+void Component::construct(Genode::Env &env)
+{
+	log("--- arena test ---");
+
+	static Timer::Connection timer(env);
+
+	try {
+		test_semantics(env);
+		test_performance(env, timer);
+	}
+	catch (Test_failed) { return; }
+
+	log("Test done");
+}
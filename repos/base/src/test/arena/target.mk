@@ -0,0 +1,3 @@
+TARGET = test-arena
+SRC_CC = main.cc
+LIBS   = base
@@ -2,6 +2,9 @@
  * \brief  Slab allocator test
  * \author Norman Feske
  * \date   2015-03-31
+ *
+ * Besides the slab allocator, the test benchmarks the heap, which serves
+ * small blocks from slab pages of different size classes.
  */
 
 /*
@@ -62,6 +65,83 @@ struct Array_of_slab_elements
 };
 
 
+/**
+ * Measure allocation throughput of the heap for a given block size
+ *
+ * Each round allocates 'num_elem' blocks and frees them in reverse order.
+ */
+static void heap_throughput(Genode::Allocator &heap, Timer::Connection &timer,
+                            size_t block_size)
+{
+	enum { ROUNDS = 100, NUM_ELEM = 10000 };
+
+	static void *elem[NUM_ELEM];
+
+	unsigned long const start_ms = timer.elapsed_ms();
+	for (unsigned r = 0; r < ROUNDS; r++) {
+		for (unsigned i = 0; i < NUM_ELEM; i++)
+			elem[i] = heap.alloc(block_size);
+		for (unsigned i = NUM_ELEM; i > 0; i--)
+			heap.free(elem[i - 1], block_size);
+	}
+	unsigned long const duration_ms = timer.elapsed_ms() - start_ms;
+
+	log(" block size ", block_size, ": ", (unsigned)(ROUNDS*NUM_ELEM), " "
+	    "allocations in ", duration_ms, " ms");
+}
+
+
+/**
+ * Measure the backing store used by the heap for a fragmented block set
+ *
+ * Blocks of pseudo-random sizes are allocated, and every other block is
+ * released afterwards. The RAM consumed by the component is compared with
+ * the bytes that are still allocated from the heap.
+ *
+ * \return  false if the heap still accounts memory after all blocks were
+ *          freed
+ */
+static bool heap_fragmentation(Genode::Env &env, Timer::Connection &timer,
+                               size_t max_size)
+{
+	enum { NUM_ELEM = 10000 };
+
+	static void  *elem[NUM_ELEM];
+	static size_t elem_size[NUM_ELEM];
+
+	size_t const ram_before = env.ram().used_ram().value;
+	{
+		Genode::Heap       heap(env.ram(), env.rm());
+		Genode::Allocator &alloc = heap;
+
+		unsigned long const start_ms = timer.elapsed_ms();
+		unsigned seed = 1;
+		for (unsigned i = 0; i < NUM_ELEM; i++) {
+			seed = seed*1103515245 + 12345;
+			elem_size[i] = 1 + (seed >> 8) % max_size;
+			elem[i]      = alloc.alloc(elem_size[i]);
+		}
+		for (unsigned i = 0; i < NUM_ELEM; i += 2)
+			heap.free(elem[i], elem_size[i]);
+
+		size_t const ram = env.ram().used_ram().value - ram_before;
+
+		log(" sizes up to ", max_size, ": ", heap.consumed(), " bytes "
+		    "allocated, ", ram, " bytes of RAM, ",
+		    timer.elapsed_ms() - start_ms, " ms");
+
+		for (unsigned i = 1; i < NUM_ELEM; i += 2)
+			heap.free(elem[i], elem_size[i]);
+
+		if (heap.consumed() > 0) {
+			error("heap accounts ", heap.consumed(), " bytes after freeing all blocks");
+			return false;
+		}
+	}
+	return true;
+}
+
+
 void Component::construct(Genode::Env & env)
 {
 	static Genode::Heap heap(env.ram(), env.rm());
@@ -123,5 +203,19 @@ void Component::construct(Genode::Env & env)
 		}
 	}
 
+	log("heap throughput");
+	{
+		Genode::Heap heap(env.ram(), env.rm());
+
+		size_t const sizes[] = { 16, 64, 256, 1024, 4096 };
+		for (size_t size : sizes)
+			heap_throughput(heap, timer, size);
+	}
+
+	log("heap fragmentation");
+	if (!heap_fragmentation(env, timer, 256)
+	 || !heap_fragmentation(env, timer, 4096))
+		return;
+
 	log("Test done");
 }
@@ -16,6 +16,7 @@
 
 #include <os/path.h>
 #include <util/list.h>
+#include <vfs/vfs_handle.h>
 
 #include <netdb.h>
 #include <sys/select.h>
@@ -74,6 +75,32 @@ namespace Libc {
 			 */
 			virtual void init(Genode::Env &env) { }
 
+			/**
+			 * Return true if reading from the file descriptor would not block
+			 *
+			 * The default implementation polls the 'select' function of the
+			 * plugin. File descriptors of plugins that do not support
+			 * 'select' are always ready.
+			 */
+			virtual bool read_ready(File_descriptor *);
+
+			/**
+			 * Return true if writing to the file descriptor would not block
+			 */
+			virtual bool write_ready(File_descriptor *);
+
+			/**
+			 * Deliver readiness changes of file descriptor to context
+			 *
+			 * \param context  context passed to the I/O-response handler of
+			 *                 the VFS whenever the file descriptor may have
+			 *                 become ready, or nullptr to stop the delivery
+			 *
+			 * \return false if the plugin cannot tell about readiness
+			 *         changes of the file descriptor
+			 */
+			virtual bool watch(File_descriptor *, Vfs::Vfs_handle::Context *context);
+
 			virtual File_descriptor *accept(File_descriptor *,
 			                                struct ::sockaddr *addr,
 			                                socklen_t *addrlen);
@@ -20,7 +20,19 @@
 /* libc includes */
 #include <stdlib.h>
 
-namespace Libc { struct Allocator; }
+namespace Genode { class Thread; }
+
+namespace Libc {
+
+	struct Allocator;
+
+	/**
+	 * Return the blocks cached by an exited thread to the global heap
+	 *
+	 * Called by the pthread library when a thread exits or is destroyed.
+	 */
+	void release_malloc_thread_cache(Genode::Thread const &);
+}
 
 
 struct Libc::Allocator : Genode::Allocator
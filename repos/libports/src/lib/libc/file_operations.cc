@@ -29,10 +29,12 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 /* libc-internal includes */
+#include "kqueue.h"
 #include "libc_file.h"
 #include "libc_mem_alloc.h"
 #include "libc_mmap_registry.h"
@@ -226,9 +228,11 @@ extern "C" int _close(int libc_fd)
 {
 	Libc::File_descriptor *fd =
 		Libc::file_descriptor_allocator()->find_by_libc_fd(libc_fd);
-	return (!fd || !fd->plugin)
-		? Libc::Errno(EBADF)
-		: fd->plugin->close(fd);
+	if (!fd || !fd->plugin)
+		return Libc::Errno(EBADF);
+
+	Libc::kqueue_close(fd);
+	return fd->plugin->close(fd);
 }
 
 
@@ -441,7 +445,8 @@ extern "C" void *mmap(void *addr, ::size_t length, int prot, int flags,
 	}
 
 	void *start = fd->plugin->mmap(addr, length, prot, flags, fd, offset);
-	mmap_registry()->insert(start, length, fd->plugin);
+	if (start != MAP_FAILED)
+		mmap_registry()->insert(start, length, fd->plugin);
 	return start;
 }
 
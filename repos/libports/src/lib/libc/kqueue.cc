@@ -0,0 +1,686 @@
+/*
+ * \brief  kqueue() and kevent() implementation
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * In contrast to 'select', a kqueue keeps the set of events of interest
+ * across calls. The file descriptors of interest are watched via the
+ * context of their VFS handles. So each I/O response of the VFS tells
+ * exactly which file descriptor may have become ready, and 'kevent' checks
+ * only those file descriptors instead of the whole interest set. File
+ * descriptors of plugins that cannot be watched are polled whenever a plugin
+ * reports some readiness change via 'libc_select_notify'.
+ *
+ * Only the EVFILT_READ and EVFILT_WRITE filters are supported. Because the
+ * plugins cannot tell the number of bytes available, the 'data' field of a
+ * reported event is always 1.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/lock.h>
+#include <base/log.h>
+
+/* libc includes */
+#include <libc/allocator.h>
+#include <libc-plugin/fd_alloc.h>
+#include <libc-plugin/plugin.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+
+/* libc-internal includes */
+#include "kqueue.h"
+#include "libc_errno.h"
+#include "task.h"
+
+
+namespace Libc {
+	struct Fd_watch;
+	struct Knote;
+	struct Kqueue;
+	struct Kqueue_plugin;
+}
+
+using namespace Libc;
+
+
+/**
+ * Knotes of one file descriptor
+ *
+ * The watch is the context of the VFS handle of the file descriptor. The VFS
+ * may still hold the context for a pending I/O response after the file
+ * descriptor got closed. Therefore, watches are never freed but reused.
+ */
+struct Libc::Fd_watch : Vfs::Vfs_handle::Context
+{
+	File_descriptor *fd        = nullptr;  /* nullptr if unused or closed */
+	Knote           *knotes    = nullptr;
+	bool             watched   = false;    /* plugin notifies changes */
+	Fd_watch        *next_free = nullptr;
+};
+
+
+/**
+ * Event of interest
+ */
+struct Libc::Knote
+{
+	Kqueue   &kq;
+	Fd_watch &watch;
+
+	uintptr_t const ident;
+	short     const filter;
+
+	unsigned short flags   = 0;  /* EV_ONESHOT, EV_CLEAR, EV_DISPATCH */
+	void          *udata   = nullptr;
+	bool           enabled = true;
+	bool           queued  = false;
+
+	Knote *next_of_watch = nullptr;
+	Knote *next_of_kq    = nullptr;
+	Knote *next_polled   = nullptr;
+	Knote *next_queued   = nullptr;
+
+	Knote(Kqueue &kq, Fd_watch &watch, uintptr_t ident, short filter)
+	: kq(kq), watch(watch), ident(ident), filter(filter) { }
+};
+
+
+struct Libc::Kqueue : Plugin_context
+{
+	/* serializes the 'kevent' calls of the kqueue */
+	Genode::Lock kevent_lock;
+
+	Kqueue *next = nullptr;
+
+	Knote *knotes = nullptr;
+	Knote *polled = nullptr;  /* knotes of file descriptors not watched */
+
+	/* knotes that may have become ready */
+	Knote *queue_head = nullptr;
+	Knote *queue_tail = nullptr;
+
+	/* readiness of polled knotes may have changed */
+	bool poll = false;
+
+	bool ready() const { return queue_head || (polled && poll); }
+
+	void enqueue(Knote &kn)
+	{
+		if (kn.queued)
+			return;
+
+		kn.queued      = true;
+		kn.next_queued = nullptr;
+
+		if (queue_tail) queue_tail->next_queued = &kn;
+		else            queue_head = &kn;
+		queue_tail = &kn;
+	}
+
+	Knote *dequeue()
+	{
+		Knote * const kn = queue_head;
+		if (!kn)
+			return nullptr;
+
+		queue_head = kn->next_queued;
+		if (!queue_head)
+			queue_tail = nullptr;
+
+		kn->queued = false;
+		return kn;
+	}
+
+	void unqueue(Knote &kn)
+	{
+		if (!kn.queued)
+			return;
+
+		Knote *prev = nullptr;
+		for (Knote *k = queue_head; k; prev = k, k = k->next_queued) {
+			if (k != &kn)
+				continue;
+
+			if (prev) prev->next_queued = kn.next_queued;
+			else      queue_head = kn.next_queued;
+			if (queue_tail == &kn)
+				queue_tail = prev;
+			break;
+		}
+		kn.queued = false;
+	}
+};
+
+
+/*
+ * The state of all kqueues is protected by one lock, which is never held
+ * while calling a plugin. The lock is also taken by the I/O-response handler
+ * of the libc kernel.
+ */
+static Genode::Lock &kqueue_lock()
+{
+	static Genode::Lock lock;
+	return lock;
+}
+
+typedef Genode::Lock::Guard Guard;
+
+static Libc::Allocator kqueue_alloc;
+
+static Fd_watch *watches[MAX_NUM_FDS];
+static Fd_watch *free_watches;
+static Kqueue   *kqueues;
+
+
+template <Knote *Knote::*NEXT>
+static void unlink(Knote *&head, Knote &kn)
+{
+	for (Knote **link = &head; *link; link = &((*link)->*NEXT))
+		if (*link == &kn) {
+			*link = kn.*NEXT;
+			return;
+		}
+}
+
+
+/**
+ * Remove knote
+ *
+ * Must be called with the kqueue lock held.
+ *
+ * \return watch of the knote if it has no knotes left
+ */
+static Fd_watch *remove_knote(Knote &kn)
+{
+	Kqueue   &kq    = kn.kq;
+	Fd_watch &watch = kn.watch;
+
+	unlink<&Knote::next_of_watch>(watch.knotes, kn);
+	unlink<&Knote::next_of_kq>(kq.knotes, kn);
+	unlink<&Knote::next_polled>(kq.polled, kn);
+	kq.unqueue(kn);
+
+	Genode::destroy(&kqueue_alloc, &kn);
+
+	return watch.knotes ? nullptr : &watch;
+}
+
+
+/**
+ * Return watch of file descriptor, create it if needed
+ */
+static Fd_watch &acquire_watch(File_descriptor &fd)
+{
+	Fd_watch *watch = nullptr;
+	{
+		Guard guard(kqueue_lock());
+
+		if (watches[fd.libc_fd])
+			return *watches[fd.libc_fd];
+
+		if (free_watches) {
+			watch = free_watches;
+			free_watches = watch->next_free;
+		} else {
+			watch = new (&kqueue_alloc) Fd_watch;
+		}
+
+		watch->fd = &fd;
+		watches[fd.libc_fd] = watch;
+	}
+
+	/* the plugin may block, so it must be called without the lock held */
+	bool const watched = fd.plugin->watch(&fd, watch);
+
+	Guard guard(kqueue_lock());
+	watch->watched = watched;
+	return *watch;
+}
+
+
+/**
+ * Put watch without knotes back to the free watches
+ */
+static void release_watch(Fd_watch &watch)
+{
+	File_descriptor *fd      = nullptr;
+	bool             watched = false;
+	{
+		Guard guard(kqueue_lock());
+
+		if (watch.knotes)
+			return;
+
+		fd      = watch.fd;
+		watched = watch.watched;
+
+		if (fd && watches[fd->libc_fd] == &watch)
+			watches[fd->libc_fd] = nullptr;
+
+		watch.fd      = nullptr;
+		watch.watched = false;
+	}
+
+	if (fd && watched)
+		fd->plugin->watch(fd, nullptr);
+
+	Guard guard(kqueue_lock());
+	watch.next_free = free_watches;
+	free_watches    = &watch;
+}
+
+
+static void remove_and_release(Knote &kn)
+{
+	Fd_watch *unused = nullptr;
+	{
+		Guard guard(kqueue_lock());
+		unused = remove_knote(kn);
+	}
+
+	if (unused)
+		release_watch(*unused);
+}
+
+
+/**
+ * Lookup knote
+ *
+ * Must be called with the kqueue lock held.
+ */
+static Knote *find_knote(Kqueue &kq, int libc_fd, short filter)
+{
+	Fd_watch * const watch = watches[libc_fd];
+	if (!watch)
+		return nullptr;
+
+	for (Knote *kn = watch->knotes; kn; kn = kn->next_of_watch)
+		if (&kn->kq == &kq && kn->filter == filter)
+			return kn;
+
+	return nullptr;
+}
+
+
+/**
+ * Apply change to the interest set of the kqueue
+ *
+ * \return errno value, or 0 on success
+ */
+static int apply_change(Kqueue &kq, struct kevent const &change)
+{
+	if (change.filter != EVFILT_READ && change.filter != EVFILT_WRITE)
+		return EINVAL;
+
+	if (change.ident >= MAX_NUM_FDS)
+		return EBADF;
+
+	int const libc_fd = (int)change.ident;
+
+	File_descriptor *fd = file_descriptor_allocator()->find_by_libc_fd(libc_fd);
+	if (!fd || !fd->plugin)
+		return EBADF;
+
+	Knote *kn = nullptr;
+	{
+		Guard guard(kqueue_lock());
+		kn = find_knote(kq, libc_fd, change.filter);
+	}
+
+	if (change.flags & EV_DELETE) {
+		if (!kn)
+			return ENOENT;
+
+		remove_and_release(*kn);
+		return 0;
+	}
+
+	if (!kn && (change.flags & EV_ADD)) {
+
+		Fd_watch &watch = acquire_watch(*fd);
+
+		Guard guard(kqueue_lock());
+
+		kn = new (&kqueue_alloc) Knote(kq, watch, change.ident, change.filter);
+
+		kn->next_of_watch = watch.knotes;
+		watch.knotes      = kn;
+		kn->next_of_kq    = kq.knotes;
+		kq.knotes         = kn;
+
+		if (!watch.watched) {
+			kn->next_polled = kq.polled;
+			kq.polled       = kn;
+		}
+	}
+
+	if (!kn)
+		return ENOENT;
+
+	Guard guard(kqueue_lock());
+
+	if (change.flags & EV_ADD) {
+		kn->flags = change.flags & (EV_ONESHOT | EV_CLEAR | EV_DISPATCH);
+		kn->udata = change.udata;
+	}
+
+	if (change.flags & (EV_ADD | EV_ENABLE))
+		kn->enabled = true;
+
+	if (change.flags & EV_DISABLE)
+		kn->enabled = false;
+
+	/* check the readiness of new or re-enabled knotes */
+	if (kn->enabled && (change.flags & (EV_ADD | EV_ENABLE)))
+		kq.enqueue(*kn);
+
+	return 0;
+}
+
+
+/**
+ * Report ready knotes of the kqueue
+ *
+ * Only the knotes queued on entry are checked. Knotes queued meanwhile are
+ * left for the next call.
+ *
+ * \param poll_all  check all polled knotes regardless of notifications
+ *
+ * \return number of events stored at 'events'
+ */
+static int collect(Kqueue &kq, struct kevent *events, int nevents, bool poll_all)
+{
+	Knote *last = nullptr;
+	{
+		Guard guard(kqueue_lock());
+
+		if (poll_all || kq.poll)
+			for (Knote *kn = kq.polled; kn; kn = kn->next_polled)
+				if (kn->enabled)
+					kq.enqueue(*kn);
+
+		kq.poll = false;
+		last    = kq.queue_tail;
+	}
+
+	int n = 0;
+
+	for (bool done = !last; !done && n < nevents; ) {
+
+		Knote           *kn = nullptr;
+		File_descriptor *fd = nullptr;
+		{
+			Guard guard(kqueue_lock());
+
+			kn = kq.dequeue();
+			if (!kn)
+				break;
+
+			done = (kn == last);
+			fd   = kn->watch.fd;
+		}
+
+		/* file descriptor got closed */
+		if (!fd) {
+			remove_and_release(*kn);
+			continue;
+		}
+
+		if (!kn->enabled)
+			continue;
+
+		bool const ready = (kn->filter == EVFILT_READ)
+		                 ? fd->plugin->read_ready(fd)
+		                 : fd->plugin->write_ready(fd);
+		if (!ready)
+			continue;
+
+		EV_SET(&events[n], kn->ident, kn->filter, kn->flags, 0, 1, kn->udata);
+		n++;
+
+		if (kn->flags & EV_ONESHOT) {
+			remove_and_release(*kn);
+			continue;
+		}
+
+		Guard guard(kqueue_lock());
+
+		if (kn->flags & EV_DISPATCH)
+			kn->enabled = false;
+
+		/* level-triggered knotes are reported as long as they are ready */
+		else if (!(kn->flags & EV_CLEAR))
+			kq.enqueue(*kn);
+	}
+
+	return n;
+}
+
+
+bool Libc::kqueue_notify(Vfs::Vfs_handle::Context *context)
+{
+	Guard guard(kqueue_lock());
+
+	bool ready = false;
+
+	if (context) {
+		Fd_watch &watch = *static_cast<Fd_watch *>(context);
+
+		for (Knote *kn = watch.knotes; kn; kn = kn->next_of_watch)
+			if (kn->enabled) {
+				kn->kq.enqueue(*kn);
+				ready = true;
+			}
+		return ready;
+	}
+
+	for (Kqueue *kq = kqueues; kq; kq = kq->next)
+		if (kq->polled) {
+			kq->poll = true;
+			ready    = true;
+		}
+
+	return ready;
+}
+
+
+void Libc::kqueue_close(File_descriptor *fd)
+{
+	if (fd->libc_fd < 0 || fd->libc_fd >= MAX_NUM_FDS)
+		return;
+
+	bool watched = false;
+	{
+		Guard guard(kqueue_lock());
+
+		Fd_watch * const watch = watches[fd->libc_fd];
+		if (!watch || watch->fd != fd)
+			return;
+
+		watches[fd->libc_fd] = nullptr;
+		watch->fd = nullptr;
+		watched   = watch->watched;
+
+		/* let 'kevent' drop the knotes */
+		for (Knote *kn = watch->knotes; kn; kn = kn->next_of_watch)
+			kn->kq.enqueue(*kn);
+	}
+
+	if (watched)
+		fd->plugin->watch(fd, nullptr);
+}
+
+
+/*******************
+ ** Kqueue plugin **
+ *******************/
+
+struct Libc::Kqueue_plugin : Plugin
+{
+	static Kqueue *kqueue(File_descriptor *fd)
+	{
+		return fd ? dynamic_cast<Kqueue *>(fd->context) : nullptr;
+	}
+
+	/* a kqueue is readable if it has events to check */
+	bool read_ready(File_descriptor *fd) override
+	{
+		Kqueue *kq = kqueue(fd);
+		return kq && kq->ready();
+	}
+
+	int close(File_descriptor *fd) override
+	{
+		Kqueue *kq = kqueue(fd);
+		if (!kq)
+			return Errno(EBADF);
+
+		{
+			Guard kevent_guard(kq->kevent_lock);
+
+			while (Knote *kn = kq->knotes)
+				remove_and_release(*kn);
+
+			Guard guard(kqueue_lock());
+
+			for (Kqueue **link = &kqueues; *link; link = &(*link)->next)
+				if (*link == kq) {
+					*link = kq->next;
+					break;
+				}
+		}
+
+		Genode::destroy(&kqueue_alloc, kq);
+		file_descriptor_allocator()->free(fd);
+		return 0;
+	}
+};
+
+
+static Kqueue_plugin &kqueue_plugin()
+{
+	static Kqueue_plugin inst;
+	return inst;
+}
+
+
+/********************
+ ** Libc functions **
+ ********************/
+
+extern "C" int kqueue(void)
+{
+	Libc::init_select_notify();
+
+	Kqueue *kq = new (&kqueue_alloc) Kqueue;
+
+	File_descriptor *fd = file_descriptor_allocator()->alloc(&kqueue_plugin(), kq);
+	if (!fd) {
+		Genode::destroy(&kqueue_alloc, kq);
+		return Errno(EMFILE);
+	}
+
+	Guard guard(kqueue_lock());
+	kq->next = kqueues;
+	kqueues  = kq;
+
+	return fd->libc_fd;
+}
+
+
+extern "C" int kevent(int libc_fd,
+                      struct kevent const *changelist, int nchanges,
+                      struct kevent       *eventlist,  int nevents,
+                      struct timespec const *ts)
+{
+	Kqueue *kq = Kqueue_plugin::kqueue(file_descriptor_allocator()->find_by_libc_fd(libc_fd));
+	if (!kq)
+		return Errno(EBADF);
+
+	if (nchanges < 0 || nevents < 0)
+		return Errno(EINVAL);
+
+	struct Timeout
+	{
+		bool    const valid;
+		unsigned long duration;
+
+		bool expired() const { return valid && duration == 0; }
+
+		Timeout(timespec const *ts)
+		:
+			valid(ts != nullptr),
+			/* round up to not turn a short timeout into polling */
+			duration(valid ? (unsigned long)ts->tv_sec*1000
+			                 + (ts->tv_nsec + 999999)/1000000 : 0UL)
+		{ }
+	} timeout { ts };
+
+	int n = 0;
+	{
+		Guard guard(kq->kevent_lock);
+
+		for (int i = 0; i < nchanges; i++) {
+
+			struct kevent const &change = changelist[i];
+
+			int const error = apply_change(*kq, change);
+			if (!error && !(change.flags & EV_RECEIPT))
+				continue;
+
+			/* report error as event if possible */
+			if (n == nevents) {
+				if (error)
+					return Errno(error);
+				continue;
+			}
+
+			eventlist[n]       = change;
+			eventlist[n].flags = EV_ERROR;
+			eventlist[n].data  = error;
+			n++;
+		}
+
+		if (n)
+			return n;
+
+		n = collect(*kq, eventlist, nevents, true);
+	}
+
+	if (n || nevents == 0)
+		return n;
+
+	struct Check : Libc::Suspend_functor
+	{
+		Kqueue  const &kq;
+		Timeout const &timeout;
+
+		Check(Kqueue const &kq, Timeout const &timeout)
+		: kq(kq), timeout(timeout) { }
+
+		bool suspend() override { return !timeout.expired() && !kq.ready(); }
+	} check { *kq, timeout };
+
+	while (!timeout.expired()) {
+
+		if (!kq->ready())
+			timeout.duration = Libc::suspend(check, timeout.duration);
+
+		Guard guard(kq->kevent_lock);
+
+		n = collect(*kq, eventlist, nevents, false);
+		if (n)
+			return n;
+	}
+
+	return 0;
+}
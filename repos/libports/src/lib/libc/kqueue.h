@@ -0,0 +1,41 @@
+/*
+ * \brief  Libc-internal interface of the kqueue implementation
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIBC__KQUEUE_H_
+#define _LIBC__KQUEUE_H_
+
+/* Genode includes */
+#include <vfs/vfs_handle.h>
+
+namespace Libc {
+
+	struct File_descriptor;
+
+	/**
+	 * Notify kqueues about a possible readiness change
+	 *
+	 * \param context  context of the watched file descriptor as passed to
+	 *                 the I/O-response handler, or nullptr if any file
+	 *                 descriptor that cannot be watched may be affected
+	 *
+	 * \return true if a kqueue has events to check
+	 */
+	bool kqueue_notify(Vfs::Vfs_handle::Context *context);
+
+	/**
+	 * Drop the kqueue events of a file descriptor that gets closed
+	 */
+	void kqueue_close(File_descriptor *);
+}
+
+#endif /* _LIBC__KQUEUE_H_ */
@@ -16,9 +16,12 @@
 #include <base/env.h>
 #include <base/log.h>
 #include <base/slab.h>
+#include <base/thread.h>
+#include <cpu/memory_barrier.h>
 #include <util/construct_at.h>
 #include <util/string.h>
 #include <util/misc_math.h>
+#include <libc/allocator.h>
 
 /* libc includes */
 extern "C" {
@@ -66,6 +69,17 @@ namespace Genode {
 
 /**
  * Allocator that uses slabs for small objects sizes
+ *
+ * Small allocations are served from size classes, which are spaced by 16
+ * bytes up to 128 bytes and by a quarter of the next power of two above.
+ * Each size class is backed by a slab allocator with a lock of its own.
+ * Each thread caches a few free blocks per size class so that most
+ * allocations and deallocations do not take any lock. A thread fetches
+ * blocks from the slab and returns blocks to it in batches.
+ *
+ * Allocations above the largest size class are served by the backing
+ * store. Large allocations get a dataspace of their own, which is freed
+ * as soon as the allocation is freed.
  */
 class Malloc
 {
@@ -75,9 +89,15 @@ class Malloc
 		typedef Genode::addr_t addr_t;
 
 		enum {
-			SLAB_START = 5,  /* 32 bytes (log2) */
-			SLAB_STOP  = 11, /* 2048 bytes (log2) */
-			NUM_SLABS  = (SLAB_STOP - SLAB_START) + 1
+			NUM_LINEAR_CLASSES = 7,     /* 32 to 128 bytes in steps of 16 */
+			NUM_CLASSES        = 35,
+			MAX_CLASS_SIZE     = 16384,
+			LARGE_SIZE         = 65536, /* minimum size of large allocations */
+
+			MAX_THREAD_CACHES  = 64,
+			BIN_BYTES          = 16384, /* bytes cached per thread and class */
+			MIN_BIN_BLOCKS     = 2,
+			MAX_BIN_BLOCKS     = 128,
 		};
 
 		struct Metadata
@@ -87,7 +107,7 @@ class Malloc
 			/**
 			 * Allocation metadata
 			 *
-			 * \param size    allocation size
+			 * \param size    size of the allocated block
 			 * \param offset  offset of pointer from allocation
 			 */
 			Metadata(size_t size, unsigned offset)
@@ -112,56 +132,352 @@ class Malloc
 		 */
 		static constexpr size_t _room() { return sizeof(Metadata) + 15; }
 
-		Genode::Allocator  &_backing_store;        /* back-end allocator */
-		Genode::Slab_alloc *_allocator[NUM_SLABS]; /* slab allocators */
-		Genode::Lock        _lock;
+		/**
+		 * Return index of the smallest size class that fits 'size' bytes
+		 */
+		static unsigned _class_index(size_t size)
+		{
+			if (size <= 32)
+				return 0;
+
+			if (size <= 128)
+				return ((size + 15) >> 4) - 2;
+
+			/* 'size' lies within ]2^msb, 2^(msb+1)] */
+			unsigned const msb = 8*sizeof(long) - 1 - __builtin_clzl(size - 1);
+
+			return NUM_LINEAR_CLASSES + (msb - 7)*4
+			     + ((size - 1 - (1UL << msb)) >> (msb - 2));
+		}
 
-		unsigned _slab_log2(size_t size) const
+		static size_t _class_size(unsigned index)
 		{
-			unsigned msb = Genode::log2(size);
+			if (index < NUM_LINEAR_CLASSES)
+				return 32 + 16*index;
 
-			/* size is greater than msb */
-			if (size > (1U << msb))
-				msb++;
+			unsigned const msb = 7 + (index - NUM_LINEAR_CLASSES)/4;
+			unsigned const q   =     (index - NUM_LINEAR_CLASSES)%4;
 
-			/* use smallest slab */
-			if (size < (1U << SLAB_START))
-				msb = SLAB_START;
+			return (1UL << msb) + (q + 1)*(1UL << (msb - 2));
+		}
 
-			return msb;
+		/**
+		 * Number of blocks a thread caches for the size class
+		 */
+		static unsigned _bin_limit(unsigned index)
+		{
+			return Genode::min((size_t)MAX_BIN_BLOCKS,
+			                   Genode::max((size_t)MIN_BIN_BLOCKS,
+			                               BIN_BYTES/_class_size(index)));
 		}
 
-	public:
+		struct Size_class
+		{
+			Genode::Lock       lock;
+			Genode::Slab_alloc slab;
+
+			Size_class(size_t size, Genode::Allocator &backing_store)
+			: slab(size, &backing_store) { }
+		};
+
+		/**
+		 * Free block, linked into the cache of a thread
+		 */
+		struct Free_block { Free_block *next; };
 
-		Malloc(Genode::Allocator &backing_store) : _backing_store(backing_store)
+		struct Thread_cache
 		{
-			for (unsigned i = SLAB_START; i <= SLAB_STOP; i++) {
-				_allocator[i - SLAB_START] =
-					new (backing_store) Genode::Slab_alloc(1U << i, &backing_store);
-			}
+			/* nullptr if the cache is free for the next new thread */
+			Genode::Thread const * volatile owner;
+
+			struct Bin
+			{
+				Free_block *head  = nullptr;
+				unsigned    count = 0;
+
+				void push(void *ptr)
+				{
+					Free_block *block = (Free_block *)ptr;
+					block->next = head;
+					head = block;
+					count++;
+				}
+
+				void *pop()
+				{
+					Free_block *block = head;
+					head = block->next;
+					count--;
+					return block;
+				}
+			} bins[NUM_CLASSES];
+
+			Thread_cache(Genode::Thread const *owner) : owner(owner) { }
+		};
+
+		/**
+		 * Header of a large allocation at the start of its dataspace
+		 */
+		struct Large_block
+		{
+			Genode::Ram_dataspace_capability ds;
+
+			Large_block(Genode::Ram_dataspace_capability ds) : ds(ds) { }
+		};
+
+		Genode::Ram_allocator &_ram;
+		Genode::Region_map    &_rm;
+		Genode::Allocator     &_backing_store;        /* back-end allocator */
+		Size_class            *_classes[NUM_CLASSES];
+
+		/*
+		 * Thread caches are looked up without locking by the address of the
+		 * 'Thread' object. When a thread exits, its cached blocks are
+		 * returned to the size classes and the cache is marked as free. The
+		 * cache object stays in its slot so that the lock-free lookup of
+		 * other threads is not cut short. It is reused by the next thread
+		 * that needs a cache.
+		 */
+		Thread_cache * volatile _caches[MAX_THREAD_CACHES] { };
+		Genode::Lock            _caches_lock;
+
+		static unsigned _cache_slot(Genode::Thread const *thread)
+		{
+			return ((addr_t)thread >> 4) % MAX_THREAD_CACHES;
 		}
 
-		~Malloc() { Genode::warning(__func__, " unexpectedly called"); }
+		/**
+		 * Return cache of the calling thread
+		 *
+		 * \return  nullptr if the thread cannot have a cache, in which case
+		 *          the size classes are used directly
+		 */
+		Thread_cache *_thread_cache()
+		{
+			Genode::Thread const * const myself = Genode::Thread::myself();
+
+			/* the main thread has no 'Thread' object during initialization */
+			if (!myself)
+				return nullptr;
+
+			unsigned const slot = _cache_slot(myself);
+
+			for (unsigned i = 0; i < MAX_THREAD_CACHES; i++) {
+				Thread_cache *cache = _caches[(slot + i) % MAX_THREAD_CACHES];
+				if (!cache)
+					break;
+				if (cache->owner == myself)
+					return cache;
+			}
+
+			/* assign cache on the first allocation of the thread */
+			Genode::Lock::Guard guard(_caches_lock);
+
+			for (unsigned i = 0; i < MAX_THREAD_CACHES; i++) {
+				Thread_cache * volatile &entry = _caches[(slot + i) % MAX_THREAD_CACHES];
+
+				/* reuse cache released by an exited thread */
+				if (entry && !entry->owner) {
+					entry->owner = myself;
+					return entry;
+				}
+
+				if (entry)
+					continue;
+
+				Thread_cache *cache = nullptr;
+				if (!_backing_store.alloc(sizeof(Thread_cache), &cache))
+					return nullptr;
+
+				Genode::construct_at<Thread_cache>(cache, myself);
+
+				/* make the cache visible only when it is fully constructed */
+				Genode::memory_barrier();
+				entry = cache;
+				return cache;
+			}
+			return nullptr;
+		}
 
 		/**
-		 * Allocator interface
+		 * Return cached blocks to the size classes
 		 */
+		void _flush(Thread_cache &cache)
+		{
+			for (unsigned i = 0; i < NUM_CLASSES; i++) {
+				Thread_cache::Bin &bin = cache.bins[i];
+				if (!bin.count)
+					continue;
+
+				Genode::Lock::Guard guard(_classes[i]->lock);
+				while (bin.count)
+					_classes[i]->slab.free(bin.pop());
+			}
+		}
 
-		void * alloc(size_t size)
+		void *_class_alloc(unsigned index)
 		{
-			Genode::Lock::Guard lock_guard(_lock);
+			Size_class   &size_class = *_classes[index];
+			Thread_cache *cache      = _thread_cache();
+
+			if (!cache) {
+				Genode::Lock::Guard guard(size_class.lock);
+				return size_class.slab.alloc();
+			}
+
+			Thread_cache::Bin &bin = cache->bins[index];
+			if (bin.count)
+				return bin.pop();
 
-			size_t   const real_size = size + _room();
-			unsigned const msb       = _slab_log2(real_size);
+			/* refill half of the cache at once */
+			Genode::Lock::Guard guard(size_class.lock);
 
-			void *alloc_addr = nullptr;
+			void *result = size_class.slab.alloc();
+			for (unsigned i = 1; result && i < _bin_limit(index)/2; i++) {
+				void *ptr = size_class.slab.alloc();
+				if (!ptr) break;
+				bin.push(ptr);
+			}
+			return result;
+		}
+
+		void _class_free(unsigned index, void *ptr)
+		{
+			Size_class   &size_class = *_classes[index];
+			Thread_cache *cache      = _thread_cache();
 
-			/* use backing store if requested memory is larger than largest slab */
-			if (msb > SLAB_STOP)
-				_backing_store.alloc(real_size, &alloc_addr);
+			if (!cache) {
+				Genode::Lock::Guard guard(size_class.lock);
+				size_class.slab.free(ptr);
+				return;
+			}
+
+			Thread_cache::Bin &bin = cache->bins[index];
+			bin.push(ptr);
+
+			if (bin.count <= _bin_limit(index))
+				return;
+
+			/* return half of the cache at once */
+			Genode::Lock::Guard guard(size_class.lock);
+
+			while (bin.count > _bin_limit(index)/2)
+				size_class.slab.free(bin.pop());
+		}
+
+		void *_large_alloc(size_t size, size_t &out_size)
+		{
+			size_t const ds_size = Genode::align_addr(size + sizeof(Large_block), 12);
+
+			Genode::Ram_dataspace_capability ds;
+			try {
+				ds = _ram.alloc(ds_size);
+
+				Large_block *block = _rm.attach(ds);
+				Genode::construct_at<Large_block>(block, ds);
+
+				out_size = ds_size - sizeof(Large_block);
+				return block + 1;
+			}
+			catch (Genode::Out_of_ram)  { }
+			catch (Genode::Out_of_caps) { }
+			catch (Genode::Region_map::Region_conflict) { }
+			catch (Genode::Region_map::Invalid_dataspace) { }
+
+			if (ds.valid())
+				_ram.free(ds);
+			return nullptr;
+		}
+
+		void _large_free(void *ptr)
+		{
+			Large_block * const block = (Large_block *)ptr - 1;
+			Genode::Ram_dataspace_capability const ds = block->ds;
+
+			block->~Large_block();
+			_rm.detach(block);
+			_ram.free(ds);
+		}
+
+		/**
+		 * Allocate block of at least 'size' bytes
+		 *
+		 * \param out_size  actual size of the block
+		 */
+		void *_block_alloc(size_t size, size_t &out_size)
+		{
+			if (size <= MAX_CLASS_SIZE) {
+				unsigned const index = _class_index(size);
+				out_size = _class_size(index);
+				return _class_alloc(index);
+			}
+
+			if (size >= LARGE_SIZE)
+				return _large_alloc(size, out_size);
+
+			void *addr = nullptr;
+			out_size = size;
+			return _backing_store.alloc(size, &addr) ? addr : nullptr;
+		}
+
+		/*
+		 * The kind of a block is determined by its size. Class sizes are
+		 * exact, and a large block is never smaller than 'LARGE_SIZE'.
+		 */
+		void _block_free(void *ptr, size_t size)
+		{
+			if (size <= MAX_CLASS_SIZE)
+				_class_free(_class_index(size), ptr);
+			else if (size >= LARGE_SIZE)
+				_large_free(ptr);
 			else
-				alloc_addr = _allocator[msb - SLAB_START]->alloc();
+				_backing_store.free(ptr, size);
+		}
+
+	public:
 
+		Malloc(Genode::Env &env, Genode::Allocator &backing_store)
+		:
+			_ram(env.ram()), _rm(env.rm()), _backing_store(backing_store)
+		{
+			for (unsigned i = 0; i < NUM_CLASSES; i++)
+				_classes[i] = new (backing_store)
+					Size_class(_class_size(i), backing_store);
+		}
+
+		~Malloc() { Genode::warning(__func__, " unexpectedly called"); }
+
+		/**
+		 * Release cache of an exited thread
+		 *
+		 * The thread must not allocate or free memory concurrently.
+		 */
+		void release_thread_cache(Genode::Thread const &thread)
+		{
+			Genode::Lock::Guard guard(_caches_lock);
+
+			for (unsigned i = 0; i < MAX_THREAD_CACHES; i++) {
+				Thread_cache *cache = _caches[i];
+				if (!cache || cache->owner != &thread)
+					continue;
+
+				_flush(*cache);
+				cache->owner = nullptr;
+				return;
+			}
+		}
+
+		/**
+		 * Allocator interface
+		 */
+
+		void * alloc(size_t size)
+		{
+			if (size > ~(size_t)0 - _room() - LARGE_SIZE)
+				return nullptr;
+
+			size_t block_size = 0;
+			void * const alloc_addr = _block_alloc(size + _room(), block_size);
 			if (!alloc_addr) return nullptr;
 
 			/* correctly align the allocation address */
@@ -170,18 +486,24 @@ class Malloc
 
 			unsigned const offset = (addr_t)aligned_addr - (addr_t)alloc_addr;
 
-			*(aligned_addr - 1) = Metadata(real_size, offset);
+			*(aligned_addr - 1) = Metadata(block_size, offset);
 
 			return aligned_addr;
 		}
 
 		void *realloc(void *ptr, size_t size)
 		{
-			size_t const real_size     = size + _room();
-			size_t const old_real_size = ((Metadata *)ptr - 1)->size();
+			Metadata const md = *((Metadata *)ptr - 1);
+
+			/* usable size of the current block */
+			size_t const old_size = md.size() - md.offset();
 
-			/* do not reallocate if new size is less than the current size */
-			if (real_size <= old_real_size)
+			/*
+			 * Grow or shrink in place if the block is large enough. Only a
+			 * large block is replaced when shrunk to less than half, to give
+			 * back its memory.
+			 */
+			if (size <= old_size && (md.size() < LARGE_SIZE || size >= old_size/2))
 				return ptr;
 
 			/* allocate new block */
@@ -189,7 +511,7 @@ class Malloc
 
 			if (new_addr) {
 				/* copy content from old block into new block */
-				memcpy(new_addr, ptr, old_real_size - _room());
+				memcpy(new_addr, ptr, Genode::min(old_size, size));
 
 				/* free old block */
 				free(ptr);
@@ -200,20 +522,9 @@ class Malloc
 
 		void free(void *ptr)
 		{
-			Genode::Lock::Guard lock_guard(_lock);
-
 			Metadata *md = (Metadata *)ptr - 1;
 
-			size_t   const  real_size  = md->size();
-			unsigned const  msb        = _slab_log2(real_size);
-
-			void *alloc_addr = (void *)((addr_t)ptr - md->offset());
-
-			if (msb > SLAB_STOP) {
-				_backing_store.free(alloc_addr, real_size);
-			} else {
-				_allocator[msb - SLAB_START]->free(alloc_addr);
-			}
+			_block_free((void *)((addr_t)ptr - md->offset()), md->size());
 		}
 };
 
@@ -255,7 +566,14 @@ extern "C" void *realloc(void *ptr, size_t size)
 }
 
 
-void Libc::init_malloc(Genode::Allocator &heap)
+void Libc::release_malloc_thread_cache(Genode::Thread const &thread)
+{
+	if (mallocator)
+		mallocator->release_thread_cache(thread);
+}
+
+
+void Libc::init_malloc(Genode::Env &env, Genode::Allocator &heap)
 {
-	mallocator = unmanaged_singleton<Malloc>(heap);
+	mallocator = unmanaged_singleton<Malloc>(env, heap);
 }
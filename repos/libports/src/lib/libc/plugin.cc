@@ -128,6 +128,44 @@ bool Plugin::supports_mmap()
 }
 
 
+static bool select_ready(Plugin &plugin, File_descriptor *fd, bool write)
+{
+	int const nfds = fd->libc_fd + 1;
+
+	fd_set readfds, writefds, exceptfds;
+	FD_ZERO(&readfds);
+	FD_ZERO(&writefds);
+	FD_ZERO(&exceptfds);
+	FD_SET(fd->libc_fd, write ? &writefds : &readfds);
+
+	timeval tv_0 = { 0, 0 };
+
+	if (!plugin.supports_select(nfds, &readfds, &writefds, &exceptfds, &tv_0))
+		return true;
+
+	return plugin.select(nfds, &readfds, &writefds, &exceptfds, &tv_0) > 0
+	    && FD_ISSET(fd->libc_fd, write ? &writefds : &readfds);
+}
+
+
+bool Plugin::read_ready(File_descriptor *fd)
+{
+	return select_ready(*this, fd, false);
+}
+
+
+bool Plugin::write_ready(File_descriptor *fd)
+{
+	return select_ready(*this, fd, true);
+}
+
+
+bool Plugin::watch(File_descriptor *, Vfs::Vfs_handle::Context *)
+{
+	return false;
+}
+
+
 /**
  * Generate dummy member function of Plugin class
  */
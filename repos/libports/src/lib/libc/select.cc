@@ -32,6 +32,7 @@
 #include <sys/select.h>
 #include <signal.h>
 
+#include "kqueue.h"
 #include "task.h"
 
 
@@ -196,11 +197,22 @@ static void select_notify()
 		}
 	});
 
+	/* file descriptors watched by kqueues that cannot tell about readiness */
+	if (Libc::kqueue_notify(nullptr))
+		resume_all = true;
+
 	if (resume_all)
 		Libc::resume_all();
 }
 
 
+void Libc::init_select_notify()
+{
+	if (!libc_select_notify)
+		libc_select_notify = select_notify;
+}
+
+
 static void print(Genode::Output &output, timeval *tv)
 {
 	if (!tv) {
@@ -224,9 +236,7 @@ _select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
 
 	Genode::Constructible<Libc::Select_cb> select_cb;
 
-	/* initialize the select notification function pointer */
-	if (!libc_select_notify)
-		libc_select_notify = select_notify;
+	Libc::init_select_notify();
 
 	if (readfds)   in_readfds   = *readfds;   else FD_ZERO(&in_readfds);
 	if (writefds)  in_writefds  = *writefds;  else FD_ZERO(&in_writefds);
@@ -352,9 +362,7 @@ int Libc::Select_handler_base::select(int nfds, fd_set &readfds,
 {
 	fd_set in_readfds, in_writefds, in_exceptfds;
 
-	/* initialize the select notification function pointer */
-	if (!libc_select_notify)
-		libc_select_notify = select_notify;
+	Libc::init_select_notify();
 
 	in_readfds   = readfds;
 	in_writefds  = writefds;
@@ -192,6 +192,26 @@ struct Socket_fs::Context : Libc::Plugin_context
 		{
 			return _accept_only ? accept_read_ready() : data_read_ready();
 		}
+
+		/**
+		 * Deliver readiness changes of the socket to VFS context
+		 *
+		 * The readiness of a listening socket is determined by the accept
+		 * file, which is why the socket must be watched after 'listen'.
+		 */
+		bool watch(Vfs::Vfs_handle::Context *context)
+		{
+			Fd const type = _accept_only ? Fd::ACCEPT : Fd::DATA;
+
+			/* a watched file is open already */
+			if (context) {
+				if (_accept_only) accept_fd();
+				else              data_fd();
+			}
+
+			Libc::File_descriptor *file = _fd[type].file;
+			return file && file->plugin->watch(file, context);
+		}
 };
 
 
@@ -236,6 +256,9 @@ struct Socket_fs::Plugin : Libc::Plugin
 	int fcntl(Libc::File_descriptor *, int, long) override;
 	int close(Libc::File_descriptor *) override;
 	int select(int, fd_set *, fd_set *, fd_set *, timeval *) override;
+	bool read_ready(Libc::File_descriptor *) override;
+	bool write_ready(Libc::File_descriptor *) override { return true; }
+	bool watch(Libc::File_descriptor *, Vfs::Vfs_handle::Context *) override;
 };
 
 
@@ -909,6 +932,27 @@ int Socket_fs::Plugin::select(int nfds,
 }
 
 
+bool Socket_fs::Plugin::read_ready(Libc::File_descriptor *fd)
+{
+	Socket_fs::Context *context = dynamic_cast<Socket_fs::Context *>(fd->context);
+	if (!context) return false;
+
+	try { return context->read_ready(); }
+	catch (Socket_fs::Context::Inaccessible) { return false; }
+}
+
+
+bool Socket_fs::Plugin::watch(Libc::File_descriptor *fd,
+                              Vfs::Vfs_handle::Context *watch_context)
+{
+	Socket_fs::Context *context = dynamic_cast<Socket_fs::Context *>(fd->context);
+	if (!context) return false;
+
+	try { return context->watch(watch_context); }
+	catch (Socket_fs::Context::Inaccessible) { return false; }
+}
+
+
 int Socket_fs::Plugin::close(Libc::File_descriptor *fd)
 {
 	Socket_fs::Context *context = dynamic_cast<Socket_fs::Context *>(fd->context);
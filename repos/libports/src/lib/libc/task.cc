@@ -33,6 +33,7 @@
 #include <internal/call_func.h>
 #include <base/internal/unmanaged_singleton.h>
 #include "vfs_plugin.h"
+#include "kqueue.h"
 #include "libc_init.h"
 #include "task.h"
 
@@ -347,8 +348,12 @@ extern void (*libc_select_notify)();
 
 struct Libc::Io_response_handler : Vfs::Io_response_handler
 {
-	void handle_io_response(Vfs::Vfs_handle::Context *) override
+	void handle_io_response(Vfs::Vfs_handle::Context *context) override
 	{
+		/* the context refers to file descriptors watched by kqueues */
+		if (context)
+			Libc::kqueue_notify(context);
+
 		/* some contexts may have been deblocked from select() */
 		if (libc_select_notify)
 			libc_select_notify();
@@ -885,7 +890,7 @@ void Component::construct(Genode::Env &env)
 		*unmanaged_singleton<Genode::Heap>(env.ram(), env.rm());
 
 	/* pass Genode::Env to libc subsystems that depend on it */
-	Libc::init_malloc(heap);
+	Libc::init_malloc(env, heap);
 	Libc::init_mem_alloc(env);
 	Libc::init_dl(env);
 	Libc::sysctl_init(env);
@@ -64,6 +64,14 @@ namespace Libc {
 	 * Schedule select handler that is deblocked by ready fd sets
 	 */
 	void schedule_select(Select_handler_base *);
+
+	/**
+	 * Install the notification of select and kqueue waiters by plugins
+	 *
+	 * Plugins that do not use the VFS notify waiters via the
+	 * 'libc_select_notify' function pointer.
+	 */
+	void init_select_notify();
 }
 
 #endif /* _LIBC__TASK_H_ */
@@ -16,6 +16,7 @@
 /* Genode includes */
 #include <base/env.h>
 #include <base/log.h>
+#include <dataspace/client.h>
 #include <vfs/dir_file_system.h>
 
 /* libc includes */
@@ -1099,25 +1100,96 @@ int Libc::Vfs_plugin::rename(char const *from_path, char const *to_path)
 }
 
 
-void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags,
-                             Libc::File_descriptor *fd, ::off_t offset)
+/**
+ * Map file content by attaching the dataspace provided by the VFS
+ *
+ * \return  nullptr if the file cannot be mapped without copying
+ */
+void *Libc::Vfs_plugin::_map_dataspace(::size_t length, int prot, int flags,
+                                       Libc::File_descriptor *fd, ::off_t offset)
 {
-	if (prot != PROT_READ) {
-		Genode::error("mmap for prot=", Genode::Hex(prot), " not supported");
-		errno = EACCES;
-		return (void *)-1;
+	bool const shared   = flags & MAP_SHARED;
+	bool const writable = prot & PROT_WRITE;
+
+	/* private writable mappings need a copy of the file content */
+	if (writable && !shared)
+		return nullptr;
+
+	/* the dataspace can be attached at page granularity only */
+	if (!fd->fd_path || offset < 0 || (offset & ((1UL << PAGE_SHIFT) - 1)))
+		return nullptr;
+
+	/* modifications of a copy would not reach the file */
+	if (writable && !vfs_handle(fd)->ds().dataspace_holds_content())
+		return nullptr;
+
+	Genode::Dataspace_capability const ds = _root_dir.dataspace(fd->fd_path);
+	if (!ds.valid())
+		return nullptr;
+
+	/*
+	 * Note that a writable dataspace is attached writable even if the
+	 * mapping is requested read-only.
+	 */
+	void *addr = nullptr;
+	{
+		Genode::Dataspace_client ds_client(ds);
+
+		bool const suitable = (writable ? ds_client.writable() : true)
+		                   && (::size_t)offset + length <= ds_client.size();
+		if (suitable) {
+			try {
+				addr = _rm.attach(ds, length, offset, false, (void *)0,
+				                  prot & PROT_EXEC);
+			}
+			catch (Genode::Region_map::Region_conflict) { }
+			catch (Genode::Region_map::Invalid_dataspace) { }
+			catch (Genode::Out_of_ram) { }
+			catch (Genode::Out_of_caps) { }
+		}
 	}
 
+	if (!addr) {
+		_root_dir.release(fd->fd_path, ds);
+		return nullptr;
+	}
+
+	Genode::Lock::Guard guard(_mappings_lock);
+	_mappings.insert(new (_alloc) Mapping(addr, ds, fd->fd_path));
+
+	return addr;
+}
+
+
+void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags,
+                             Libc::File_descriptor *fd, ::off_t offset)
+{
 	if (addr_in != 0) {
 		Genode::error("mmap for predefined address not supported");
 		errno = EINVAL;
 		return (void *)-1;
 	}
 
+	bool const shared_writable = (flags & MAP_SHARED) && (prot & PROT_WRITE);
+
+	if (shared_writable && (fd->flags & O_ACCMODE) != O_RDWR) {
+		errno = EACCES;
+		return (void *)-1;
+	}
+
+	if (void *addr = _map_dataspace(length, prot, flags, fd, offset))
+		return addr;
+
 	/*
-	 * XXX attempt to obtain memory mapping via
-	 *     'Vfs::Directory_service::dataspace'.
+	 * Fall back to copying the file content, which is only sufficient if
+	 * modifications of the mapping do not need to reach the file.
 	 */
+	if (shared_writable) {
+		Genode::error("mmap of ", fd->fd_path, " with MAP_SHARED and "
+		              "PROT_WRITE not supported by file system");
+		errno = ENODEV;
+		return (void *)-1;
+	}
 
 	void *addr = Libc::mem_alloc()->alloc(length, PAGE_SHIFT);
 	if (addr == (void *)-1) {
@@ -1138,7 +1210,35 @@ void *Libc::Vfs_plugin::mmap(void *addr_in, ::size_t length, int prot, int flags
 
 int Libc::Vfs_plugin::munmap(void *addr, ::size_t)
 {
-	Libc::mem_alloc()->free(addr);
+	Mapping *mapping = nullptr;
+	{
+		Genode::Lock::Guard guard(_mappings_lock);
+
+		for (mapping = _mappings.first(); mapping; mapping = mapping->next())
+			if (mapping->addr == addr) {
+				_mappings.remove(mapping);
+				break;
+			}
+	}
+
+	if (!mapping) {
+		Libc::mem_alloc()->free(addr);
+		return 0;
+	}
+
+	_rm.detach(addr);
+	_root_dir.release(mapping->path.string(), mapping->ds);
+	destroy(_alloc, mapping);
+	return 0;
+}
+
+
+int Libc::Vfs_plugin::msync(void *, ::size_t, int)
+{
+	/*
+	 * Shared writable mappings refer to the file content directly and
+	 * private mappings are never written back. So there is nothing to do.
+	 */
 	return 0;
 }
 
@@ -1200,7 +1300,7 @@ int Libc::Vfs_plugin::select(int nfds,
 		}
 
 		if (FD_ISSET(fd, &in_writefds)) {
-			if (true /* XXX always writeable */) {
+			if (true /* XXX always writable */) {
 				FD_SET(fd, writefds);
 				++nready;
 			}
@@ -1210,3 +1310,26 @@ int Libc::Vfs_plugin::select(int nfds,
 	}
 	return nready;
 }
+
+
+bool Libc::Vfs_plugin::read_ready(Libc::File_descriptor *fd)
+{
+	return Libc::read_ready(fd);
+}
+
+
+bool Libc::Vfs_plugin::watch(Libc::File_descriptor *fd,
+                             Vfs::Vfs_handle::Context *context)
+{
+	Vfs::Vfs_handle *handle = vfs_handle(fd);
+	if (!handle)
+		return false;
+
+	/* the file system passes the context of the handle to the I/O response */
+	handle->context = context;
+
+	if (context)
+		handle->fs().notify_read_ready(handle);
+
+	return true;
+}
@@ -18,6 +18,8 @@
 
 /* Genode includes */
 #include <libc/component.h>
+#include <base/lock.h>
+#include <util/list.h>
 #include "task.h"
 
 /* libc includes */
@@ -39,6 +41,28 @@ class Libc::Vfs_plugin : public Libc::Plugin
 
 		Vfs::File_system &_root_dir;
 
+		Genode::Region_map &_rm;
+
+		/**
+		 * File region mapped via the dataspace provided by the VFS
+		 */
+		struct Mapping : Genode::List<Mapping>::Element
+		{
+			void                         * const addr;
+			Genode::Dataspace_capability   const ds;
+
+			/* path used to obtain the dataspace, needed for releasing it */
+			Genode::String<Vfs::MAX_PATH_LEN> const path;
+
+			Mapping(void *addr, Genode::Dataspace_capability ds, char const *path)
+			: addr(addr), ds(ds), path(path) { }
+		};
+
+		Genode::List<Mapping> _mappings;
+		Genode::Lock          _mappings_lock;
+
+		void *_map_dataspace(::size_t, int, int, Libc::File_descriptor *, ::off_t);
+
 		void _open_stdio(Genode::Xml_node const &node, char const *attr,
 		                 int libc_fd, unsigned flags)
 		{
@@ -138,7 +162,7 @@ class Libc::Vfs_plugin : public Libc::Plugin
 
 		Vfs_plugin(Libc::Env &env, Genode::Allocator &alloc)
 		:
-			_alloc(alloc), _root_dir(env.vfs())
+			_alloc(alloc), _root_dir(env.vfs()), _rm(env.rm())
 		{
 			using Genode::Xml_node;
 
@@ -206,7 +230,11 @@ class Libc::Vfs_plugin : public Libc::Plugin
 		ssize_t write(Libc::File_descriptor *, const void *, ::size_t ) override;
 		void   *mmap(void *, ::size_t, int, int, Libc::File_descriptor *, ::off_t) override;
 		int     munmap(void *, ::size_t) override;
+		int     msync(void *, ::size_t, int) override;
 		int     select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout) override;
+		bool    read_ready(Libc::File_descriptor *) override;
+		bool    write_ready(Libc::File_descriptor *) override { return true; }
+		bool    watch(Libc::File_descriptor *, Vfs::Vfs_handle::Context *) override;
 };
 
 #endif
@@ -14,8 +14,10 @@
 
 #include <base/log.h>
 #include <base/thread.h>
+#include <cpu/memory_barrier.h>
 #include <os/timed_semaphore.h>
 #include <util/list.h>
+#include <util/string.h>
 
 #include <errno.h>
 #include <pthread.h>
@@ -163,6 +165,14 @@ extern "C" {
 
 	void pthread_exit(void *value_ptr)
 	{
+		pthread_tsd_destruct();
+
+		/*
+		 * Return the blocks cached by the thread right away because the
+		 * destruction of a self-exiting thread is deferred.
+		 */
+		Libc::release_malloc_thread_cache(*Thread::myself());
+
 		pthread_cancel(pthread_self());
 
 		Lock lock;
@@ -734,38 +744,197 @@ extern "C" {
 	/* TLS */
 
 
-	struct Key_element : List<Key_element>::Element
+	/*
+	 * Thread-specific data
+	 *
+	 * Each thread that sets a value gets an array of values indexed by
+	 * the key. The arrays are found via a hash table keyed by the 'Thread'
+	 * object of the caller, which is looked up without locking. Each value
+	 * is tagged with the sequence number of its key, which invalidates the
+	 * values of a deleted key once the key gets reused.
+	 */
+
+	struct Key
+	{
+		bool          used = false;
+		unsigned long seq  = 0;
+		void        (*destructor)(void *) = nullptr;
+	};
+
+	static Lock key_lock;
+	static Key  keys[PTHREAD_KEYS_MAX];
+
+
+	struct Thread_specific_data
 	{
-		const void *thread_base;
-		const void *value;
+		/*
+		 * The owner is modified with 'key_lock' held, but read without
+		 * locking while looking up the data of a thread.
+		 */
+		Thread const * volatile owner;
+
+		struct Value
+		{
+			void const   *value;
+			unsigned long seq;
+		} values[PTHREAD_KEYS_MAX];
 
-		Key_element(const void *thread_base, const void *value)
-		: thread_base(thread_base),
-		  value(value) { }
+		void const *value(pthread_key_t key) const
+		{
+			Value const &v = values[key];
+			return v.seq == keys[key].seq ? v.value : nullptr;
+		}
 	};
 
+	/*
+	 * Entries of the table are never removed. The data of an exited thread
+	 * stays in the table without owner and is reused by the next thread
+	 * that probes the entry. Hence, a lookup can stop at the first empty
+	 * entry and a concurrent lookup never reads freed memory.
+	 */
+	enum { TSD_TABLE_SIZE = 256 };
+
+	static Thread_specific_data * volatile tsd_table[TSD_TABLE_SIZE];
+
+
+	/**
+	 * Return key for identifying the calling thread
+	 *
+	 * The main thread has no 'Thread' object during the early
+	 * initialization.
+	 */
+	static Thread const *tsd_owner()
+	{
+		static char main_thread_owner;
+
+		Thread const * const myself = Thread::myself();
+		return myself ? myself : (Thread const *)&main_thread_owner;
+	}
+
+
+	static unsigned tsd_slot(Thread const *owner)
+	{
+		return (((addr_t)owner >> 4)*2654435761UL) % TSD_TABLE_SIZE;
+	}
+
+
+	static Thread_specific_data *tsd_lookup(Thread const *owner)
+	{
+		unsigned const slot = tsd_slot(owner);
+
+		for (unsigned i = 0; i < TSD_TABLE_SIZE; i++) {
+
+			Thread_specific_data *tsd = tsd_table[(slot + i) % TSD_TABLE_SIZE];
+
+			if (!tsd)          return nullptr;
+			if (tsd->owner == owner) return tsd;
+		}
+		return nullptr;
+	}
+
+
+	/**
+	 * Return data of the calling thread, create it if needed
+	 */
+	static Thread_specific_data *tsd_create(Thread const *owner)
+	{
+		Lock_guard<Lock> guard(key_lock);
+
+		unsigned const slot = tsd_slot(owner);
+
+		for (unsigned i = 0; i < TSD_TABLE_SIZE; i++) {
+
+			Thread_specific_data * volatile &entry =
+				tsd_table[(slot + i) % TSD_TABLE_SIZE];
+
+			/* reuse data of exited thread */
+			if (entry && !entry->owner) {
+				memset((void *)entry->values, 0, sizeof(entry->values));
+				entry->owner = owner;
+				return entry;
+			}
+
+			if (entry)
+				continue;
+
+			Thread_specific_data *tsd = (Thread_specific_data *)
+				calloc(1, sizeof(Thread_specific_data));
+			if (!tsd)
+				return nullptr;
+
+			tsd->owner = owner;
+
+			/* make the data visible only when it is initialized */
+			memory_barrier();
+			entry = tsd;
+			return tsd;
+		}
+		return nullptr;
+	}
+
+
+	void pthread_tsd_release(Thread const &thread)
+	{
+		Lock_guard<Lock> guard(key_lock);
+
+		if (Thread_specific_data *tsd = tsd_lookup(&thread))
+			tsd->owner = nullptr;
+	}
+
+
+	void pthread_tsd_destruct()
+	{
+		Thread_specific_data *tsd = tsd_lookup(tsd_owner());
+		if (!tsd)
+			return;
+
+		/*
+		 * Destructors may set values again, which calls for another
+		 * iteration, up to 'PTHREAD_DESTRUCTOR_ITERATIONS' times.
+		 */
+		for (unsigned i = 0; i < PTHREAD_DESTRUCTOR_ITERATIONS; i++) {
+
+			bool called = false;
+
+			for (pthread_key_t k = 0; k < PTHREAD_KEYS_MAX; k++) {
+
+				void (*destructor)(void *) = keys[k].destructor;
+				void *value = (void *)tsd->value(k);
+
+				if (!keys[k].used || !destructor || !value)
+					continue;
+
+				tsd->values[k].value = nullptr;
+				destructor(value);
+				called = true;
+			}
+
+			if (!called)
+				break;
+		}
+
+		Lock_guard<Lock> guard(key_lock);
+		tsd->owner = nullptr;
+	}
 
-	static Lock key_list_lock;
-	List<Key_element> key_list[PTHREAD_KEYS_MAX];
 
 	int pthread_key_create(pthread_key_t *key, void (*destructor)(void*))
 	{
 		if (!key)
 			return EINVAL;
 
-		Lock_guard<Lock> key_list_lock_guard(key_list_lock);
+		Lock_guard<Lock> guard(key_lock);
 
 		for (int k = 0; k < PTHREAD_KEYS_MAX; k++) {
-			/*
-			 * Find an empty key slot and insert an element for the current
-			 * thread to mark the key slot as used.
-			 */
-			if (!key_list[k].first()) {
-				Key_element *key_element = new Key_element(Thread::myself(), 0);
-				key_list[k].insert(key_element);
-				*key = k;
-				return 0;
-			}
+			if (keys[k].used)
+				continue;
+
+			/* a new sequence number invalidates values of a former use */
+			keys[k].used       = true;
+			keys[k].seq       += 1;
+			keys[k].destructor = destructor;
+			*key = k;
+			return 0;
 		}
 
 		return EAGAIN;
@@ -774,15 +943,16 @@ extern "C" {
 
 	int pthread_key_delete(pthread_key_t key)
 	{
-		if (key < 0 || key >= PTHREAD_KEYS_MAX || !key_list[key].first())
+		if (key < 0 || key >= PTHREAD_KEYS_MAX)
 			return EINVAL;
 
-		Lock_guard<Lock> key_list_lock_guard(key_list_lock);
+		Lock_guard<Lock> guard(key_lock);
 
-		while (Key_element * element = key_list[key].first()) {
-			key_list[key].remove(element);
-			delete element;
-		}
+		if (!keys[key].used)
+			return EINVAL;
+
+		keys[key].used       = false;
+		keys[key].destructor = nullptr;
 
 		return 0;
 	}
@@ -790,23 +960,24 @@ extern "C" {
 
 	int pthread_setspecific(pthread_key_t key, const void *value)
 	{
-		if (key < 0 || key >= PTHREAD_KEYS_MAX)
+		if (key < 0 || key >= PTHREAD_KEYS_MAX || !keys[key].used)
 			return EINVAL;
 
-		void *myself = Thread::myself();
-
-		Lock_guard<Lock> key_list_lock_guard(key_list_lock);
+		Thread const * const owner = tsd_owner();
 
-		for (Key_element *key_element = key_list[key].first(); key_element;
-		     key_element = key_element->next())
-			if (key_element->thread_base == myself) {
-				key_element->value = value;
+		Thread_specific_data *tsd = tsd_lookup(owner);
+		if (!tsd) {
+			/* no need to create data for storing the default value */
+			if (!value)
 				return 0;
-			}
 
-		/* key element does not exist yet - create a new one */
-		Key_element *key_element = new Key_element(Thread::myself(), value);
-		key_list[key].insert(key_element);
+			tsd = tsd_create(owner);
+			if (!tsd)
+				return ENOMEM;
+		}
+
+		tsd->values[key].value = value;
+		tsd->values[key].seq   = keys[key].seq;
 		return 0;
 	}
 
@@ -816,16 +987,9 @@ extern "C" {
 		if (key < 0 || key >= PTHREAD_KEYS_MAX)
 			return nullptr;
 
-		void *myself = Thread::myself();
-
-		Lock_guard<Lock> key_list_lock_guard(key_list_lock);
+		Thread_specific_data const *tsd = tsd_lookup(tsd_owner());
 
-		for (Key_element *key_element = key_list[key].first(); key_element;
-		     key_element = key_element->next())
-			if (key_element->thread_base == myself)
-				return (void*)(key_element->value);
-
-		return 0;
+		return tsd ? (void *)tsd->value(key) : nullptr;
 	}
 
 
@@ -18,6 +18,9 @@
 
 #include <pthread.h>
 
+/* libc includes */
+#include <libc/allocator.h>
+
 /*
  * Used by 'pthread_self()' to find out if the current thread is an alien
  * thread.
@@ -45,6 +48,17 @@ Pthread_registry &pthread_registry();
 
 extern "C" {
 
+	/**
+	 * Call destructors of the thread-specific data of the calling thread
+	 * and release the data
+	 */
+	void pthread_tsd_destruct();
+
+	/**
+	 * Release thread-specific data of a thread without calling destructors
+	 */
+	void pthread_tsd_release(Genode::Thread const &);
+
 	struct pthread_attr
 	{
 		pthread_t pthread;
@@ -95,6 +109,8 @@ extern "C" {
 
 		virtual ~pthread()
 		{
+			Libc::release_malloc_thread_cache(*this);
+			pthread_tsd_release(*this);
 			pthread_registry().remove(this);
 		}
 
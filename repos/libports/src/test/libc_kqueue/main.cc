@@ -0,0 +1,202 @@
+/*
+ * \brief  Test kqueue() and kevent() in libc
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The test watches a pipe, which is polled by the kqueue, and the terminal
+ * given as argument, which is watched via its VFS handle.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* libc includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+
+
+static void die(char const *token) __attribute__((noreturn));
+static void die(char const *token)
+{
+	printf("Error: %s: %s\n", token, strerror(errno));
+	exit(1);
+}
+
+
+static void check(bool condition, char const *what)
+{
+	if (condition)
+		return;
+
+	printf("Error: %s\n", what);
+	exit(1);
+}
+
+
+enum { PIPE_ROUNDS = 10 };
+
+
+static void *pipe_writer(void *arg)
+{
+	int const fd = *(int *)arg;
+
+	for (int i = 0; i < PIPE_ROUNDS; i++) {
+		timespec const ts { 0, 200*1000*1000 };
+		nanosleep(&ts, nullptr);
+		write(fd, "X", 1);
+	}
+	return nullptr;
+}
+
+
+static void test_changes(int kq, int pipe_out)
+{
+	struct kevent change, event;
+	timespec const zero { 0, 0 };
+
+	/* unknown file descriptor is reported as error event */
+	EV_SET(&change, 1000, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+	check(kevent(kq, &change, 1, &event, 1, &zero) == 1
+	   && (event.flags & EV_ERROR) && event.data == EBADF,
+	      "adding unknown fd did not fail with EBADF");
+
+	/* without room for the error, kevent fails */
+	check(kevent(kq, &change, 1, nullptr, 0, &zero) == -1 && errno == EBADF,
+	      "adding unknown fd did not return -1");
+
+	/* deleting a knote that does not exist */
+	EV_SET(&change, pipe_out, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+	check(kevent(kq, &change, 1, &event, 1, &zero) == 1
+	   && (event.flags & EV_ERROR) && event.data == ENOENT,
+	      "deleting unknown knote did not fail with ENOENT");
+
+	/* nothing ready yet */
+	EV_SET(&change, pipe_out, EVFILT_READ, EV_ADD, 0, 0, (void *)0x1234);
+	check(kevent(kq, &change, 1, &event, 1, &zero) == 0,
+	      "empty pipe reported as ready");
+
+	printf("kevent changes: ok\n");
+}
+
+
+static void test_pipe(int kq, int pipe_out)
+{
+	struct kevent event;
+
+	for (int i = 0; i < PIPE_ROUNDS; i++) {
+
+		timespec const timeout { 2, 0 };
+
+		int const n = kevent(kq, nullptr, 0, &event, 1, &timeout);
+		if (n == -1)
+			die("kevent");
+
+		check(n == 1, "timeout while waiting for pipe");
+		check(event.ident == (uintptr_t)pipe_out && event.filter == EVFILT_READ
+		   && event.udata == (void *)0x1234, "unexpected event");
+
+		char c;
+		check(read(pipe_out, &c, 1) == 1, "could not read from pipe");
+	}
+
+	/* a deleted knote is not reported anymore */
+	struct kevent change;
+	EV_SET(&change, pipe_out, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+	check(kevent(kq, &change, 1, nullptr, 0, nullptr) == 0, "EV_DELETE failed");
+
+	printf("kevent pipe: ok\n");
+}
+
+
+static void test_terminal(int kq, char const *path)
+{
+	int const fd = open(path, O_RDWR | O_NONBLOCK);
+	if (fd == -1)
+		die("open");
+
+	struct kevent change[2], event[2];
+
+	/* the terminal is writable, the one-shot knote is reported only once */
+	EV_SET(&change[0], fd, EVFILT_WRITE, EV_ADD | EV_ONESHOT, 0, 0, nullptr);
+	EV_SET(&change[1], fd, EVFILT_READ,  EV_ADD | EV_CLEAR,   0, 0, nullptr);
+
+	timespec const zero { 0, 0 };
+	int n = kevent(kq, change, 2, event, 2, &zero);
+	check(n >= 1, "terminal not writable");
+
+	n = kevent(kq, nullptr, 0, event, 2, &zero);
+	for (int i = 0; i < n; i++)
+		check(event[i].filter != EVFILT_WRITE, "one-shot knote reported twice");
+
+	/* wait for the counter to send data */
+	unsigned bytes = 0;
+	for (int i = 0; i < 10 && bytes < 10; i++) {
+
+		timespec const timeout { 2, 0 };
+
+		n = kevent(kq, nullptr, 0, event, 2, &timeout);
+		if (n == -1)
+			die("kevent");
+
+		for (int j = 0; j < n; j++) {
+			check(event[j].ident == (uintptr_t)fd && event[j].filter == EVFILT_READ,
+			      "unexpected terminal event");
+
+			char buf[64];
+			ssize_t r;
+			while ((r = read(fd, buf, sizeof(buf))) > 0)
+				bytes += r;
+		}
+	}
+	check(bytes > 0, "no data received from terminal");
+
+	/* closing the fd drops its knotes */
+	close(fd);
+	check(kevent(kq, nullptr, 0, event, 2, &zero) == 0,
+	      "knote of closed fd reported");
+
+	printf("kevent terminal: ok (%u bytes)\n", bytes);
+}
+
+
+int main(int argc, char **argv)
+{
+	printf("--- kqueue test ---\n");
+
+	int const kq = kqueue();
+	if (kq == -1)
+		die("kqueue");
+
+	int pipe_fd[2];
+	if (pipe(pipe_fd) == -1)
+		die("pipe");
+
+	test_changes(kq, pipe_fd[0]);
+
+	pthread_t t;
+	if (pthread_create(&t, nullptr, pipe_writer, &pipe_fd[1]) != 0)
+		die("pthread_create");
+
+	test_pipe(kq, pipe_fd[0]);
+
+	if (argc > 1)
+		test_terminal(kq, argv[1]);
+
+	close(kq);
+
+	printf("--- kqueue test finished ---\n");
+	exit(0);
+}
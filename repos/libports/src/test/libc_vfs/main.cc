@@ -21,6 +21,7 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/uio.h>
 #include <unistd.h>
@@ -76,13 +77,24 @@ static void test_write_read(Genode::Xml_node node)
 
 		int fd = open(file_name, O_CREAT | O_RDWR);
 
-		memset(buf, round, buffer_size);
-
-		/* write-read i_max times the buffer */
+		/* write-read i_max times the buffer, each time with other content */
 		unsigned const i_max = size/buffer_size;
-		for (unsigned i = 0; i < i_max; ++i) write(fd, buf, buffer_size);
-		lseek(fd, SEEK_SET, 0);
-		for (unsigned i = 0; i < i_max; ++i) read(fd, buf, buffer_size);
+		for (unsigned i = 0; i < i_max; ++i) {
+			memset(buf, round + i, buffer_size);
+			write(fd, buf, buffer_size);
+		}
+		lseek(fd, 0, SEEK_SET);
+		for (unsigned i = 0; i < i_max; ++i) {
+			char const expected = round + i;
+
+			ssize_t const count = read(fd, buf, buffer_size);
+			if ((size_t)count != buffer_size
+			 || ((char *)buf)[0] != expected
+			 || ((char *)buf)[buffer_size - 1] != expected) {
+				printf("write-read test: unexpected data in block %u\n", i);
+				throw Test_failed();
+			}
+		}
 
 		close(fd);
 		printf("finished round %u\n", round);
@@ -92,6 +104,142 @@ static void test_write_read(Genode::Xml_node node)
 }
 
 
+/**
+ * List directory with more entries than fit into one file-system packet
+ */
+static void test_large_dir()
+{
+	enum { NUM_ENTRIES = 300 };
+
+	char const *dir_name = "large_dir";
+	bool seen[NUM_ENTRIES] { };
+	int ret, fd;
+
+	CALL_AND_CHECK(ret, mkdir(dir_name, 0777), ret == 0, "dir_name=%s", dir_name);
+
+	printf("creating %d files\n", NUM_ENTRIES);
+	for (unsigned i = 0; i < NUM_ENTRIES; i++) {
+		char path[64];
+		snprintf(path, sizeof(path), "%s/entry_%u", dir_name, i);
+		fd = open(path, O_CREAT | O_WRONLY);
+		if (fd < 0) {
+			printf("could not create %s\n", path);
+			throw Test_failed();
+		}
+		close(fd);
+	}
+
+	DIR *dir;
+	CALL_AND_CHECK(dir, opendir(dir_name), dir, "dir_name=\"%s\"", dir_name);
+
+	unsigned cnt = 0;
+	while (struct dirent *dirent = readdir(dir)) {
+		unsigned i = NUM_ENTRIES;
+		if (sscanf(dirent->d_name, "entry_%u", &i) != 1 || i >= NUM_ENTRIES
+		 || seen[i]) {
+			printf("unexpected directory entry %s\n", dirent->d_name);
+			throw Test_failed();
+		}
+		seen[i] = true;
+		cnt++;
+	}
+	closedir(dir);
+
+	if (cnt != NUM_ENTRIES) {
+		printf("found %u of %d directory entries\n", cnt, NUM_ENTRIES);
+		throw Test_failed();
+	}
+	printf("found all %u directory entries\n", cnt);
+}
+
+
+/**
+ * Map file read-only and, if supported by the file system, shared writable
+ */
+static void test_mmap()
+{
+	enum { PAGE = 4096, NUM_PAGES = 3, SIZE = NUM_PAGES*PAGE };
+
+	char const *file_name = "mmap.tst";
+	static char buf[SIZE];
+	int ret, fd;
+	ssize_t count;
+	char *addr;
+
+	for (unsigned i = 0; i < SIZE; i++)
+		buf[i] = 'a' + (i/PAGE + i) % 26;
+
+	CALL_AND_CHECK(fd, open(file_name, O_CREAT | O_RDWR), fd >= 0, "file_name=%s", file_name);
+	CALL_AND_CHECK(count, write(fd, buf, SIZE), count == SIZE, "");
+
+	/* read-only mappings of the whole file and of a part of it */
+	CALL_AND_CHECK(addr, (char *)mmap(0, SIZE, PROT_READ, MAP_PRIVATE, fd, 0),
+	               addr != MAP_FAILED, "");
+	if (memcmp(addr, buf, SIZE) != 0) {
+		printf("unexpected content of mapping\n");
+		throw Test_failed();
+	}
+	CALL_AND_CHECK(ret, munmap(addr, SIZE), ret == 0, "");
+
+	CALL_AND_CHECK(addr, (char *)mmap(0, PAGE, PROT_READ, MAP_SHARED, fd, PAGE),
+	               addr != MAP_FAILED, "");
+	if (memcmp(addr, buf + PAGE, PAGE) != 0) {
+		printf("unexpected content of mapping at offset\n");
+		throw Test_failed();
+	}
+	CALL_AND_CHECK(ret, munmap(addr, PAGE), ret == 0, "");
+
+	/* shared writable mapping */
+	addr = (char *)mmap(0, SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED && errno == ENODEV) {
+		printf("shared writable mappings not supported by file system\n");
+		CALL_AND_CHECK(ret, close(fd), ret == 0, "");
+		return;
+	}
+	if (addr == MAP_FAILED) {
+		printf("shared writable mmap failed, errno=%d\n", errno);
+		throw Test_failed();
+	}
+
+	/* modifications via the mapping and via the file are visible to each other */
+	memset(addr + PAGE, 'x', PAGE);
+	CALL_AND_CHECK(count, pwrite(fd, "yyyy", 4, 2*PAGE), count == 4, "");
+	if (memcmp(addr + 2*PAGE, "yyyy", 4) != 0) {
+		printf("write to file not visible in mapping\n");
+		throw Test_failed();
+	}
+	CALL_AND_CHECK(count, pread(fd, buf, PAGE, PAGE), count == PAGE, "");
+	for (unsigned i = 0; i < PAGE; i++)
+		if (buf[i] != 'x') {
+			printf("modification of mapping not visible in file\n");
+			throw Test_failed();
+		}
+
+	CALL_AND_CHECK(ret, msync(addr, SIZE, MS_SYNC), ret == 0, "");
+	CALL_AND_CHECK(ret, munmap(addr, SIZE), ret == 0, "");
+	CALL_AND_CHECK(ret, close(fd), ret == 0, "");
+
+	/* modifications persist after unmapping */
+	CALL_AND_CHECK(fd, open(file_name, O_RDONLY), fd >= 0, "file_name=%s", file_name);
+	CALL_AND_CHECK(count, pread(fd, buf, PAGE, PAGE), count == PAGE, "");
+	for (unsigned i = 0; i < PAGE; i++)
+		if (buf[i] != 'x') {
+			printf("modification of mapping lost after munmap\n");
+			throw Test_failed();
+		}
+
+	/* shared writable mappings require a file opened for writing */
+	addr = (char *)mmap(0, SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (addr != MAP_FAILED || errno != EACCES) {
+		printf("shared writable mapping of read-only file descriptor\n");
+		throw Test_failed();
+	}
+	CALL_AND_CHECK(ret, close(fd), ret == 0, "");
+
+	printf("mmap test succeeded\n");
+}
+
+
 static void test(Genode::Xml_node node)
 {
 	int ret, fd;
@@ -314,6 +462,8 @@ struct Main
 		Libc::with_libc([&] () {
 
 			test(config_rom.xml());
+			test_large_dir();
+			test_mmap();
 			test_write_read(config_rom.xml());
 
 			printf("test finished\n");
@@ -0,0 +1,170 @@
+/*
+ * \brief  Multi-threaded malloc benchmark
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * Each thread keeps a window of live allocations of random sizes and
+ * replaces a random one in each step, which mixes allocations and
+ * deallocations like a typical application. A second phase grows buffers
+ * via 'realloc' in small steps. The benchmark runs with an increasing
+ * number of threads to show how malloc scales.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+enum {
+	MAX_THREADS    = 8,
+	WINDOW         = 512,
+	OPS_PER_THREAD = 200000,
+	REALLOC_ROUNDS = 20,
+	REALLOC_MAX    = 256*1024,
+	REALLOC_STEP   = 64,
+};
+
+
+/* signalled by each thread when done, 'pthread_join' is not implemented */
+static sem_t finished_sem;
+
+
+static unsigned long now_ms()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000UL + ts.tv_nsec/1000000UL;
+}
+
+
+/**
+ * Linear congruential generator, one per thread
+ */
+struct Random
+{
+	unsigned long state;
+
+	unsigned operator () ()
+	{
+		state = state*6364136223846793005UL + 1442695040888963407UL;
+		return state >> 33;
+	}
+};
+
+
+/**
+ * Return allocation size, mostly small with a tail of larger sizes
+ */
+static size_t random_size(Random &random)
+{
+	unsigned const r = random();
+
+	switch (r % 16) {
+	case 15: return 1 + r % 16384;
+	case 14:
+	case 13: return 1 + r % 2048;
+	default: return 1 + r % 256;
+	}
+}
+
+
+static void *alloc_free_thread(void *arg)
+{
+	Random random { (unsigned long)arg };
+
+	void *window[WINDOW] { };
+
+	for (unsigned i = 0; i < OPS_PER_THREAD; i++) {
+
+		unsigned const slot = random() % WINDOW;
+
+		free(window[slot]);
+
+		size_t const size = random_size(random);
+		window[slot] = malloc(size);
+		if (!window[slot]) {
+			printf("Error: malloc of %zu bytes failed\n", size);
+			exit(-1);
+		}
+
+		/* touch the allocation like an application would */
+		*(char *)window[slot] = 1;
+	}
+
+	for (unsigned i = 0; i < WINDOW; i++)
+		free(window[i]);
+
+	sem_post(&finished_sem);
+	return nullptr;
+}
+
+
+static void *realloc_thread(void *)
+{
+	for (unsigned round = 0; round < REALLOC_ROUNDS; round++) {
+
+		char *buf = nullptr;
+
+		for (size_t size = REALLOC_STEP; size <= REALLOC_MAX; size += REALLOC_STEP) {
+			buf = (char *)realloc(buf, size);
+			if (!buf) {
+				printf("Error: realloc to %zu bytes failed\n", size);
+				exit(-1);
+			}
+			buf[size - 1] = 1;
+		}
+		free(buf);
+	}
+	sem_post(&finished_sem);
+	return nullptr;
+}
+
+
+static void run(char const *name, void *(*fn)(void *), unsigned num_threads,
+                unsigned long ops)
+{
+	pthread_t threads[MAX_THREADS];
+
+	unsigned long const start = now_ms();
+
+	for (unsigned i = 0; i < num_threads; i++)
+		if (pthread_create(&threads[i], 0, fn, (void *)(unsigned long)(i + 1)) != 0) {
+			printf("Error: could not create thread\n");
+			exit(-1);
+		}
+
+	for (unsigned i = 0; i < num_threads; i++)
+		sem_wait(&finished_sem);
+
+	unsigned long const ms = now_ms() - start;
+
+	printf("%s: %u threads: %lu ops in %lu ms (%lu ops/ms)\n",
+	       name, num_threads, ops*num_threads, ms,
+	       ms ? (ops*num_threads)/ms : 0);
+}
+
+
+int main(int, char **)
+{
+	sem_init(&finished_sem, 0, 0);
+
+	for (unsigned n = 1; n <= MAX_THREADS; n *= 2)
+		run("malloc/free", alloc_free_thread, n, OPS_PER_THREAD);
+
+	for (unsigned n = 1; n <= MAX_THREADS; n *= 2)
+		run("realloc", realloc_thread, n,
+		    REALLOC_ROUNDS*(REALLOC_MAX/REALLOC_STEP));
+
+	printf("--- malloc benchmark finished ---\n");
+	return 0;
+}
@@ -15,6 +15,7 @@
 #include <semaphore.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 
 enum { NUM_THREADS = 2 };
@@ -54,6 +55,178 @@ void *thread_func(void *arg)
 
 void *thread_func_self_destruct(void *arg) { return 0; }
 
+
+/*
+ * Thread-specific data
+ */
+
+static pthread_key_t tsd_key;
+static pthread_key_t tsd_recursive_key;
+
+static sem_t tsd_destructed_sem;
+static int   tsd_destructor_calls;
+static int   tsd_recursive_calls;
+
+
+static void tsd_destructor(void *value)
+{
+	__sync_fetch_and_add(&tsd_destructor_calls, 1);
+	free(value);
+}
+
+
+/**
+ * Destructor that sets its value again a few times
+ */
+static void tsd_recursive_destructor(void *value)
+{
+	if (__sync_add_and_fetch(&tsd_recursive_calls, 1) < 3)
+		pthread_setspecific(tsd_recursive_key, value);
+	else
+		sem_post(&tsd_destructed_sem);
+}
+
+
+static void *thread_func_tsd(void *arg)
+{
+	int * const value = (int *)malloc(sizeof(int));
+	*value = (int)(long)arg;
+
+	if (pthread_getspecific(tsd_key) != 0) {
+		printf("error: pthread_getspecific() returned value of other thread\n");
+		exit(-1);
+	}
+
+	pthread_setspecific(tsd_key, value);
+	pthread_setspecific(tsd_recursive_key, value);
+
+	if (pthread_getspecific(tsd_key) != value) {
+		printf("error: pthread_getspecific() returned wrong value\n");
+		exit(-1);
+	}
+	return 0;
+}
+
+
+static void test_tsd()
+{
+	printf("main thread: testing thread-specific data\n");
+
+	if (pthread_key_create(&tsd_key, tsd_destructor) != 0 ||
+	    pthread_key_create(&tsd_recursive_key, tsd_recursive_destructor) != 0) {
+		printf("error: pthread_key_create() failed\n");
+		exit(-1);
+	}
+
+	static int main_value;
+	pthread_setspecific(tsd_key, &main_value);
+
+	sem_init(&tsd_destructed_sem, 0, 0);
+
+	pthread_t t;
+	pthread_create(&t, 0, thread_func_tsd, (void *)1L);
+	sem_wait(&tsd_destructed_sem);
+
+	if (pthread_getspecific(tsd_key) != &main_value) {
+		printf("error: value of main thread changed\n");
+		exit(-1);
+	}
+
+	if (tsd_destructor_calls != 1 || tsd_recursive_calls != 3) {
+		printf("error: destructors called %d/%d times, expected 1/3\n",
+		       tsd_destructor_calls, tsd_recursive_calls);
+		exit(-1);
+	}
+
+	/* values of a deleted key must not show up when the key is reused */
+	pthread_key_delete(tsd_key);
+	pthread_key_create(&tsd_key, 0);
+	if (pthread_getspecific(tsd_key) != 0) {
+		printf("error: reused key has a stale value\n");
+		exit(-1);
+	}
+	pthread_key_delete(tsd_key);
+	pthread_key_delete(tsd_recursive_key);
+
+	sem_destroy(&tsd_destructed_sem);
+}
+
+
+/*
+ * Benchmark of 'pthread_getspecific()' and 'pthread_setspecific()' executed
+ * by several threads at the same time
+ */
+
+enum { BENCH_THREADS = 4, BENCH_ROUNDS = 1000000 };
+
+static pthread_key_t bench_keys[4];
+static sem_t         bench_start_sem;
+static sem_t         bench_finished_sem;
+
+
+static unsigned long long now_us()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000000ULL + ts.tv_nsec/1000;
+}
+
+
+static void *thread_func_tsd_bench(void *)
+{
+	sem_wait(&bench_start_sem);
+
+	for (long i = 0; i < BENCH_ROUNDS; i++) {
+		pthread_key_t const key = bench_keys[i % 4];
+		pthread_setspecific(key, (void *)(i + 1));
+		if (pthread_getspecific(key) != (void *)(i + 1)) {
+			printf("error: pthread_getspecific() returned wrong value\n");
+			exit(-1);
+		}
+	}
+
+	sem_post(&bench_finished_sem);
+	return 0;
+}
+
+
+static void bench_tsd()
+{
+	for (pthread_key_t &key : bench_keys)
+		pthread_key_create(&key, 0);
+
+	sem_init(&bench_start_sem, 0, 0);
+	sem_init(&bench_finished_sem, 0, 0);
+
+	for (unsigned i = 0; i < BENCH_THREADS; i++) {
+		pthread_t t;
+		if (pthread_create(&t, 0, thread_func_tsd_bench, 0) != 0) {
+			printf("error: pthread_create() failed\n");
+			exit(-1);
+		}
+	}
+
+	unsigned long long const start = now_us();
+
+	for (unsigned i = 0; i < BENCH_THREADS; i++)
+		sem_post(&bench_start_sem);
+
+	for (unsigned i = 0; i < BENCH_THREADS; i++)
+		sem_wait(&bench_finished_sem);
+
+	unsigned long long const us = now_us() - start;
+
+	printf("main thread: %d threads did %d get/set pairs each in %llu us\n",
+	       BENCH_THREADS, BENCH_ROUNDS, us);
+
+	for (pthread_key_t key : bench_keys)
+		pthread_key_delete(key);
+
+	sem_destroy(&bench_start_sem);
+	sem_destroy(&bench_finished_sem);
+}
+
+
 static inline void compare_semaphore_values(int reported_value, int expected_value)
 {
     if (reported_value != expected_value) {
@@ -142,6 +315,9 @@ int main(int argc, char **argv)
 		}
 	}
 
+	test_tsd();
+	bench_tsd();
+
 	printf("--- returning from main ---\n");
 	return 0;
 }
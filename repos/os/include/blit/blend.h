@@ -0,0 +1,57 @@
+/*
+ * \brief  Interface for blending lines of pixels
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The functions are the line-wise counterparts of the 'mix' and 'avr'
+ * functions of the pixel types 'Pixel_rgb565' and 'Pixel_rgb888' and produce
+ * the same results. Depending on the CPU, they are implemented via SIMD
+ * instructions.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__BLIT__BLEND_H_
+#define _INCLUDE__BLIT__BLEND_H_
+
+/**
+ * Blend line of RGB565 pixels onto destination according to alpha values
+ *
+ * \param dst    destination pixels
+ * \param src    source pixels
+ * \param alpha  alpha value of each source pixel
+ * \param n      number of pixels
+ *
+ * Each destination pixel is replaced by 'Pixel_rgb565::mix(dst, src, alpha)'
+ * unless its alpha value is zero.
+ */
+extern "C" void blend_rgb565(void *dst, void const *src,
+                             unsigned char const *alpha, int n);
+
+/**
+ * Blend line of RGB888 pixels onto destination according to alpha values
+ *
+ * This is the counterpart of 'blend_rgb565' for 'Pixel_rgb888'.
+ */
+extern "C" void blend_rgb888(void *dst, void const *src,
+                             unsigned char const *alpha, int n);
+
+/**
+ * Mix line of RGB565 pixels 1:1 with a color
+ *
+ * \param dst  destination pixels
+ * \param src  source pixels
+ * \param mix  RGB565 value of mixing color
+ * \param n    number of pixels
+ *
+ * Each destination pixel is replaced by 'Pixel_rgb565::avr(mix, src)'.
+ */
+extern "C" void avr_rgb565(void *dst, void const *src,
+                           unsigned short mix, int n);
+
+#endif /* _INCLUDE__BLIT__BLEND_H_ */
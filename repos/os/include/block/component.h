@@ -69,15 +69,65 @@ class Block::Session_component : public Block::Session_component_base,
 {
 	private:
 
+		/**
+		 * Entry of the table of requests taken from the submit queue
+		 *
+		 * The table is a ring buffer in the order of arrival. Requests are
+		 * passed to the driver in this order unless they are held back by an
+		 * earlier request that accesses an overlapping range of blocks or by
+		 * a 'FLUSH' barrier.
+		 * Requests may be completed by the driver in any order. A completed
+		 * request leaves a gap in the ring until all earlier requests are
+		 * completed as well.
+		 */
+		struct Request
+		{
+			enum State { FREE, PENDING, IN_FLIGHT };
+
+			State             state  = FREE;
+			Packet_descriptor packet { };
+
+			bool modifies() const { return packet.modifies(); }
+
+			bool flush() const {
+				return packet.operation() == Packet_descriptor::FLUSH; }
+
+			bool same(Packet_descriptor const &p) const
+			{
+				return packet.offset()       == p.offset()
+				    && packet.size()         == p.size()
+				    && packet.operation()    == p.operation()
+				    && packet.block_number() == p.block_number()
+				    && packet.block_count()  == p.block_count();
+			}
+
+			bool overlaps(Request const &other) const
+			{
+				sector_t const start       = packet.block_number();
+				sector_t const end         = start + packet.block_count();
+				sector_t const other_start = other.packet.block_number();
+				sector_t const other_end   = other_start + other.packet.block_count();
+
+				return start < other_end && other_start < end;
+			}
+		};
+
+		enum { MAX_REQUESTS = 128 };
+
 		addr_t                            _rq_phys;
 		Signal_handler<Session_component> _sink_ack;
 		Signal_handler<Session_component> _sink_submit;
-		bool                              _req_queue_full;
-		bool                              _ack_queue_full;
-		Packet_descriptor                 _p_to_handle;
+		Request                           _requests[MAX_REQUESTS];
+		unsigned                          _head = 0;      /* oldest request     */
+		unsigned                          _tail = 0;      /* next free entry    */
+		unsigned                          _in_flight = 0; /* passed to driver   */
+		bool                              _processing = false;
+		bool                              _reprocess  = false;
 		unsigned                          _p_in_fly;
 		bool                              _writeable;
 
+		static unsigned _next(unsigned i) { return (i + 1) % MAX_REQUESTS; }
+
 		/**
 		 * Acknowledge a packet already handled
 		 */
@@ -98,59 +148,181 @@ class Block::Session_component : public Block::Session_component_base,
 			       < _driver.block_count(); }
 
 		/**
-		 * Handle a single request
+		 * Return true if an earlier request prevents passing 'i' to the driver
+		 *
+		 * Requests on overlapping blocks must retain their order if at least
+		 * one of them modifies the blocks. A 'FLUSH' request waits for all
+		 * earlier requests and holds back all later ones.
 		 */
-		void _handle_packet(Packet_descriptor packet)
+		bool _held_back(unsigned i) const
 		{
-			_p_to_handle = packet;
-			_p_to_handle.succeeded(false);
+			Request const &request = _requests[i];
 
-			/* ignore invalid packets */
-			if (!packet.size() || !_range_check(_p_to_handle)) {
-				_ack_packet(_p_to_handle);
-				return;
+			for (unsigned j = _head; j != i; j = _next(j)) {
+
+				Request const &earlier = _requests[j];
+
+				if (earlier.state == Request::FREE)
+					continue;
+
+				if (earlier.flush() || request.flush())
+					return true;
+
+				if ((earlier.modifies() || request.modifies())
+				 && earlier.overlaps(request))
+					return true;
 			}
+			return false;
+		}
+
+		/**
+		 * Return true if packet describes a request the session permits
+		 */
+		bool _valid(Packet_descriptor &packet)
+		{
+			if (packet.operation() == Packet_descriptor::FLUSH)
+				return true;
+
+			if (packet.payload() && !packet.size())
+				return false;
+
+			if (!_range_check(packet))
+				return false;
+
+			return _writeable || !packet.modifies();
+		}
+
+		/**
+		 * Pass request to the driver
+		 *
+		 * \return  false if the driver cannot take further requests
+		 */
+		bool _submit(Request &request)
+		{
+			Packet_descriptor &packet = request.packet;
+
+			/*
+			 * The driver may acknowledge the request from within the call,
+			 * which must find the request in flight.
+			 */
+			request.state = Request::IN_FLIGHT;
+			_in_flight++;
 
 			try {
-				switch (_p_to_handle.operation()) {
+				switch (packet.operation()) {
 
 				case Block::Packet_descriptor::READ:
 					if (_driver.dma_enabled())
 						_driver.read_dma(packet.block_number(),
 						                 packet.block_count(),
 						                 _rq_phys + packet.offset(),
-						                 _p_to_handle);
+						                 packet);
 					else
 						_driver.read(packet.block_number(),
 						             packet.block_count(),
 						             tx_sink()->packet_content(packet),
-						             _p_to_handle);
+						             packet);
 					break;
 
 				case Block::Packet_descriptor::WRITE:
-					if (!_writeable) {
-						_ack_packet(_p_to_handle);
-						break;
-					}
 					if (_driver.dma_enabled())
 						_driver.write_dma(packet.block_number(),
 						                  packet.block_count(),
 						                  _rq_phys + packet.offset(),
-						                  _p_to_handle);
+						                  packet);
 					else
 						_driver.write(packet.block_number(),
 						              packet.block_count(),
 						              tx_sink()->packet_content(packet),
-						              _p_to_handle);
+						              packet);
+					break;
+
+				case Block::Packet_descriptor::DISCARD:
+					_driver.discard(packet.block_number(),
+					                packet.block_count(), packet);
+					break;
+
+				case Block::Packet_descriptor::WRITE_ZEROES:
+					_driver.write_zeroes(packet.block_number(),
+					                     packet.block_count(), packet);
+					break;
+
+				case Block::Packet_descriptor::FLUSH:
+					_driver.flush(packet);
 					break;
 
 				default:
 					throw Driver::Io_error();
 				}
 			} catch (Driver::Request_congestion) {
-				_req_queue_full = true;
+				request.state = Request::PENDING;
+				_in_flight--;
+				return false;
 			} catch (Driver::Io_error) {
-				_ack_packet(_p_to_handle);
+				_complete(request, false);
+			}
+			return true;
+		}
+
+		/**
+		 * Remove request from the table and acknowledge it to the client
+		 */
+		void _complete(Request &request, bool success)
+		{
+			if (request.state == Request::IN_FLIGHT)
+				_in_flight--;
+
+			request.packet.succeeded(success);
+			request.state = Request::FREE;
+			_ack_packet(request.packet);
+
+			/* release the completed requests at the head of the ring */
+			while (_head != _tail && _requests[_head].state == Request::FREE)
+				_head = _next(_head);
+		}
+
+		/**
+		 * Take packets from the submit queue into the request table
+		 */
+		void _take_packets()
+		{
+			while (tx_sink()->packet_avail()
+			    && _p_in_fly < tx_sink()->ack_slots_free()
+			    && _next(_tail) != _head) {
+
+				Packet_descriptor packet = tx_sink()->get_packet();
+				_p_in_fly++;
+
+				packet.succeeded(false);
+
+				if (!_valid(packet)) {
+					_ack_packet(packet);
+					continue;
+				}
+
+				Request &request = _requests[_tail];
+				request.packet = packet;
+				request.state  = Request::PENDING;
+				_tail = _next(_tail);
+			}
+		}
+
+		/**
+		 * Pass pending requests to the driver as far as possible
+		 */
+		void _submit_requests()
+		{
+			for (unsigned i = _head; i != _tail; i = _next(i)) {
+
+				if (_in_flight >= _driver.request_slots())
+					return;
+
+				if (_requests[i].state != Request::PENDING || _held_back(i))
+					continue;
+
+				/* retry on the next signal if the driver is congested */
+				if (!_submit(_requests[i]))
+					return;
 			}
 		}
 
@@ -160,15 +332,22 @@ class Block::Session_component : public Block::Session_component_base,
 		void _signal()
 		{
 			/*
-			 * as long as more packets are available, and we're able to ack
-			 * them, and the driver's request queue isn't full,
-			 * direct the packet request to the driver backend
+			 * The driver may acknowledge requests while being called from
+			 * this method, which triggers another iteration instead of a
+			 * nested invocation.
 			 */
-			for (_ack_queue_full = (_p_in_fly >= tx_sink()->ack_slots_free());
-			     !_req_queue_full && !_ack_queue_full
-			     && tx_sink()->packet_avail();
-				 _ack_queue_full = (++_p_in_fly >= tx_sink()->ack_slots_free()))
-				_handle_packet(tx_sink()->get_packet());
+			if (_processing) {
+				_reprocess = true;
+				return;
+			}
+
+			_processing = true;
+			do {
+				_reprocess = false;
+				_take_packets();
+				_submit_requests();
+			} while (_reprocess);
+			_processing = false;
 		}
 
 	public:
@@ -190,7 +369,6 @@ class Block::Session_component : public Block::Session_component_base,
 		  _rq_phys(Dataspace_client(_rq_ds).phys_addr()),
 		  _sink_ack(ep, *this, &Session_component::_signal),
 		  _sink_submit(ep, *this, &Session_component::_signal),
-		  _req_queue_full(false),
 		  _p_in_fly(0),
 		  _writeable(writeable)
 		{
@@ -208,23 +386,25 @@ class Block::Session_component : public Block::Session_component_base,
 		 * \param packet   the packet to acknowledge
 		 * \param success  indicated whether the processing was successful
 		 *
-		 * \throw Ack_congestion
+		 * The driver may acknowledge the requests passed to it in any order.
 		 */
 		void ack_packet(Packet_descriptor &packet, bool success)
 		{
-			packet.succeeded(success);
-			_ack_packet(packet);
+			bool found = false;
+			for (unsigned i = _head; i != _tail && !found; i = _next(i)) {
 
-			if (!_req_queue_full && !_ack_queue_full)
-				return;
+				Request &request = _requests[i];
+				if (request.state != Request::IN_FLIGHT || !request.same(packet))
+					continue;
 
-			/*
-			 * when the driver's request queue was full,
-			 * handle last unprocessed packet taken out of submit queue
-			 */
-			if (_req_queue_full) {
-				_req_queue_full = false;
-				_handle_packet(_p_to_handle);
+				_complete(request, success);
+				found = true;
+			}
+
+			if (!found) {
+				warning("driver acknowledged unknown request");
+				packet.succeeded(success);
+				_ack_packet(packet);
 			}
 
 			/* resume packet processing */
@@ -251,7 +431,13 @@ class Block::Session_component : public Block::Session_component_base,
 				ops->set_operation(Opcode::READ);
 			if (_writeable && driver_ops.supported(Opcode::WRITE))
 				ops->set_operation(Opcode::WRITE);
+			if (_writeable && driver_ops.supported(Opcode::DISCARD))
+				ops->set_operation(Opcode::DISCARD);
+			if (_writeable && driver_ops.supported(Opcode::WRITE_ZEROES))
+				ops->set_operation(Opcode::WRITE_ZEROES);
 
+			/* supported by all drivers via 'Driver::sync' */
+			ops->set_operation(Opcode::FLUSH);
 		}
 
 		void sync() { _driver.sync(); }
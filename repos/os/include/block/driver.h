@@ -193,6 +193,68 @@ class Block::Driver
 		                       Packet_descriptor &packet) {
 			throw Io_error(); }
 
+		/**
+		 * Discard blocks of medium
+		 *
+		 * \param block_number  number of first block to discard
+		 * \param block_count   number of blocks to discard
+		 * \param packet        packet descriptor from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * Note: should be overridden by devices that support the
+		 *       'DISCARD' operation
+		 */
+		virtual void discard(sector_t           block_number,
+		                     Genode::size_t     block_count,
+		                     Packet_descriptor &packet) {
+			throw Io_error(); }
+
+		/**
+		 * Set blocks of medium to zero
+		 *
+		 * \param block_number  number of first block to clear
+		 * \param block_count   number of blocks to clear
+		 * \param packet        packet descriptor from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * Note: should be overridden by devices that support the
+		 *       'WRITE_ZEROES' operation
+		 */
+		virtual void write_zeroes(sector_t           block_number,
+		                          Genode::size_t     block_count,
+		                          Packet_descriptor &packet) {
+			throw Io_error(); }
+
+		/**
+		 * Make the effects of all completed requests persistent
+		 *
+		 * \param packet  packet descriptor from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * The session component passes a 'FLUSH' request to the driver
+		 * only after all earlier requests are acknowledged. By default,
+		 * the request is completed synchronously via 'sync'. Drivers with
+		 * an asynchronous cache flush should override this method.
+		 */
+		virtual void flush(Packet_descriptor &packet)
+		{
+			sync();
+			ack_packet(packet);
+		}
+
+		/**
+		 * Return number of requests the driver can process concurrently
+		 *
+		 * The session component passes up to this number of requests to the
+		 * driver before the first one is acknowledged. The driver may
+		 * acknowledge them in any order. Requests beyond the limit of the
+		 * device can still be rejected via 'Request_congestion'.
+		 */
+		virtual unsigned request_slots() { return ~0U; }
+
 		/**
 		 * Check if DMA is enabled for driver
 		 *
@@ -36,12 +36,20 @@ namespace Block {
  * The data associated with the 'Packet_descriptor' is either
  * the data read from or written to the block indicated by
  * its number.
+ *
+ * The operations 'DISCARD', 'WRITE_ZEROES', and 'FLUSH' carry no payload.
+ * Packets for these operations need not be allocated from the bulk buffer
+ * but may be created with an offset and size of zero. 'DISCARD' marks the
+ * blocks as unused so that their content becomes undefined. 'WRITE_ZEROES'
+ * sets the content of the blocks to zero. 'FLUSH' ignores the block range.
+ * It is processed after all requests submitted before, and makes their
+ * effects persistent before any request submitted after it is processed.
  */
 class Block::Packet_descriptor : public Genode::Packet_descriptor
 {
 	public:
 
-		enum Opcode    { READ, WRITE, END };
+		enum Opcode    { READ, WRITE, DISCARD, WRITE_ZEROES, FLUSH, END };
 		enum Alignment { PACKET_ALIGNMENT = 11 };
 
 	private:
@@ -78,6 +86,17 @@ class Block::Packet_descriptor : public Genode::Packet_descriptor
 		Genode::size_t block_count()  const { return _block_count;  }
 		bool           succeeded()    const { return _success;      }
 
+		/**
+		 * Return true if the operation transfers data via the bulk buffer
+		 */
+		bool payload() const { return _op == READ || _op == WRITE; }
+
+		/**
+		 * Return true if the operation changes the content of blocks
+		 */
+		bool modifies() const {
+			return _op == WRITE || _op == DISCARD || _op == WRITE_ZEROES; }
+
 		void succeeded(bool b) { _success = b ? 1 : 0; }
 };
 
@@ -241,6 +241,13 @@ struct File_system::Control { /* to manipulate the executable bit */ };
 
 /**
  * Data structure returned when reading from a directory node
+ *
+ * The content of a directory node is an array of directory entries. The
+ * position of a READ packet must be aligned to the entry size. A server
+ * fills the packet with as many entries as fit into its length, so a
+ * client can list a directory in batches of entries. A packet with fewer
+ * entries than requested does not denote the end of the directory, only an
+ * empty one does.
  */
 struct File_system::Directory_entry
 {
@@ -203,6 +203,62 @@ class Net::Ipv4_packet
 		void dst(Ipv4_address v)                 { v.copy(&_dst); }
 
 
+		/*************************************
+		 ** Incremental checksum adaptation **
+		 *************************************/
+
+		/**
+		 * Adapt internet checksum to the change of one 16-bit word
+		 *
+		 * Implements equation 3 of RFC 1624, 'HC' = ~(~HC + ~m + m')'. All
+		 * values are in host byte order.
+		 */
+		static Genode::uint16_t adapt_checksum(Genode::uint16_t checksum,
+		                                       Genode::uint16_t old_word,
+		                                       Genode::uint16_t new_word)
+		{
+			Genode::uint32_t sum = (Genode::uint16_t)~checksum
+			                     + (Genode::uint16_t)~old_word + new_word;
+
+			sum = (sum & 0xffff) + (sum >> 16);
+			sum = (sum & 0xffff) + (sum >> 16);
+			return (Genode::uint16_t)~sum;
+		}
+
+		/**
+		 * Adapt internet checksum to the change of an IPv4 address it covers
+		 */
+		static Genode::uint16_t adapt_checksum(Genode::uint16_t    checksum,
+		                                       Ipv4_address const &old_ip,
+		                                       Ipv4_address const &new_ip)
+		{
+			for (unsigned i = 0; i < ADDR_LEN; i += 2) {
+				checksum = adapt_checksum(
+					checksum, old_ip.addr[i] << 8 | old_ip.addr[i + 1],
+					          new_ip.addr[i] << 8 | new_ip.addr[i + 1]);
+			}
+			return checksum;
+		}
+
+		/**
+		 * Set source address and adapt the header checksum incrementally
+		 */
+		void src_adapt_checksum(Ipv4_address v)
+		{
+			checksum(adapt_checksum(checksum(), src(), v));
+			src(v);
+		}
+
+		/**
+		 * Set destination address and adapt the header checksum incrementally
+		 */
+		void dst_adapt_checksum(Ipv4_address v)
+		{
+			checksum(adapt_checksum(checksum(), dst(), v));
+			dst(v);
+		}
+
+
 		/***************
 		 ** Operators **
 		 ***************/
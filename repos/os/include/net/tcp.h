@@ -104,6 +104,38 @@ class Net::Tcp_packet
 		void dst_port(Port p) { _dst_port = host_to_big_endian(p.value); }
 
 
+		/*************************************
+		 ** Incremental checksum adaptation **
+		 *************************************/
+
+		/**
+		 * Adapt checksum to the change of an address of the pseudo header
+		 *
+		 * Must be called whenever the source or destination address of the
+		 * surrounding IPv4 packet changes.
+		 */
+		void adapt_checksum(Ipv4_address const &old_ip,
+		                    Ipv4_address const &new_ip)
+		{
+			_checksum = host_to_big_endian(
+				Ipv4_packet::adapt_checksum(checksum(), old_ip, new_ip));
+		}
+
+		void src_port_adapt_checksum(Port p)
+		{
+			_checksum = host_to_big_endian(
+				Ipv4_packet::adapt_checksum(checksum(), src_port().value, p.value));
+			src_port(p);
+		}
+
+		void dst_port_adapt_checksum(Port p)
+		{
+			_checksum = host_to_big_endian(
+				Ipv4_packet::adapt_checksum(checksum(), dst_port().value, p.value));
+			dst_port(p);
+		}
+
+
 		/**
 		 * TCP checksum is calculated over the tcp datagram + an IPv4
 		 * pseudo header.
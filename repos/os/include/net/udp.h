@@ -49,6 +49,25 @@ class Net::Udp_packet
 		Genode::uint16_t _checksum;
 		unsigned         _data[0];
 
+		/**
+		 * Adapt checksum to the change of one 16-bit word of the datagram
+		 *
+		 * A checksum of zero means that the sender did not compute a checksum,
+		 * which stays that way. A computed checksum of zero is transmitted as
+		 * all ones (RFC 768).
+		 */
+		void _adapt_checksum(Genode::uint16_t old_word,
+		                     Genode::uint16_t new_word)
+		{
+			if (!_checksum)
+				return;
+
+			Genode::uint16_t const sum =
+				Ipv4_packet::adapt_checksum(checksum(), old_word, new_word);
+
+			_checksum = host_to_big_endian((Genode::uint16_t)(sum ? sum : 0xffff));
+		}
+
 	public:
 
 		/**
@@ -84,6 +103,38 @@ class Net::Udp_packet
 		void dst_port(Port p)           { _dst_port = host_to_big_endian(p.value); }
 
 
+		/*************************************
+		 ** Incremental checksum adaptation **
+		 *************************************/
+
+		/**
+		 * Adapt checksum to the change of an address of the pseudo header
+		 *
+		 * Must be called whenever the source or destination address of the
+		 * surrounding IPv4 packet changes.
+		 */
+		void adapt_checksum(Ipv4_address const &old_ip,
+		                    Ipv4_address const &new_ip)
+		{
+			for (unsigned i = 0; i < Ipv4_packet::ADDR_LEN; i += 2) {
+				_adapt_checksum(old_ip.addr[i] << 8 | old_ip.addr[i + 1],
+				                new_ip.addr[i] << 8 | new_ip.addr[i + 1]);
+			}
+		}
+
+		void src_port_adapt_checksum(Port p)
+		{
+			_adapt_checksum(src_port().value, p.value);
+			src_port(p);
+		}
+
+		void dst_port_adapt_checksum(Port p)
+		{
+			_adapt_checksum(dst_port().value, p.value);
+			dst_port(p);
+		}
+
+
 		/***************
 		 ** Operators **
 		 ***************/
@@ -15,7 +15,10 @@
 #define _INCLUDE__NITPICKER_GFX__TEXTURE_PAINTER_H_
 
 #include <blit/blit.h>
+#include <blit/blend.h>
 #include <os/texture.h>
+#include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
 
 
 struct Texture_painter
@@ -43,6 +46,45 @@ struct Texture_painter
 	typedef Genode::Surface_base::Rect  Rect;
 
 
+	/*
+	 * Line-wise blending operations
+	 *
+	 * The generic versions are overloaded for the pixel formats supported by
+	 * the vectorized blending functions of the blit library.
+	 */
+
+	template <typename PT>
+	static inline void _mix_line(PT *dst, PT const *src,
+	                             unsigned char const *alpha, int w)
+	{
+		for (; w--; src++, dst++, alpha++)
+			if (*alpha)
+				*dst = PT::mix(*dst, *src, *alpha);
+	}
+
+	static inline void _mix_line(Genode::Pixel_rgb565 *dst,
+	                             Genode::Pixel_rgb565 const *src,
+	                             unsigned char const *alpha, int w) {
+		blend_rgb565(dst, src, alpha, w); }
+
+	static inline void _mix_line(Genode::Pixel_rgb888 *dst,
+	                             Genode::Pixel_rgb888 const *src,
+	                             unsigned char const *alpha, int w) {
+		blend_rgb888(dst, src, alpha, w); }
+
+	template <typename PT>
+	static inline void _avr_line(PT *dst, PT const *src, PT mix_pixel, int w)
+	{
+		for (; w--; src++, dst++)
+			*dst = PT::avr(mix_pixel, *src);
+	}
+
+	static inline void _avr_line(Genode::Pixel_rgb565 *dst,
+	                             Genode::Pixel_rgb565 const *src,
+	                             Genode::Pixel_rgb565 mix_pixel, int w) {
+		avr_rgb565(dst, src, mix_pixel.pixel, w); }
+
+
 	template <typename PT>
 	static inline void paint(Genode::Surface<PT>       &surface,
 	                         Genode::Texture<PT> const &texture,
@@ -75,9 +117,8 @@ struct Texture_painter
 		PT const mix_pixel(mix_color.r, mix_color.g, mix_color.b);
 
 		int i, j;
-		PT            const *s;
-		PT                  *d;
-		unsigned char const *a;
+		PT const *s;
+		PT       *d;
 
 		switch (mode) {
 
@@ -98,16 +139,13 @@ struct Texture_painter
 			 * Copy texture with alpha blending
 			 */
 			for (j = clipped.h(); j--; src += src_w, alpha += src_w, dst += dst_w)
-				for (i = clipped.w(), s = src, a = alpha, d = dst; i--; s++, d++, a++)
-					if (*a)
-						*d = PT::mix(*d, *s, *a);
+				_mix_line(dst, src, alpha, clipped.w());
 			break;
 
 		case MIXED:
-	
+
 			for (j = clipped.h(); j--; src += src_w, dst += dst_w)
-				for (i = clipped.w(), s = src, d = dst; i--; s++, d++)
-					*d = PT::avr(mix_pixel, *s);
+				_avr_line(dst, src, mix_pixel, clipped.w());
 			break;
 
 		case MASKED:
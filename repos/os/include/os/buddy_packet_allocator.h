@@ -0,0 +1,306 @@
+/*
+ * \brief  Size-class allocator for packet streams
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__OS__BUDDY_PACKET_ALLOCATOR_H_
+#define _INCLUDE__OS__BUDDY_PACKET_ALLOCATOR_H_
+
+#include <base/allocator.h>
+#include <base/stdint.h>
+#include <util/misc_math.h>
+#include <util/string.h>
+
+namespace Genode { class Buddy_packet_allocator; }
+
+
+/**
+ * Packet allocator with per-size-class free lists
+ *
+ * In contrast to 'Packet_allocator', which scans a bit array for each
+ * allocation, this allocator keeps one free list per power-of-two size class
+ * of blocks (buddy system). An allocation takes the head of the smallest
+ * non-empty class that fits, found via a find-first-set over the bit mask of
+ * non-empty classes, and splits it. The unused tail of the block is returned
+ * to the smaller classes right away, so that packets of arbitrary sizes,
+ * e.g., small acknowledgements and full-sized frames, share the bulk buffer
+ * at the granularity of the block size. Freeing a packet coalesces its blocks
+ * with their free buddies. Both operations are bounded by the number of size
+ * classes and thereby independent of the buffer fill level.
+ *
+ * The block size must be a power of two. Packets are aligned to their
+ * size class relative to address 0, which satisfies alignment requests of
+ * up to the size of the class of the packet.
+ */
+class Genode::Buddy_packet_allocator : public Genode::Range_allocator
+{
+	private:
+
+		enum {
+			MAX_ORDER = 24,           /* largest size class, in log2 blocks */
+			INVALID   = ~(uint32_t)0, /* end of free list                  */
+			NOT_FREE  = 0xff,         /* block is not head of a free block */
+		};
+
+		Allocator &_md_alloc;
+
+		unsigned const _block_size_log2;
+
+		addr_t _base  = 0; /* allocation base                       */
+		addr_t _first = 0; /* absolute index of the first block     */
+		size_t _num   = 0; /* number of managed blocks              */
+		size_t _avail = 0; /* number of free blocks                 */
+		void  *_md    = nullptr;
+
+		uint32_t *_next  = nullptr; /* free-list links, indexed by block */
+		uint32_t *_prev  = nullptr;
+		uint8_t  *_order = nullptr; /* size class of free-block heads    */
+
+		uint32_t _head[MAX_ORDER + 1];
+		uint32_t _nonempty = 0; /* bit mask of non-empty size classes */
+
+		size_t _md_size() const {
+			return _num*(2*sizeof(uint32_t) + sizeof(uint8_t)); }
+
+		size_t _block_cnt(size_t size) const {
+			return (size + (1UL << _block_size_log2) - 1) >> _block_size_log2; }
+
+		static unsigned _order_of(size_t cnt)
+		{
+			unsigned order = 0;
+			while ((1UL << order) < cnt)
+				order++;
+			return order;
+		}
+
+		void _push(uint32_t i, unsigned order)
+		{
+			_order[i] = order;
+			_prev[i]  = INVALID;
+			_next[i]  = _head[order];
+
+			if (_head[order] != INVALID)
+				_prev[_head[order]] = i;
+
+			_head[order] = i;
+			_nonempty   |= 1U << order;
+		}
+
+		void _remove(uint32_t i)
+		{
+			unsigned const order = _order[i];
+
+			if (_next[i] != INVALID) _prev[_next[i]] = _prev[i];
+
+			if (_prev[i] != INVALID)
+				_next[_prev[i]] = _next[i];
+			else
+				_head[order] = _next[i];
+
+			if (_head[order] == INVALID)
+				_nonempty &= ~(1U << order);
+
+			_order[i] = NOT_FREE;
+		}
+
+		/**
+		 * Put free block of size class 'order' into the free lists
+		 *
+		 * The block is merged with its buddy as long as the buddy is free.
+		 */
+		void _release(uint32_t i, unsigned order)
+		{
+			for (; order < MAX_ORDER; order++) {
+
+				addr_t const buddy = (_first + i) ^ (1UL << order);
+
+				if (buddy < _first || buddy + (1UL << order) > _first + _num)
+					break;
+
+				uint32_t const b = buddy - _first;
+				if (_order[b] != order)
+					break;
+
+				_remove(b);
+				i = min(i, b);
+			}
+			_push(i, order);
+		}
+
+		/**
+		 * Release range of blocks as naturally aligned buddy blocks
+		 */
+		void _release_range(uint32_t i, size_t cnt)
+		{
+			uint32_t const end = i + cnt;
+
+			while (i < end) {
+
+				unsigned order = 0;
+				while (order < MAX_ORDER
+				    && !((_first + i) & (1UL << order))
+				    && i + (2UL << order) <= end)
+					order++;
+
+				_release(i, order);
+				i += 1UL << order;
+			}
+			_avail += cnt;
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param md_alloc         meta-data allocator
+		 * \param block_size_log2  log2 of the allocation granularity
+		 */
+		Buddy_packet_allocator(Allocator &md_alloc, unsigned block_size_log2)
+		:
+			_md_alloc(md_alloc), _block_size_log2(block_size_log2)
+		{
+			for (unsigned i = 0; i <= MAX_ORDER; i++)
+				_head[i] = INVALID;
+		}
+
+		~Buddy_packet_allocator()
+		{
+			if (_md)
+				_md_alloc.free(_md, _md_size());
+		}
+
+		/**
+		 * Return number of bytes that are unused within the managed range
+		 */
+		size_t avail() const override { return _avail << _block_size_log2; }
+
+
+		/*******************************
+		 ** Range-allocator interface **
+		 *******************************/
+
+		int add_range(addr_t base, size_t size) override
+		{
+			if (_md) return -1;
+
+			/* manage whole blocks only */
+			addr_t const block_size = 1UL << _block_size_log2;
+			addr_t const first      = align_addr(base, _block_size_log2);
+			addr_t const end        = (base + size) & ~(block_size - 1);
+
+			if (end <= first || ((end - first) >> _block_size_log2) >= INVALID)
+				return -1;
+
+			_base  = base;
+			_first = first >> _block_size_log2;
+			_num   = (end - first) >> _block_size_log2;
+
+			if (!_md_alloc.alloc(_md_size(), &_md)) {
+				_md = nullptr;
+				return -1;
+			}
+
+			_next  = (uint32_t *)_md;
+			_prev  = _next + _num;
+			_order = (uint8_t *)(_prev + _num);
+			memset(_order, NOT_FREE, _num);
+
+			_release_range(0, _num);
+			return 0;
+		}
+
+		int remove_range(addr_t base, size_t) override
+		{
+			if (!_md || _base != base) return -1;
+
+			_md_alloc.free(_md, _md_size());
+			_md       = nullptr;
+			_num      = 0;
+			_avail    = 0;
+			_nonempty = 0;
+			for (unsigned i = 0; i <= MAX_ORDER; i++)
+				_head[i] = INVALID;
+			return 0;
+		}
+
+		Alloc_return alloc_aligned(size_t size, void **out_addr, int align,
+		                           addr_t, addr_t) override
+		{
+			size_t const cnt = _block_cnt(size);
+
+			unsigned order = _order_of(cnt);
+			if (align > (int)_block_size_log2)
+				order = max(order, (unsigned)align - _block_size_log2);
+
+			if (!cnt || order > MAX_ORDER)
+				return Alloc_return::RANGE_CONFLICT;
+
+			/* find smallest non-empty size class that fits */
+			uint32_t const candidates = _nonempty & ~((1U << order) - 1);
+			if (!candidates)
+				return Alloc_return::RANGE_CONFLICT;
+
+			unsigned       o = __builtin_ctz(candidates);
+			uint32_t const i = _head[o];
+			_remove(i);
+
+			/* split block down to the requested size class */
+			while (o > order) {
+				o--;
+				_push(i + (1U << o), o);
+			}
+
+			/* return unused tail of the block */
+			_avail -= 1UL << order;
+			if (cnt < (1UL << order))
+				_release_range(i + cnt, (1UL << order) - cnt);
+
+			*out_addr = (void *)((_first + i) << _block_size_log2);
+			return Alloc_return::OK;
+		}
+
+		bool alloc(size_t size, void **out_addr) override
+		{
+			return alloc_aligned(size, out_addr, 0, 0, ~0UL).ok();
+		}
+
+		void free(void *addr, size_t size) override
+		{
+			addr_t const index = (addr_t)addr >> _block_size_log2;
+			size_t const cnt   = _block_cnt(size);
+
+			if (index < _first || index + cnt > _first + _num)
+				return;
+
+			_release_range(index - _first, cnt);
+		}
+
+		bool valid_addr(addr_t addr) const override
+		{
+			addr_t const index = addr >> _block_size_log2;
+			return index >= _first && index < _first + _num;
+		}
+
+		bool   need_size_for_free() const override { return true; }
+		size_t overhead(size_t) const override { return 0; }
+
+
+		/*************
+		 ** Dummies **
+		 *************/
+
+		void free(void *) override { }
+		Alloc_return alloc_addr(size_t, addr_t) override {
+			return Alloc_return(Alloc_return::OUT_OF_METADATA); }
+};
+
+#endif /* _INCLUDE__OS__BUDDY_PACKET_ALLOCATOR_H_ */
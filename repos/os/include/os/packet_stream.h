@@ -61,6 +61,22 @@
  * acknowledge buffers using the methods 'packet_avail',
  * 'ready_to_submit', 'ready_to_ack', and 'ack_avail'.
  *
+ * To process bursts of packets, 'submit_packets', 'get_packets',
+ * 'acknowledge_packets', and 'get_acked_packets' transfer several packet
+ * descriptors at once. The descriptors of a burst are published to the peer
+ * at once and the peer is signalled at most once per burst.
+ *
+ * If each side of the stream is driven by a single thread only, the
+ * 'Spsc_packet_stream_policy' omits the local locking of the queues. It is
+ * compatible with the default policy regarding the shared-buffer layout.
+ *
+ * Each signal involves the kernel. A party that processes packets at a high
+ * rate can opt in to a 'Packet_stream_signal_moderation' policy via
+ * 'signal_moderation'. Signals to the peer are then deferred until a number
+ * of packets is pending or until the party calls 'wakeup'. The statistics
+ * returned by 'submit_signal_stats' and 'ack_signal_stats' show the number
+ * of delivered and suppressed signals.
+ *
  * If bidirectional data exchange between two processes is desired, two pairs
  * of 'Packet_stream_source' and 'Packet_stream_sink' should be instantiated.
  */
@@ -81,12 +97,18 @@
 #include <dataspace/client.h>
 #include <util/string.h>
 #include <util/construct_at.h>
+#include <base/lock_guard.h>
+#include <cpu/memory_barrier.h>
 
 namespace Genode {
 
 	class Packet_descriptor;
 
 	template <typename, int> class Packet_descriptor_queue;
+	template <typename, int> struct Spsc_packet_descriptor_queue;
+	struct Packet_stream_signal_moderation;
+	struct Packet_stream_signal_stats;
+
 	template <typename>      class Packet_descriptor_transmitter;
 	template <typename>      class Packet_descriptor_receiver;
 
@@ -95,6 +117,9 @@ namespace Genode {
 	template <typename, unsigned, unsigned, typename>
 	struct Packet_stream_policy;
 
+	template <typename, unsigned, unsigned, typename>
+	struct Spsc_packet_stream_policy;
+
 	/**
 	 * Default configuration for packet-descriptor queues
 	 */
@@ -150,6 +175,13 @@ class Genode::Packet_descriptor
  * Ring buffer shared between source and sink, containing packet descriptors
  *
  * This class is private to the packet-stream interface.
+ *
+ * The queue is driven by exactly one producer and one consumer that reside
+ * in different protection domains. The producer solely modifies '_head', the
+ * consumer solely modifies '_tail'. Each side publishes its index only after
+ * the corresponding descriptor slots have been written or read, and reads the
+ * index of its peer before accessing the slots. Hence, the queue does not
+ * need any lock to be consistent across both parties.
  */
 template <typename PACKET_DESCRIPTOR, int QUEUE_SIZE>
 class Genode::Packet_descriptor_queue
@@ -160,10 +192,56 @@ class Genode::Packet_descriptor_queue
 		unsigned          _tail;
 		PACKET_DESCRIPTOR _queue[QUEUE_SIZE];
 
+		/*
+		 * Access the indices via volatile pointers because they are
+		 * concurrently modified by the peer.
+		 */
+		unsigned _peer_head() const
+		{
+			unsigned const head = *(unsigned const volatile *)&_head;
+
+			/* acquire: read slots only after observing the index */
+			Genode::memory_barrier();
+			return head;
+		}
+
+		unsigned _peer_tail() const
+		{
+			unsigned const tail = *(unsigned const volatile *)&_tail;
+			Genode::memory_barrier();
+			return tail;
+		}
+
+		void _publish_head(unsigned head)
+		{
+			/* release: make slot content visible before the index */
+			Genode::memory_barrier();
+			*(unsigned volatile *)&_head = head;
+		}
+
+		void _publish_tail(unsigned tail)
+		{
+			Genode::memory_barrier();
+			*(unsigned volatile *)&_tail = tail;
+		}
+
+		static unsigned _used(unsigned head, unsigned tail) {
+			return (head + QUEUE_SIZE - tail)%QUEUE_SIZE; }
+
 	public:
 
 		typedef PACKET_DESCRIPTOR Packet_descriptor;
 
+		/**
+		 * Lock used to serialize threads of the same party
+		 *
+		 * The queue itself is safe for one producer and one consumer. If
+		 * several threads of one component operate on the same side of a
+		 * packet stream, the transmitter and receiver serialize them via
+		 * this lock.
+		 */
+		typedef Genode::Lock Local_lock;
+
 		enum Role { PRODUCER, CONSUMER };
 
 		/**
@@ -194,10 +272,32 @@ class Genode::Packet_descriptor_queue
 			if (full()) return false;
 
 			_queue[_head%QUEUE_SIZE] = packet;
-			_head = (_head + 1)%QUEUE_SIZE;
+			_publish_head((_head + 1)%QUEUE_SIZE);
 			return true;
 		}
 
+		/**
+		 * Place up to 'num' packet descriptors into queue
+		 *
+		 * All descriptors are published to the consumer at once.
+		 *
+		 * \return number of descriptors added, which is smaller than
+		 *         'num' if the queue became full
+		 */
+		unsigned add(PACKET_DESCRIPTOR const *packets, unsigned num)
+		{
+			unsigned const n    = Genode::min(num, slots_free());
+			unsigned       head = _head;
+
+			for (unsigned i = 0; i < n; i++, head = (head + 1)%QUEUE_SIZE)
+				_queue[head] = packets[i];
+
+			if (n)
+				_publish_head(head);
+
+			return n;
+		}
+
 		/**
 		 * Take packet descriptor from queue
 		 *
@@ -206,10 +306,32 @@ class Genode::Packet_descriptor_queue
 		PACKET_DESCRIPTOR get()
 		{
 			PACKET_DESCRIPTOR packet = _queue[_tail%QUEUE_SIZE];
-			_tail = (_tail + 1)%QUEUE_SIZE;
+			_publish_tail((_tail + 1)%QUEUE_SIZE);
 			return packet;
 		}
 
+		/**
+		 * Take up to 'max' packet descriptors from queue
+		 *
+		 * The slots of all taken descriptors are released to the producer at
+		 * once.
+		 *
+		 * \return number of descriptors written to 'packets'
+		 */
+		unsigned get(PACKET_DESCRIPTOR *packets, unsigned max)
+		{
+			unsigned const n    = Genode::min(max, used());
+			unsigned       tail = _tail;
+
+			for (unsigned i = 0; i < n; i++, tail = (tail + 1)%QUEUE_SIZE)
+				packets[i] = _queue[tail];
+
+			if (n)
+				_publish_tail(tail);
+
+			return n;
+		}
+
 		/**
 		 * Return current packet descriptor
 		 */
@@ -221,30 +343,100 @@ class Genode::Packet_descriptor_queue
 		/**
 		 * Return true if packet-descriptor queue is empty
 		 */
-		bool empty() { return _tail == _head; }
+		bool empty() { return _tail == _peer_head(); }
 
 		/**
 		 * Return true if packet-descriptor queue is full
 		 */
-		bool full() { return (_head + 1)%QUEUE_SIZE == _tail; }
+		bool full() { return (_head + 1)%QUEUE_SIZE == _peer_tail(); }
 
 		/**
 		 * Return true if a single element is stored in the queue
 		 */
-		bool single_element() { return (_tail + 1)%QUEUE_SIZE == _head; }
+		bool single_element() { return (_tail + 1)%QUEUE_SIZE == _peer_head(); }
 
 
 		/**
 		 * Return true if a single slot is left to be put into the queue
 		 */
-		bool single_slot_free() { return (_head + 2)%QUEUE_SIZE == _tail; }
+		bool single_slot_free() { return (_head + 2)%QUEUE_SIZE == _peer_tail(); }
 
 		/**
 		 * Return number of slots left to be put into the queue
 		 */
 		unsigned slots_free() {
-			return ((_tail > _head) ? _tail - _head
-			                        : QUEUE_SIZE - _head + _tail) - 1; }
+			return QUEUE_SIZE - 1 - _used(_head, _peer_tail()); }
+
+		/**
+		 * Return number of elements stored in the queue
+		 */
+		unsigned used() { return _used(_peer_head(), _tail); }
+};
+
+
+/**
+ * Packet-descriptor queue for a single thread per party
+ *
+ * The shared-memory layout is identical to 'Packet_descriptor_queue'. So a
+ * party using this queue type can communicate with a peer that uses the
+ * regular queue. In contrast to the latter, the transmitter and receiver
+ * do not take a lock per descriptor, which is only safe if the respective
+ * side of the packet stream is driven by a single thread.
+ */
+template <typename PACKET_DESCRIPTOR, int QUEUE_SIZE>
+struct Genode::Spsc_packet_descriptor_queue
+:
+	Packet_descriptor_queue<PACKET_DESCRIPTOR, QUEUE_SIZE>
+{
+	typedef Packet_descriptor_queue<PACKET_DESCRIPTOR, QUEUE_SIZE> Queue;
+
+	struct Local_lock
+	{
+		void lock()   { }
+		void unlock() { }
+	};
+
+	Spsc_packet_descriptor_queue(typename Queue::Role role) : Queue(role) { }
+};
+
+
+/**
+ * Policy for moderating the signals of a packet-stream party
+ *
+ * By default, each transition of a queue from empty to non-empty is
+ * signalled to the peer. With moderation enabled, the transmitting side
+ * defers the signal until 'packets' descriptors are pending. Packets that
+ * remain below this threshold are signalled by an explicit 'wakeup' call,
+ * which the component is expected to perform at the end of its processing
+ * or from a timeout to bound the latency.
+ *
+ * The receiving side checks the queue up to 'poll_budget' times before it
+ * blocks for a signal, which avoids the blocking if the peer is busy
+ * filling the queue.
+ */
+struct Genode::Packet_stream_signal_moderation
+{
+	unsigned packets     = 1;
+	unsigned poll_budget = 0;
+
+	Packet_stream_signal_moderation() { }
+
+	Packet_stream_signal_moderation(unsigned packets, unsigned poll_budget)
+	: packets(packets ? packets : 1), poll_budget(poll_budget) { }
+
+	bool enabled() const { return packets > 1; }
+};
+
+
+/**
+ * Signal statistics of a packet-stream party
+ */
+struct Genode::Packet_stream_signal_stats
+{
+	unsigned long submitted  = 0; /* signals delivered to the peer */
+	unsigned long suppressed = 0; /* signals saved by the moderation */
+	unsigned long poll_hits  = 0; /* blocking avoided by polling */
+	unsigned long blocked    = 0; /* waits for a signal of the peer */
 };
 
 
@@ -266,8 +458,69 @@ class Genode::Packet_descriptor_transmitter
 		/* facility to send ready-to-receive signals */
 		Genode::Signal_transmitter         _rx_ready;
 
-		Genode::Lock _tx_queue_lock;
-		TX_QUEUE    *_tx_queue;
+		typedef typename TX_QUEUE::Local_lock Local_lock;
+		typedef Genode::Lock_guard<Local_lock> Local_lock_guard;
+
+		Local_lock _tx_queue_lock;
+		TX_QUEUE  *_tx_queue;
+
+		Packet_stream_signal_moderation _moderation { };
+		Packet_stream_signal_stats      _stats      { };
+
+		/* number of transmitted packets not signalled yet */
+		unsigned _unsignalled = 0;
+
+		void _submit_rx_ready()
+		{
+			_rx_ready.submit();
+			_unsignalled = 0;
+			_stats.submitted++;
+		}
+
+		/**
+		 * Notify receiver about 'num' newly transmitted packets
+		 *
+		 * \param peer_may_block  true if the receiver may have observed an
+		 *                        empty queue
+		 */
+		void _notify_rx(unsigned num, bool peer_may_block)
+		{
+			if (!_moderation.enabled()) {
+				if (peer_may_block)
+					_submit_rx_ready();
+				return;
+			}
+
+			_unsignalled += num;
+
+			if (_unsignalled >= _moderation.packets) {
+				_submit_rx_ready();
+				return;
+			}
+
+			if (peer_may_block)
+				_stats.suppressed++;
+		}
+
+		void _wait_for_tx_ready()
+		{
+			/* never block while the receiver is not informed about packets */
+			if (_unsignalled)
+				_submit_rx_ready();
+
+			/* no blocking at stake if the queue has room already */
+			if (!_tx_queue->full())
+				return;
+
+			for (unsigned i = 0; i < _moderation.poll_budget; i++)
+				if (!_tx_queue->full()) {
+					_stats.poll_hits++;
+					return;
+				}
+
+			_stats.blocked++;
+			_tx_ready.wait_for_signal();
+		}
 
 	public:
 
@@ -300,23 +553,47 @@ class Genode::Packet_descriptor_transmitter
 			 * a signal has to be send again
 			 */
 			if (!_tx_queue->empty())
-				_rx_ready.submit();
+				_submit_rx_ready();
+		}
+
+		void moderation(Packet_stream_signal_moderation const &moderation)
+		{
+			Local_lock_guard lock_guard(_tx_queue_lock);
+
+			_moderation = moderation;
+
+			/* flush signal that may be pending from the previous policy */
+			if (_unsignalled)
+				_submit_rx_ready();
+		}
+
+		Packet_stream_signal_stats stats() const { return _stats; }
+
+		/**
+		 * Deliver deferred signal to the receiver
+		 */
+		void wakeup()
+		{
+			Local_lock_guard lock_guard(_tx_queue_lock);
+
+			if (_unsignalled)
+				_submit_rx_ready();
 		}
 
 		bool ready_for_tx()
 		{
-			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+			Local_lock_guard lock_guard(_tx_queue_lock);
 			return !_tx_queue->full();
 		}
 
 		void tx(typename TX_QUEUE::Packet_descriptor packet)
 		{
-			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+			Local_lock_guard lock_guard(_tx_queue_lock);
 
 			do {
 				/* block for signal if tx queue is full */
 				if (_tx_queue->full())
-					_tx_ready.wait_for_signal();
+					_wait_for_tx_ready();
 
 				/*
 				 * It could happen that pending signals do not refer to the
@@ -326,8 +603,41 @@ class Genode::Packet_descriptor_transmitter
 
 			} while (_tx_queue->add(packet) == false);
 
-			if (_tx_queue->single_element())
-				_rx_ready.submit();
+			_notify_rx(1, _tx_queue->single_element());
+		}
+
+		/**
+		 * Transmit a burst of packets
+		 *
+		 * The packets are published in as few steps as the free space of
+		 * the queue permits. The receiver is signalled at most once per
+		 * step, namely if it may have observed an empty queue. If the
+		 * queue is full, the method blocks until the receiver made
+		 * progress.
+		 */
+		void tx(typename TX_QUEUE::Packet_descriptor const *packets, unsigned num)
+		{
+			Local_lock_guard lock_guard(_tx_queue_lock);
+
+			while (num) {
+
+				/* block for signal if tx queue is full */
+				if (_tx_queue->full())
+					_wait_for_tx_ready();
+
+				unsigned const n = _tx_queue->add(packets, num);
+				if (!n)
+					continue;
+
+				packets += n;
+				num     -= n;
+
+				/*
+				 * If the receiver consumed all but our packets, it may be
+				 * about to block.
+				 */
+				_notify_rx(n, _tx_queue->used() <= n);
+			}
 		}
 
 		/**
@@ -355,8 +665,38 @@ class Genode::Packet_descriptor_receiver
 		/* facility to send ready-to-transmit signals */
 		Genode::Signal_transmitter        _tx_ready;
 
-		Genode::Lock mutable  _rx_queue_lock;
-		RX_QUEUE             *_rx_queue;
+		typedef typename RX_QUEUE::Local_lock Local_lock;
+		typedef Genode::Lock_guard<Local_lock> Local_lock_guard;
+
+		Local_lock mutable  _rx_queue_lock;
+		RX_QUEUE           *_rx_queue;
+
+		unsigned                   _poll_budget = 0;
+		Packet_stream_signal_stats _stats { };
+
+		void _submit_tx_ready()
+		{
+			_tx_ready.submit();
+			_stats.submitted++;
+		}
+
+		/**
+		 * Check for queue content up to the poll budget
+		 */
+		bool _poll()
+		{
+			/* count a hit only if the queue was empty on entry */
+			if (!_rx_queue->empty())
+				return true;
+
+			for (unsigned i = 0; i < _poll_budget; i++)
+				if (!_rx_queue->empty()) {
+					_stats.poll_hits++;
+					return true;
+				}
+
+			return !_rx_queue->empty();
+		}
 
 	public:
 
@@ -389,31 +729,66 @@ class Genode::Packet_descriptor_receiver
 			 * a signal has to be send again
 			 */
 			if (!_rx_queue->empty())
-				_tx_ready.submit();
+				_submit_tx_ready();
 		}
 
+		void poll_budget(unsigned poll_budget) { _poll_budget = poll_budget; }
+
+		Packet_stream_signal_stats stats() const { return _stats; }
+
 		bool ready_for_rx()
 		{
-			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+			Local_lock_guard lock_guard(_rx_queue_lock);
 			return !_rx_queue->empty();
 		}
 
+		/**
+		 * Return true if the queue becomes non-empty within the poll budget
+		 */
+		bool poll_for_rx()
+		{
+			Local_lock_guard lock_guard(_rx_queue_lock);
+			return _poll();
+		}
+
 		void rx(typename RX_QUEUE::Packet_descriptor *out_packet)
 		{
-			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+			Local_lock_guard lock_guard(_rx_queue_lock);
 
-			while (_rx_queue->empty())
+			while (!_poll()) {
+				_stats.blocked++;
 				_rx_ready.wait_for_signal();
+			}
 
 			*out_packet = _rx_queue->get();
 
 			if (_rx_queue->single_slot_free())
-				_tx_ready.submit();
+				_submit_tx_ready();
+		}
+
+		/**
+		 * Receive up to 'max' packets without blocking
+		 *
+		 * The transmitter is signalled at most once, namely if it may have
+		 * observed a full queue.
+		 *
+		 * \return number of packets written to 'out_packets'
+		 */
+		unsigned rx(typename RX_QUEUE::Packet_descriptor *out_packets, unsigned max)
+		{
+			Local_lock_guard lock_guard(_rx_queue_lock);
+
+			unsigned const n = _rx_queue->get(out_packets, max);
+
+			if (n && _rx_queue->slots_free() <= n)
+				_submit_tx_ready();
+
+			return n;
 		}
 
 		typename RX_QUEUE::Packet_descriptor rx_peek() const
 		{
-			Genode::Lock::Guard lock_guard(_rx_queue_lock);
+			Local_lock_guard lock_guard(_rx_queue_lock);
 			return _rx_queue->peek();
 		}
 };
@@ -527,6 +902,31 @@ struct Genode::Packet_stream_policy
 };
 
 
+/**
+ * Policy for a party that drives its side of the stream by a single thread
+ *
+ * The policy is compatible with 'Packet_stream_policy' with regard to the
+ * layout of the communication buffer. It merely omits the local locking of
+ * the packet-descriptor queues.
+ */
+template <typename PACKET_DESCRIPTOR,
+          unsigned SUBMIT_QUEUE_SIZE,
+          unsigned ACK_QUEUE_SIZE,
+          typename CONTENT_TYPE>
+struct Genode::Spsc_packet_stream_policy
+{
+	typedef CONTENT_TYPE Content_type;
+
+	typedef PACKET_DESCRIPTOR Packet_descriptor;
+
+	typedef Spsc_packet_descriptor_queue<PACKET_DESCRIPTOR, SUBMIT_QUEUE_SIZE>
+	        Submit_queue;
+
+	typedef Spsc_packet_descriptor_queue<PACKET_DESCRIPTOR, ACK_QUEUE_SIZE>
+	        Ack_queue;
+};
+
+
 /**
  * Originator of a packet stream
  */
@@ -635,6 +1035,37 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			return _ack_receiver.rx_ready_cap();
 		}
 
+		/**
+		 * Configure moderation of the packet-avail signals and polling
+		 * for acknowledgements
+		 *
+		 * With moderation enabled, the source must call 'wakeup' after
+		 * submitting a batch of packets.
+		 */
+		void signal_moderation(Packet_stream_signal_moderation const &moderation)
+		{
+			_submit_transmitter.moderation(moderation);
+			_ack_receiver.poll_budget(moderation.poll_budget);
+		}
+
+		/**
+		 * Deliver a packet-avail signal deferred by the moderation
+		 */
+		void wakeup() { _submit_transmitter.wakeup(); }
+
+		/**
+		 * Return statistics about the signals sent to the sink
+		 */
+		Packet_stream_signal_stats submit_signal_stats() const {
+			return _submit_transmitter.stats(); }
+
+		/**
+		 * Return statistics about the signals sent to the sink when
+		 * consuming acknowledgements
+		 */
+		Packet_stream_signal_stats ack_signal_stats() const {
+			return _ack_receiver.stats(); }
+
 		/**
 		 * Allocate packet
 		 *
@@ -689,11 +1120,29 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			_submit_transmitter.tx(packet);
 		}
 
+		/**
+		 * Tell sink about a burst of packets to process
+		 *
+		 * In contrast to calling 'submit_packet' for each packet, the sink
+		 * is signalled only once per burst. The method blocks as long as
+		 * the submit queue is full.
+		 */
+		void submit_packets(Packet_descriptor const *packets, unsigned num)
+		{
+			_submit_transmitter.tx(packets, num);
+		}
+
 		/**
 		 * Returns true if one or more packet acknowledgements are available
 		 */
 		bool ack_avail() { return _ack_receiver.ready_for_rx(); }
 
+		/**
+		 * Returns true if an acknowledgement becomes available within the
+		 * poll budget
+		 */
+		bool poll_ack_avail() { return _ack_receiver.poll_for_rx(); }
+
 		/**
 		 * Get acknowledged packet
 		 */
@@ -704,6 +1153,18 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get up to 'max' acknowledged packets
+		 *
+		 * This method does not block.
+		 *
+		 * \return number of packets written to 'packets'
+		 */
+		unsigned get_acked_packets(Packet_descriptor *packets, unsigned max)
+		{
+			return _ack_receiver.rx(packets, max);
+		}
+
 		/**
 		 * Release bulk-buffer space consumed by the packet
 		 */
@@ -795,11 +1256,48 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			return _submit_receiver.rx_ready_cap();
 		}
 
+		/**
+		 * Configure moderation of the ack-avail signals and polling for
+		 * submitted packets
+		 *
+		 * With moderation enabled, the sink must call 'wakeup' after
+		 * acknowledging a batch of packets.
+		 */
+		void signal_moderation(Packet_stream_signal_moderation const &moderation)
+		{
+			_ack_transmitter.moderation(moderation);
+			_submit_receiver.poll_budget(moderation.poll_budget);
+		}
+
+		/**
+		 * Deliver an ack-avail signal deferred by the moderation
+		 */
+		void wakeup() { _ack_transmitter.wakeup(); }
+
+		/**
+		 * Return statistics about the signals sent to the source when
+		 * acknowledging packets
+		 */
+		Packet_stream_signal_stats ack_signal_stats() const {
+			return _ack_transmitter.stats(); }
+
+		/**
+		 * Return statistics about the signals sent to the source when
+		 * consuming submitted packets
+		 */
+		Packet_stream_signal_stats submit_signal_stats() const {
+			return _submit_receiver.stats(); }
+
 		/**
 		 * Return true if a packet is available
 		 */
 		bool packet_avail() { return _submit_receiver.ready_for_rx(); }
 
+		/**
+		 * Return true if a packet becomes available within the poll budget
+		 */
+		bool poll_packet_avail() { return _submit_receiver.poll_for_rx(); }
+
 		/**
 		 * Check if packet descriptor refers to a range within the bulk buffer
 		 */
@@ -822,6 +1320,18 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get up to 'max' packets from source
+		 *
+		 * This method does not block.
+		 *
+		 * \return number of packets written to 'packets'
+		 */
+		unsigned get_packets(Packet_descriptor *packets, unsigned max)
+		{
+			return _submit_receiver.rx(packets, max);
+		}
+
 		/**
 		 * Return but do not dequeue next packet
 		 *
@@ -866,6 +1376,17 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			_ack_transmitter.tx(packet);
 		}
 
+		/**
+		 * Acknowledge a burst of packets
+		 *
+		 * The source is signalled only once per burst. The method blocks as
+		 * long as the acknowledgement queue is full.
+		 */
+		void acknowledge_packets(Packet_descriptor const *packets, unsigned num)
+		{
+			_ack_transmitter.tx(packets, num);
+		}
+
 		void debug_print_buffers() {
 			Packet_stream_base::_debug_print_buffers(); }
 
@@ -0,0 +1,319 @@
+/*
+ * \brief  Hashed index of the entries of an in-memory directory
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _INCLUDE__RAM_FS__DIRECTORY_INDEX_H_
+#define _INCLUDE__RAM_FS__DIRECTORY_INDEX_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <util/noncopyable.h>
+#include <util/string.h>
+
+namespace File_system {
+
+	using namespace Genode;
+
+	template <typename> class Directory_index;
+}
+
+
+/**
+ * Index of directory entries by name and by position
+ *
+ * \param T  node type, must inherit 'Directory_index<T>::Element' and
+ *           provide a 'name' method that returns the null-terminated name
+ *
+ * Entries are looked up by name via a hash table, which grows with the
+ * number of entries. The most recently looked-up entries are remembered
+ * per hash value, which makes the repeated lookup of the same path
+ * components cheap.
+ *
+ * The listing order is selected at construction time. With 'NEWEST_FIRST',
+ * a new entry is listed before all others. With 'BY_NAME', the entries are
+ * listed in alphabetical order. A directory is usually listed sequentially.
+ * So the lookup by position continues the walk through the entries from the
+ * position of the previous lookup.
+ *
+ * The name of an entry must not change while the entry is part of the
+ * index. To rename an entry, remove it, assign the new name, and insert it
+ * again.
+ */
+template <typename T>
+class File_system::Directory_index : Genode::Noncopyable
+{
+	public:
+
+		enum class Order { NEWEST_FIRST, BY_NAME };
+
+		class Element
+		{
+			private:
+
+				friend class Directory_index;
+
+				T            *_chain = nullptr;  /* next entry of bucket     */
+				T            *_prev  = nullptr;  /* neighbours in list order */
+				T            *_next  = nullptr;
+				unsigned long _hash  = 0;
+				unsigned long _seq   = 0;        /* insertion sequence number */
+		};
+
+	private:
+
+		enum { INITIAL_BUCKETS = 8, NUM_RECENT = 4 };
+
+		Genode::Allocator &_alloc;
+
+		Order const _order;
+
+		T      *_initial_buckets[INITIAL_BUCKETS] { };
+		T     **_buckets     = _initial_buckets;
+		size_t  _num_buckets = INITIAL_BUCKETS;
+		size_t  _count       = 0;
+
+		T            *_head = nullptr;
+		T            *_tail = nullptr;
+		unsigned long _seq  = 0;
+
+		/* position of the previous lookup by position */
+		T      *_cursor       = nullptr;
+		size_t  _cursor_index = 0;
+
+		T *_recent[NUM_RECENT] { };
+
+		static Element &_elem(T &node) { return node; }
+
+		/**
+		 * FNV-1a hash of the first 'len' characters of 'name'
+		 */
+		static unsigned long _hash(char const *name, size_t len)
+		{
+			unsigned long hash = 2166136261UL;
+			for (size_t i = 0; i < len && name[i]; i++)
+				hash = (hash ^ (unsigned char)name[i])*16777619UL;
+			return hash;
+		}
+
+		static bool _matches(T &node, char const *name, size_t len)
+		{
+			char const * const node_name = node.name();
+			return Genode::strcmp(node_name, name, len) == 0
+			    && node_name[len] == 0;
+		}
+
+		/**
+		 * Return true if 'a' is listed before 'b'
+		 */
+		bool _precedes(T &a, T &b) const
+		{
+			if (_order == Order::BY_NAME)
+				return Genode::strcmp(a.name(), b.name()) < 0;
+
+			return _elem(a)._seq > _elem(b)._seq;
+		}
+
+		/**
+		 * Return entry after which 'node' must be listed, or nullptr
+		 */
+		T *_predecessor(T &node)
+		{
+			if (_order == Order::NEWEST_FIRST)
+				return nullptr;
+
+			/* entries are often created in alphabetical order */
+			if (!_tail || _precedes(*_tail, node))
+				return _tail;
+
+			/* start the search at the cursor if it lies before 'node' */
+			T *prev = (_cursor && _precedes(*_cursor, node)) ? _cursor : nullptr;
+
+			for (T *next = prev ? _elem(*prev)._next : _head;
+			     next && _precedes(*next, node);
+			     next = _elem(*next)._next)
+				prev = next;
+
+			return prev;
+		}
+
+		T *&_bucket(unsigned long hash) {
+			return _buckets[hash & (_num_buckets - 1)]; }
+
+		void _free_buckets()
+		{
+			if (_buckets != _initial_buckets)
+				_alloc.free(_buckets, _num_buckets*sizeof(T *));
+		}
+
+		/**
+		 * Rehash the entries into a table of 'num' buckets
+		 *
+		 * If the allocation of the table fails, the index keeps its
+		 * current table, which merely makes lookups slower.
+		 */
+		void _resize(size_t num)
+		{
+			T **buckets = _initial_buckets;
+
+			if (num > INITIAL_BUCKETS) {
+				try {
+					if (!_alloc.alloc(num*sizeof(T *), &buckets))
+						return;
+				}
+				catch (Genode::Out_of_ram)  { return; }
+				catch (Genode::Out_of_caps) { return; }
+			}
+
+			for (size_t i = 0; i < num; i++)
+				buckets[i] = nullptr;
+
+			_free_buckets();
+			_buckets     = buckets;
+			_num_buckets = num;
+
+			for (T *node = _head; node; node = _elem(*node)._next) {
+				T *&bucket = _bucket(_elem(*node)._hash);
+				_elem(*node)._chain = bucket;
+				bucket = node;
+			}
+		}
+
+	public:
+
+		Directory_index(Genode::Allocator &alloc, Order order)
+		: _alloc(alloc), _order(order) { }
+
+		~Directory_index() { _free_buckets(); }
+
+		size_t count() const { return _count; }
+
+		T *first() { return _head; }
+
+		T *next(T &node) { return _elem(node)._next; }
+
+		void insert(T &node)
+		{
+			Element &e = _elem(node);
+
+			e._hash = _hash(node.name(), ~(size_t)0);
+			e._seq  = ++_seq;
+
+			T * const prev = _predecessor(node);
+
+			e._prev = prev;
+			e._next = prev ? _elem(*prev)._next : _head;
+			if (e._next) _elem(*e._next)._prev = &node;
+			else         _tail = &node;
+			if (prev)    _elem(*prev)._next = &node;
+			else         _head = &node;
+
+			/* keep the cursor at the position of its entry */
+			if (_cursor && _precedes(node, *_cursor))
+				_cursor_index++;
+
+			T *&bucket = _bucket(e._hash);
+			e._chain = bucket;
+			bucket   = &node;
+
+			if (++_count > _num_buckets)
+				_resize(2*_num_buckets);
+		}
+
+		void remove(T &node)
+		{
+			Element &e = _elem(node);
+
+			for (T **link = &_bucket(e._hash); *link; link = &_elem(**link)._chain)
+				if (*link == &node) {
+					*link = e._chain;
+					break;
+				}
+
+			/* keep the cursor at the position of its entry */
+			if (_cursor == &node) {
+				_cursor = e._prev;
+				if (_cursor) _cursor_index--;
+			}
+			else if (_cursor && _precedes(node, *_cursor))
+				_cursor_index--;
+
+			if (e._prev) _elem(*e._prev)._next = e._next;
+			else         _head = e._next;
+			if (e._next) _elem(*e._next)._prev = e._prev;
+			else         _tail = e._prev;
+
+			e = Element();
+
+			for (T *&recent : _recent)
+				if (recent == &node)
+					recent = nullptr;
+
+			if (--_count == 0 && _num_buckets > INITIAL_BUCKETS)
+				_resize(INITIAL_BUCKETS);
+		}
+
+		/**
+		 * Look up entry by the first 'len' characters of 'name'
+		 *
+		 * This way, a path component can be looked up without copying it.
+		 */
+		T *lookup(char const *name, size_t len)
+		{
+			unsigned long const hash = _hash(name, len);
+
+			T *&recent = _recent[hash % NUM_RECENT];
+			if (recent && _elem(*recent)._hash == hash && _matches(*recent, name, len))
+				return recent;
+
+			for (T *node = _bucket(hash); node; node = _elem(*node)._chain)
+				if (_elem(*node)._hash == hash && _matches(*node, name, len))
+					return recent = node;
+
+			return nullptr;
+		}
+
+		T *lookup(char const *name) { return lookup(name, Genode::strlen(name)); }
+
+		/**
+		 * Return entry at position 'index' in listing order
+		 */
+		T *entry(size_t index)
+		{
+			T     *node = _head;
+			size_t i    = 0;
+
+			if (_cursor) {
+				if (_cursor_index <= index) {
+					node = _cursor;
+					i    = _cursor_index;
+				}
+
+				/* walk backwards if the cursor is closer than the head */
+				else if (_cursor_index - index < index) {
+					node = _cursor;
+					for (i = _cursor_index; i > index; i--)
+						node = _elem(*node)._prev;
+				}
+			}
+
+			for (; i < index && node; i++)
+				node = _elem(*node)._next;
+
+			if (node) {
+				_cursor       = node;
+				_cursor_index = index;
+			}
+			return node;
+		}
+};
+
+#endif /* _INCLUDE__RAM_FS__DIRECTORY_INDEX_H_ */
@@ -18,6 +18,7 @@
 #include <util/reconstructible.h>
 #include <os/session_policy.h>
 #include <base/attached_ram_dataspace.h>
+#include <base/allocator.h>
 
 namespace Rom {
 	using Genode::size_t;
@@ -25,6 +26,7 @@ namespace Rom {
 	using Genode::Attached_ram_dataspace;
 
 	class Module;
+	class Snapshot;
 	class Readable_module;
 	class Registry;
 	class Writer;
@@ -34,6 +36,7 @@ namespace Rom {
 	typedef Genode::List<Module> Module_list;
 	typedef Genode::List<Reader> Reader_list;
 	typedef Genode::List<Writer> Writer_list;
+	typedef Genode::List<Snapshot> Snapshot_list;
 }
 
 
@@ -50,6 +53,36 @@ struct Rom::Reader : Reader_list::Element
 };
 
 
+/**
+ * Immutable version of the content of a ROM module
+ *
+ * Each report is stored in a snapshot of its own. Readers that share the
+ * module content obtain the dataspace of the current snapshot instead of a
+ * private copy. A snapshot is never modified while a reader holds it.
+ */
+class Rom::Snapshot : public Snapshot_list::Element
+{
+	private:
+
+		friend class Module;
+
+		Attached_ram_dataspace _ds;
+
+		size_t _size = 0;
+
+		unsigned _readers = 0;  /* number of readers that hold the snapshot */
+
+		Snapshot(Genode::Ram_session &ram, Genode::Region_map &rm, size_t capacity)
+		: _ds(ram, rm, capacity) { }
+
+	public:
+
+		size_t size() const { return _size; }
+
+		Genode::Ram_dataspace_capability cap() const { return _ds.cap(); }
+};
+
+
 struct Rom::Readable_module
 {
 	/**
@@ -68,6 +101,29 @@ struct Rom::Readable_module
 	                            size_t dst_len) const = 0;
 
 	virtual size_t size() const = 0;
+
+	/**
+	 * Return true if the reader shares the content with other readers
+	 */
+	virtual bool content_shared(Reader const &reader) const = 0;
+
+	/**
+	 * Obtain the current snapshot of the module content
+	 *
+	 * \return snapshot, or nullptr if no content is readable by the reader
+	 *
+	 * The snapshot stays unmodified until it is handed back via
+	 * 'release_snapshot'.
+	 */
+	virtual Snapshot const *acquire_snapshot(Reader const &reader) = 0;
+
+	virtual void release_snapshot(Snapshot const &snapshot) = 0;
+
+	/**
+	 * Return true if 'snapshot' is the current content readable by the reader
+	 */
+	virtual bool snapshot_current(Reader const &reader,
+	                              Snapshot const *snapshot) const = 0;
 };
 
 
@@ -99,6 +155,17 @@ struct Rom::Module : Module_list::Element, Readable_module
 			 */
 			virtual bool read_permitted(Module const &,
 			                            Writer const &, Reader const &) const = 0;
+
+			/**
+			 * Return true if the reader shares the content with other readers
+			 *
+			 * A sharing reader obtains the dataspace of the module content
+			 * instead of a private copy. Because a RAM dataspace cannot be
+			 * handed out read-only, however, a sharing reader is able to
+			 * modify the content seen by the other sharing readers.
+			 */
+			virtual bool content_shared(Module const &, Reader const &) const {
+				return false; }
 		};
 
 		struct Write_policy
@@ -119,6 +186,7 @@ struct Rom::Module : Module_list::Element, Readable_module
 
 		Genode::Ram_session &_ram;
 		Genode::Region_map  &_rm;
+		Genode::Allocator   &_alloc;
 
 		Read_policy  const &_read_policy;
 		Write_policy const &_write_policy;
@@ -132,18 +200,78 @@ struct Rom::Module : Module_list::Element, Readable_module
 		Writer const *_last_writer = nullptr;
 
 		/**
-		 * Dataspace used as backing store
+		 * Snapshots used as backing store
 		 *
 		 * The buffer for the content is not allocated from the heap to
 		 * allow for the immediate release of the underlying backing store when
 		 * the module gets destructed.
+		 *
+		 * A new report is written to the current snapshot if no reader holds
+		 * it. Otherwise, it is written to the spare snapshot, which makes
+		 * the writer alternate between two buffers while readers share the
+		 * content. Outdated snapshots still held by readers are retired
+		 * until their last reader releases them.
 		 */
-		Constructible<Attached_ram_dataspace> _ds;
+		Snapshot      *_current = nullptr;
+		Snapshot      *_spare   = nullptr;
+		Snapshot_list  _retired;
+
+		Snapshot *_readable(Reader const &reader) const
+		{
+			if (!_current || !_last_writer)
+				return nullptr;
+
+			if (!_read_policy.read_permitted(*this, *_last_writer, reader))
+				return nullptr;
+
+			return _current;
+		}
 
 		/**
-		 * Content size, which may less than the capacilty of '_ds'.
+		 * Keep unreferenced snapshot as spare buffer for the next report
 		 */
-		size_t _size = 0;
+		void _recycle(Snapshot &snapshot)
+		{
+			/* keep the larger one of both buffers */
+			Snapshot *obsolete = &snapshot;
+			if (!_spare || _spare->_ds.size() < snapshot._ds.size()) {
+				obsolete = _spare;
+				_spare   = &snapshot;
+			}
+
+			if (obsolete)
+				Genode::destroy(_alloc, obsolete);
+		}
+
+		void _retire(Snapshot &snapshot)
+		{
+			if (snapshot._readers)
+				_retired.insert(&snapshot);
+			else
+				_recycle(snapshot);
+		}
+
+		/**
+		 * Return unreferenced snapshot with a capacity of at least 'size'
+		 *
+		 * The returned snapshot is neither current nor spare.
+		 */
+		Snapshot &_writable_snapshot(size_t size)
+		{
+			if (_current && !_current->_readers && _current->_ds.size() >= size) {
+				Snapshot &snapshot = *_current;
+				_current = nullptr;
+				return snapshot;
+			}
+
+			if (_spare && _spare->_ds.size() >= size) {
+				Snapshot &snapshot = *_spare;
+				_spare = nullptr;
+				return snapshot;
+			}
+
+			return *new (_alloc) Snapshot(_ram, _rm, size);
+		}
 
 
 		/********************************
@@ -159,6 +287,7 @@ struct Rom::Module : Module_list::Element, Readable_module
 		 *                      backing store
 		 * \param rm            region map of the local address space, needed
 		 *                      to access the allocated backing store
+		 * \param alloc         allocator of the snapshot meta data
 		 * \param name          module name
 		 * \param read_policy   policy hook function that is evaluated each
 		 *                      time when the module content is obtained
@@ -167,11 +296,12 @@ struct Rom::Module : Module_list::Element, Readable_module
 		 */
 		Module(Genode::Ram_session &ram,
 		       Genode::Region_map  &rm,
+		       Genode::Allocator   &alloc,
 		       Name          const &name,
 		       Read_policy   const &read_policy,
 		       Write_policy  const &write_policy)
 		:
-			_name(name), _ram(ram), _rm(rm),
+			_name(name), _ram(ram), _rm(rm), _alloc(alloc),
 			_read_policy(read_policy), _write_policy(write_policy)
 		{ }
 
@@ -204,8 +334,9 @@ struct Rom::Module : Module_list::Element, Readable_module
 
 			/* clear content if its origin disappears */
 			if (_last_writer == &writer) {
-				Genode::memset(_ds->local_addr<char>(), 0, _size);
-				_size = 0;
+				if (_current)
+					_retire(*_current);
+				_current     = nullptr;
 				_last_writer = nullptr;
 			}
 		}
@@ -228,6 +359,16 @@ struct Rom::Module : Module_list::Element, Readable_module
 
 	public:
 
+		/*
+		 * The module gets destructed only if no reader refers to it.
+		 * Hence, no snapshot is retired at this point.
+		 */
+		~Module()
+		{
+			if (_current) Genode::destroy(_alloc, _current);
+			if (_spare)   Genode::destroy(_alloc, _spare);
+		}
+
 		/**
 		 * Assign new content to the ROM module
 		 *
@@ -238,26 +379,30 @@ struct Rom::Module : Module_list::Element, Readable_module
 			if (!_write_policy.write_permitted(*this, writer))
 				return;
 
-			_size = 0;
-
 			_last_writer = &writer;
 
 			/*
-			 * Realloc backing store if needed
-			 *
 			 * Take a terminating zero into account, which we append to each
 			 * report. This way, we do not need to trust report clients to
 			 * append a zero termination to textual reports.
 			 */
-			if (!_ds.constructed() || _ds->size() < (src_len + 1))
-				_ds.construct(_ram, _rm, (src_len + 1));
+			Snapshot &snapshot = _writable_snapshot(src_len + 1);
 
 			/* copy content into backing store */
-			_size = src_len;
-			Genode::memcpy(_ds->local_addr<char>(), src, _size);
+			char * const dst = snapshot._ds.local_addr<char>();
+			Genode::memcpy(dst, src, src_len);
 
-			/* append zero termination */
-			_ds->local_addr<char>()[src_len] = 0;
+			/* append zero termination, clear remainder of previous content */
+			size_t const old_size = snapshot._size;
+			dst[src_len] = 0;
+			if (old_size > src_len)
+				Genode::memset(dst + src_len, 0, old_size - src_len);
+
+			snapshot._size = src_len;
+
+			if (_current)
+				_retire(*_current);
+			_current = &snapshot;
 
 			/* notify ROM clients that access the module */
 			for (Reader *r = _readers.first(); r; r = r->next()) {
@@ -274,20 +419,61 @@ struct Rom::Module : Module_list::Element, Readable_module
 		 */
 		size_t read_content(Reader const &reader, char *dst, size_t dst_len) const override
 		{
-			if (!_ds.constructed() || !_last_writer)
-				return 0;
-
-			if (!_read_policy.read_permitted(*this, *_last_writer, reader))
+			Snapshot const * const snapshot = _readable(reader);
+			if (!snapshot)
 				return 0;
 
-			if (dst_len < _size)
+			if (dst_len < snapshot->_size)
 				throw Buffer_too_small();
 
-			Genode::memcpy(dst, _ds->local_addr<char>(), _size);
-			return _size;
+			Genode::memcpy(dst, snapshot->_ds.local_addr<char>(), snapshot->_size);
+			return snapshot->_size;
 		}
 
-		virtual size_t size() const override { return _size; }
+		virtual size_t size() const override { return _current ? _current->_size : 0; }
+
+		/**
+		 * Readable_module interface
+		 */
+		bool content_shared(Reader const &reader) const override
+		{
+			return _read_policy.content_shared(*this, reader);
+		}
+
+		/**
+		 * Readable_module interface
+		 */
+		Snapshot const *acquire_snapshot(Reader const &reader) override
+		{
+			Snapshot * const snapshot = _readable(reader);
+			if (snapshot)
+				snapshot->_readers++;
+
+			return snapshot;
+		}
+
+		/**
+		 * Readable_module interface
+		 */
+		void release_snapshot(Snapshot const &s) override
+		{
+			Snapshot &snapshot = const_cast<Snapshot &>(s);
+
+			if (--snapshot._readers || &snapshot == _current)
+				return;
+
+			/* last reader of a retired snapshot */
+			_retired.remove(&snapshot);
+			_recycle(snapshot);
+		}
+
+		/**
+		 * Readable_module interface
+		 */
+		bool snapshot_current(Reader const &reader, Snapshot const *snapshot) const override
+		{
+			return snapshot == _readable(reader);
+		}
 
 		Name name() const { return _name; }
 };
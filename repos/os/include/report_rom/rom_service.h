@@ -51,10 +51,28 @@ class Rom::Session_component : public Genode::Rpc_object<Genode::Rom_session>,
 				throw Genode::Service_denied(); }
 		}
 
+		/**
+		 * Private copy of the module content
+		 */
 		Constructible<Genode::Attached_ram_dataspace> _ds;
 
 		size_t _content_size = 0;
 
+		/**
+		 * Snapshot handed out to the client if the content is shared
+		 */
+		bool const _shared = _module.content_shared(*this);
+
+		Snapshot const *_snapshot = nullptr;
+
+		void _release_snapshot()
+		{
+			if (_snapshot)
+				_module.release_snapshot(*_snapshot);
+
+			_snapshot = nullptr;
+		}
+
 		/**
 		 * Keep state of valid content to notify the client only once when
 		 * the ROM module becomes invalid.
@@ -95,6 +113,7 @@ class Rom::Session_component : public Genode::Rpc_object<Genode::Rom_session>,
 
 		~Session_component()
 		{
+			_release_snapshot();
 			_registry.release(*this, _module);
 		}
 
@@ -104,6 +123,21 @@ class Rom::Session_component : public Genode::Rpc_object<Genode::Rom_session>,
 		{
 			using namespace Genode;
 
+				if (_shared) {
+					_release_snapshot();
+					_snapshot = _module.acquire_snapshot(*this);
+				}
+
+				/* hand out the shared snapshot instead of a private copy */
+				if (_snapshot) {
+					_ds.destruct();
+					_content_size = _snapshot->size();
+					_valid = true;
+
+					Dataspace_capability ds_cap = static_cap_cast<Dataspace>(_snapshot->cap());
+					return static_cap_cast<Rom_dataspace>(ds_cap);
+				}
+
 				/* replace dataspace by new one */
 				/* XXX we could keep the old dataspace if the size fits */
 				_ds.construct(_ram, _rm, _module.size());
@@ -121,6 +155,14 @@ class Rom::Session_component : public Genode::Rpc_object<Genode::Rom_session>,
 
 		bool update() override
 		{
+			/*
+			 * A snapshot is immutable. Hence, new content requires the
+			 * client to request a new dataspace.
+			 */
+			if (_shared)
+				return (_snapshot || _ds.constructed())
+				     && _module.snapshot_current(*this, _snapshot);
+
 			if (!_ds.constructed() || _module.size() > _ds->size())
 				return false;
 
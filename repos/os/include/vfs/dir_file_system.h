@@ -52,12 +52,33 @@ class Vfs::Dir_file_system : public File_system
 			Vfs_handle               *fs_dir_handle { nullptr };
 			Sync_dir_handle_registry  sync_dir_handle_registry;
 
+			/*
+			 * Range of directory entries served by 'fs_dir_handle'
+			 *
+			 * The directory handle of the sub file system is kept open
+			 * across reads so that a sequential listing does not open
+			 * the directory anew for each entry.
+			 */
+			file_offset fs_dir_base { 0 };
+			file_offset fs_dir_num  { 0 };
+
 			Dir_vfs_handle(Directory_service &ds,
 			               File_io_service   &fs,
 			               Genode::Allocator &alloc,
 			               char const *path)
 			: Vfs_handle(ds, fs, alloc, 0),
 			  path(path) { }
+
+			~Dir_vfs_handle() { close_fs_dir(); }
+
+			void close_fs_dir()
+			{
+				if (fs_dir_handle)
+					fs_dir_handle->ds().close(fs_dir_handle);
+
+				fs_dir_handle        = nullptr;
+				fs_for_complete_read = nullptr;
+			}
 		};
 
 		/* pointer to first child file system */
@@ -199,6 +220,21 @@ class Vfs::Dir_file_system : public File_system
 		{
 			file_offset index = dir_vfs_handle->seek() / sizeof(Dirent);
 
+			/* continue reading from the directory of the previous read */
+			if (dir_vfs_handle->fs_dir_handle
+			 && index >= dir_vfs_handle->fs_dir_base
+			 && index <  dir_vfs_handle->fs_dir_base + dir_vfs_handle->fs_dir_num) {
+
+				Vfs_handle &handle = *dir_vfs_handle->fs_dir_handle;
+
+				handle.seek((index - dir_vfs_handle->fs_dir_base) * sizeof(Dirent));
+
+				return dir_vfs_handle->fs_for_complete_read->queue_read(&handle,
+				                                                        sizeof(Dirent));
+			}
+
+			dir_vfs_handle->close_fs_dir();
+
 			char const *sub_path = _sub_path(dir_vfs_handle->path.base());
 
 			if (strlen(sub_path) == 0)
@@ -230,12 +266,17 @@ class Vfs::Dir_file_system : public File_system
 					 * Errors of this kind can only be communicated by
 					 * 'complete_read()'
 					 */
-					if (opendir_result != OPENDIR_OK)
+					if (opendir_result != OPENDIR_OK) {
+						dir_vfs_handle->fs_dir_handle = nullptr;
 						return true;
+					}
 
 					dir_vfs_handle->fs_dir_handle->context =
 						dir_vfs_handle->context;
 
+					dir_vfs_handle->fs_dir_base = base;
+					dir_vfs_handle->fs_dir_num  = fs_num_dirent;
+
 					index = index - base;
 					dir_vfs_handle->fs_dir_handle->seek(index * sizeof(Dirent));
 
@@ -275,18 +316,10 @@ class Vfs::Dir_file_system : public File_system
 				return READ_OK;
 			}
 
-			Read_result result = dir_vfs_handle->fs_for_complete_read->
-			                     complete_read(dir_vfs_handle->fs_dir_handle,
-			                                   dst, count, out_count);
-
-			if (result != READ_OK)
-				return result;
-
-			dir_vfs_handle->fs_for_complete_read->close(dir_vfs_handle->fs_dir_handle);
-			dir_vfs_handle->fs_dir_handle = nullptr;
-			dir_vfs_handle->fs_for_complete_read = nullptr;
-
-			return result;
+			/* the directory handle stays open for subsequent reads */
+			return dir_vfs_handle->fs_for_complete_read->
+			       complete_read(dir_vfs_handle->fs_dir_handle,
+			                     dst, count, out_count);
 		}
 
 	public:
@@ -26,9 +26,31 @@ namespace Vfs {
 
 struct Vfs::Directory_service
 {
+	/**
+	 * Return dataspace with the content of the file at 'path'
+	 *
+	 * \return  invalid capability if the file system cannot provide a
+	 *          dataspace for the file
+	 */
 	virtual Dataspace_capability dataspace(char const *path) = 0;
+
+	/**
+	 * Release dataspace obtained via 'dataspace'
+	 *
+	 * The file system must ignore dataspaces it did not hand out.
+	 */
 	virtual void release(char const *path, Dataspace_capability) = 0;
 
+	/**
+	 * Return true if the dataspaces obtained via 'dataspace' hold the
+	 * file content
+	 *
+	 * In this case, all users of a file share the same dataspace and
+	 * modifications of the dataspace become the content of the file.
+	 * Otherwise, the dataspaces are copies of the file content.
+	 */
+	virtual bool dataspace_holds_content() { return false; }
+
 
 	enum General_error { ERR_FD_INVALID, NUM_GENERAL_ERRORS };
 
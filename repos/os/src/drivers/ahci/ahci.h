@@ -249,6 +249,27 @@ struct Command_fis : Genode::Mmio
 		/* packet command */
 		write<Command>(0xa0);
 	}
+
+	/**
+	 * TRIM the LBA ranges described by 'blocks' 512-byte blocks of entries
+	 */
+	void data_set_management(Genode::size_t blocks)
+	{
+		enum { TRIM = 1 };
+
+		write<Bits::C>(1);
+		write<Device::Lba>(1);
+		write<Command>(0x06);
+		write<Features>(TRIM);
+		write<Sector>(blocks);
+	}
+
+	void flush_cache_ext()
+	{
+		write<Bits::C>(1);
+		write<Device::Lba>(1);
+		write<Command>(0xea);
+	}
 };
 
 
@@ -40,6 +40,19 @@ struct Identity : Genode::Mmio
 		struct Ncq_support : Bitfield<8, 1> { };
 	};
 
+	struct Command_set : Register<0xa6, 16>
+	{
+		struct Flush_cache_ext : Bitfield<13, 1> { };
+	};
+
+	/* maximum number of 512-byte blocks of LBA range entries */
+	struct Dsm_blocks : Register<0xd2, 16> { };
+
+	struct Dsm : Register<0x152, 16>
+	{
+		struct Trim : Bitfield<0, 1> { };
+	};
+
 	struct Sector_count : Register<0xc8, 64> { };
 
 	struct Logical_block  : Register<0xd4, 16>
@@ -73,6 +86,8 @@ struct Identity : Genode::Mmio
 		    read<Logical_words>());
 		log("  offset of first logical block within physical: ",
 		    read<Alignment::Logical_offset>());
+		log("  trim: ", read<Dsm::Trim>() ? "yes" : "no", " "
+		    "flush cache ext: ", read<Command_set::Flush_cache_ext>() ? "yes" : "no");
 	}
 };
 
@@ -188,6 +203,19 @@ struct Ata_driver : Port_driver
 
 	Io_command                               *io_cmd = nullptr;
 	Block::Packet_descriptor                  pending[32];
+	unsigned                                  busy_slots = 0;
+
+	/*
+	 * Commands that are not queued (TRIM and cache flush) must not be
+	 * mixed with queued commands. Hence, they are issued only if no other
+	 * command is in flight and hold back all further commands.
+	 */
+	bool non_queued = false;
+
+	enum { DSM_RANGE_SIZE = 0x1000 };
+
+	Genode::Ram_dataspace_capability dsm_ds;     /* LBA range entries */
+	uint64_t                        *dsm_range = nullptr;
 
 	Signal_context_capability device_identified;
 
@@ -211,27 +239,58 @@ struct Ata_driver : Port_driver
 	{
 		if (io_cmd)
 			destroy(&alloc, io_cmd);
+
+		if (dsm_ds.valid()) {
+			rm.detach(dsm_range);
+			platform_hba.free_dma_buffer(dsm_ds);
+		}
 	}
 
+	bool busy(unsigned slot) const { return busy_slots & (1U << slot); }
+
 	unsigned find_free_cmd_slot()
 	{
+		if (non_queued)
+			throw Block::Driver::Request_congestion();
+
 		for (unsigned slot = 0; slot < cmd_slots; slot++)
-			if (!pending[slot].size())
+			if (!busy(slot))
 				return slot;
 
 		throw Block::Driver::Request_congestion();
 	}
 
+	/**
+	 * Return slot for a command that is not queued
+	 */
+	unsigned non_queued_cmd_slot()
+	{
+		if (busy_slots)
+			throw Block::Driver::Request_congestion();
+
+		non_queued = true;
+		return 0;
+	}
+
+	void issue(unsigned slot, Block::Packet_descriptor &packet)
+	{
+		pending[slot] = packet;
+		busy_slots   |= 1U << slot;
+		execute(slot);
+	}
+
 	void ack_packets()
 	{
 		unsigned slots =  Port::read<Ci>() | Port::read<Sact>();
 
 		for (unsigned slot = 0; slot < cmd_slots; slot++) {
-			if ((slots & (1U << slot)) || !pending[slot].size())
+			if ((slots & (1U << slot)) || !busy(slot))
 				continue;
 
 			Block::Packet_descriptor p = pending[slot];
 			pending[slot] = Block::Packet_descriptor();
+			busy_slots   &= ~(1U << slot);
+			non_queued    = false;
 			ack_packet(p, true);
 		}
 	}
@@ -242,7 +301,7 @@ struct Ata_driver : Port_driver
 		Block::sector_t end = block_number + count - 1;
 
 		for (unsigned slot = 0; slot < cmd_slots; slot++) {
-			if (!pending[slot].size())
+			if (!busy(slot))
 				continue;
 
 			Block::sector_t pending_start = pending[slot].block_number();
@@ -272,7 +331,6 @@ struct Ata_driver : Port_driver
 		overlap_check(block_number, count);
 
 		unsigned slot = find_free_cmd_slot();
-		pending[slot] = packet;
 
 		/* setup fis */
 		Command_table table(command_table_addr(slot), phys, count * block_size());
@@ -285,9 +343,14 @@ struct Ata_driver : Port_driver
 		header.write<Command_header::Bits::W>(read ? 0 : 1);
 		header.clear_byte_count();
 
-		execute(slot);
+		issue(slot, packet);
 	}
 
+	bool trim_support() { return info->read<Identity::Dsm::Trim>(); }
+
+	bool flush_support() {
+		return info->read<Identity::Command_set::Flush_cache_ext>(); }
+
 
 	/*****************
 	 ** Port_driver **
@@ -315,6 +378,12 @@ struct Ata_driver : Port_driver
 				}
 
 				check_device();
+
+				if (trim_support()) {
+					dsm_ds    = platform_hba.alloc_dma_buffer(DSM_RANGE_SIZE);
+					dsm_range = rm.attach(dsm_ds);
+				}
+
 				if (ncq_support())
 					io_cmd = new (&alloc) Ncq_command();
 				else
@@ -329,6 +398,11 @@ struct Ata_driver : Port_driver
 		case READY:
 
 			io_cmd->handle_irq(*this, status);
+
+			/* completion of a non-queued command in NCQ mode */
+			if (non_queued && Port::Is::Dhrs::get(status))
+				ack_irq();
+
 			ack_packets();
 
 		default:
@@ -373,14 +447,93 @@ struct Ata_driver : Port_driver
 
 	bool dma_enabled() { return true; };
 
+	/*
+	 * With NCQ, the device processes requests of all command slots
+	 * concurrently and completes them in any order.
+	 */
+	unsigned request_slots() override { return cmd_slots; }
+
 	Block::Session::Operations ops() override
 	{
 		Block::Session::Operations o;
 		o.set_operation(Block::Packet_descriptor::READ);
 		o.set_operation(Block::Packet_descriptor::WRITE);
+		if (trim_support())
+			o.set_operation(Block::Packet_descriptor::DISCARD);
 		return o;
 	}
 
+	/*
+	 * Discard via the TRIM function of DATA SET MANAGEMENT
+	 *
+	 * Each LBA range entry covers up to 65535 blocks. Blocks beyond the
+	 * capacity of the entries that fit into a single command are left
+	 * untouched, which is permitted because discarding is advisory.
+	 */
+	void discard(Block::sector_t           block_number,
+	             size_t                    count,
+	             Block::Packet_descriptor &packet) override
+	{
+		if (!trim_support())
+			throw Io_error();
+
+		sanity_check(block_number, count);
+
+		unsigned const slot = non_queued_cmd_slot();
+
+		enum { BLOCK = 512, ENTRIES_PER_BLOCK = BLOCK / sizeof(uint64_t) };
+
+		size_t const max_blocks  = min((size_t)DSM_RANGE_SIZE / BLOCK,
+		                               max((size_t)1,
+		                                   (size_t)info->read<Identity::Dsm_blocks>()));
+		size_t const max_entries = max_blocks * ENTRIES_PER_BLOCK;
+
+		size_t entries = 0;
+		for (; count && entries < max_entries; entries++) {
+			size_t const n = min(count, (size_t)0xffff);
+			dsm_range[entries] = block_number | ((uint64_t)n << 48);
+			block_number += n;
+			count        -= n;
+		}
+
+		/* entries with a count of zero are ignored by the device */
+		size_t const blocks = align_addr(entries, 6) / ENTRIES_PER_BLOCK;
+		for (size_t i = entries; i < blocks * ENTRIES_PER_BLOCK; i++)
+			dsm_range[i] = 0;
+
+		addr_t const phys = Dataspace_client(dsm_ds).phys_addr();
+		Command_table table(command_table_addr(slot), phys, blocks * BLOCK);
+		table.fis.data_set_management(blocks);
+
+		Command_header header(command_header_addr(slot));
+		header.write<Command_header::Bits::W>(1);
+		header.clear_byte_count();
+
+		issue(slot, packet);
+	}
+
+	/*
+	 * Flush the write cache of the device asynchronously
+	 */
+	void flush(Block::Packet_descriptor &packet) override
+	{
+		if (!flush_support()) {
+			Block::Driver::flush(packet);
+			return;
+		}
+
+		unsigned const slot = non_queued_cmd_slot();
+
+		Command_table table(command_table_addr(slot), 0, 0);
+		table.fis.flush_cache_ext();
+
+		Command_header header(command_header_addr(slot));
+		header.write<Command_header::Bits::W>(0);
+		header.clear_byte_count();
+
+		issue(slot, packet);
+	}
+
 	void read_dma(Block::sector_t           block_number,
 	              size_t                    block_count,
 	              addr_t                    phys,
@@ -120,6 +120,7 @@ Init::Child::apply_config(Xml_node start_node)
 
 		/* import new start node */
 		_start_node.construct(_alloc, start_node);
+		_start_node_hash = xml_hash(start_node);
 	}
 
 	/*
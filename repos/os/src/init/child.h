@@ -17,6 +17,7 @@
 /* Genode includes */
 #include <base/log.h>
 #include <base/child.h>
+#include <util/avl_string.h>
 #include <os/session_requester.h>
 #include <os/session_policy.h>
 
@@ -75,6 +76,12 @@ class Init::Child : Child_policy, Routed_service::Wakeup
 
 		Reconstructible<Buffered_xml> _start_node;
 
+		/* hash of '_start_node', used to detect start-node changes */
+		Xml_hash _start_node_hash { xml_hash(_start_node->xml()) };
+
+		/* most recent config generation that declares the child */
+		unsigned _declared_generation = 0;
+
 		/*
 		 * Version attribute of the start node, used to force child restarts.
 		 */
@@ -105,6 +112,18 @@ class Init::Child : Child_policy, Routed_service::Wakeup
 		typedef String<64> Name;
 		Name const _unique_name { _name_from_xml(_start_node->xml()) };
 
+		/*
+		 * Node of the name-indexed child table of the child registry
+		 */
+		struct Name_node : Avl_string_base
+		{
+			Child &child;
+
+			Name_node(Name const &name, Child &child)
+			: Avl_string_base(name.string()), child(child) { }
+
+		} _name_node { _unique_name, *this };
+
 		static Binary_name _binary_from_xml(Xml_node start_node,
 		                                    Name const &unique_name)
 		{
@@ -487,6 +506,33 @@ class Init::Child : Child_policy, Routed_service::Wakeup
 
 		bool abandoned() const { return _state == STATE_ABANDONED; }
 
+		/**
+		 * Mark child as declared by the config of the specified generation
+		 */
+		void declared(unsigned generation) { _declared_generation = generation; }
+
+		bool declared_by(unsigned generation) const {
+			return _declared_generation == generation; }
+
+		/**
+		 * Return true if the start node differs from the applied one
+		 *
+		 * \param hash  'xml_hash' of 'start_node'
+		 *
+		 * The comparison is based on the size and the hash of the node
+		 * content and does not touch the buffered start node.
+		 */
+		bool start_node_changed(Xml_node start_node, Xml_hash hash) const
+		{
+			return hash != _start_node_hash
+			    || start_node.size() != _start_node->xml().size();
+		}
+
+		/**
+		 * Return true if the environment sessions of the child are complete
+		 */
+		bool env_complete() const { return _child.active(); }
+
 		enum Apply_config_result { MAY_HAVE_SIDE_EFFECTS, NO_SIDE_EFFECTS };
 
 		/**
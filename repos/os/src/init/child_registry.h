@@ -29,6 +29,9 @@ class Init::Child_registry : public Name_registry, Child_list
 
 		List<Alias> _aliases;
 
+		/* children indexed by name */
+		Avl_tree<Avl_string_base> _names;
+
 		bool _unique(const char *name) const
 		{
 			/* check for name clash with an existing child */
@@ -59,6 +62,7 @@ class Init::Child_registry : public Name_registry, Child_list
 		void insert(Child *child)
 		{
 			Child_list::insert(&child->_list_element);
+			_names.insert(&child->_name_node);
 		}
 
 		/**
@@ -67,6 +71,20 @@ class Init::Child_registry : public Name_registry, Child_list
 		void remove(Child *child)
 		{
 			Child_list::remove(&child->_list_element);
+			_names.remove(&child->_name_node);
+		}
+
+		/**
+		 * Return child of the specified name, or nullptr if no such child
+		 * exists
+		 */
+		Child *child(Child_policy::Name const &name)
+		{
+			Avl_string_base * const node =
+				_names.first() ? _names.first()->find_by_name(name.string())
+				               : nullptr;
+
+			return node ? &static_cast<Child::Name_node *>(node)->child : nullptr;
 		}
 
 		/**
@@ -48,6 +48,28 @@ struct Init::Main : State_reporter::Producer, Child::Default_route_accessor,
 
 	unsigned _child_cnt = 0;
 
+	/* incremented with each config update */
+	unsigned _config_generation = 0;
+
+	/* hash of the declarations that affect the routing of all children */
+	Xml_hash _routing_decls_hash = 0;
+
+	/**
+	 * Return hash of all top-level config nodes except for the start nodes
+	 *
+	 * Parent services, aliases, and the default route may change the
+	 * routing of any child. Changes of start nodes affect only the
+	 * respective child, unless they have side effects.
+	 */
+	static Xml_hash _routing_decls_hash_from_config(Xml_node config)
+	{
+		Xml_hash hash = 0;
+		config.for_each_sub_node([&] (Xml_node node) {
+			if (!node.has_type("start"))
+				hash = hash*31 + xml_hash(node); });
+		return hash;
+	}
+
 	static Ram_quota _preserved_ram_from_config(Xml_node config)
 	{
 		Number_of_bytes preserve { 40*sizeof(long)*1024 };
@@ -140,8 +162,8 @@ struct Init::Main : State_reporter::Producer, Child::Default_route_accessor,
 
 	void _update_aliases_from_config();
 	void _update_parent_services_from_config();
-	void _abandon_obsolete_children();
-	void _update_children_config();
+	bool _abandon_obsolete_children();
+	unsigned _update_children_config(bool routing_changed);
 	void _destroy_abandoned_parent_services();
 	void _handle_config();
 
@@ -234,26 +256,40 @@ void Init::Main::_update_aliases_from_config()
 }
 
 
-void Init::Main::_abandon_obsolete_children()
+/**
+ * \return true if any child got abandoned
+ */
+bool Init::Main::_abandon_obsolete_children()
 {
-	_children.for_each_child([&] (Child &child) {
-
-		Child_policy::Name const name = child.name();
-
-		bool obsolete = true;
-		_config_xml.for_each_sub_node("start", [&] (Xml_node node) {
-			if (node.attribute_value("name", Child_policy::Name()) == name)
-				obsolete = false; });
+	_config_xml.for_each_sub_node("start", [&] (Xml_node node) {
+		Child * const child =
+			_children.child(node.attribute_value("name", Child_policy::Name()));
+		if (child)
+			child->declared(_config_generation);
+	});
 
-		if (obsolete)
+	bool abandoned = false;
+	_children.for_each_child([&] (Child &child) {
+		if (!child.declared_by(_config_generation) && !child.abandoned()) {
 			child.abandon();
+			abandoned = true;
+		}
 	});
+	return abandoned;
 }
 
 
-void Init::Main::_update_children_config()
+/**
+ * \param routing_changed  true if the update may affect the routing of
+ *                         children with unchanged start nodes
+ *
+ * \return number of children the new config was applied to
+ */
+unsigned Init::Main::_update_children_config(bool routing_changed)
 {
-	for (;;) {
+	unsigned updated_children = 0;
+
+	for (bool all = routing_changed; ; all = true) {
 
 		/*
 		 * Children are abandoned if any of their client sessions can no longer
@@ -261,34 +297,51 @@ void Init::Main::_update_children_config()
 		 * service, an avalanche effect may occur. It stops if no update causes
 		 * a potential side effect in one iteration over all chilren.
 		 */
-		bool side_effects = false;
+		bool     side_effects = false;
+		unsigned updated      = 0;
 
 		_config_xml.for_each_sub_node("start", [&] (Xml_node node) {
 
-			Child_policy::Name const start_node_name =
-				node.attribute_value("name", Child_policy::Name());
-
-			_children.for_each_child([&] (Child &child) {
-				if (child.name() == start_node_name) {
-					switch (child.apply_config(node)) {
-					case Child::NO_SIDE_EFFECTS: break;
-					case Child::MAY_HAVE_SIDE_EFFECTS: side_effects = true; break;
-					};
-				}
-			});
+			Child * const child =
+				_children.child(node.attribute_value("name", Child_policy::Name()));
+			if (!child)
+				return;
+
+			/*
+			 * Skip children with unchanged start nodes unless the routing
+			 * may have changed. Children with an incomplete environment are
+			 * updated to re-attempt the routing of their environment
+			 * sessions.
+			 */
+			if (!all && child->env_complete()
+			 && !child->start_node_changed(node, xml_hash(node)))
+				return;
+
+			updated++;
+			switch (child->apply_config(node)) {
+			case Child::NO_SIDE_EFFECTS: break;
+			case Child::MAY_HAVE_SIDE_EFFECTS: side_effects = true; break;
+			};
 		});
 
+		updated_children = max(updated_children, updated);
+
+		/* side effects may affect the routing of any child */
 		if (!side_effects)
 			break;
 	}
+	return updated_children;
 }
 
 
 void Init::Main::_handle_config()
 {
+	_state_reporter.reconfiguration_started();
+
 	_config.update();
 
 	_config_xml = _config.xml();
+	_config_generation++;
 
 	_verbose.construct(_config_xml);
 	_state_reporter.apply_config(_config_xml);
@@ -307,10 +360,17 @@ void Init::Main::_handle_config()
 	Prio_levels     const prio_levels    = prio_levels_from_xml(_config_xml);
 	Affinity::Space const affinity_space = affinity_space_from_xml(_config_xml);
 
+	Xml_hash const routing_decls_hash = _routing_decls_hash_from_config(_config_xml);
+	bool const routing_decls_changed = (routing_decls_hash != _routing_decls_hash);
+	_routing_decls_hash = routing_decls_hash;
+
 	_update_aliases_from_config();
 	_update_parent_services_from_config();
-	_abandon_obsolete_children();
-	_update_children_config();
+
+	bool const children_abandoned = _abandon_obsolete_children();
+
+	unsigned const updated_children =
+		_update_children_config(routing_decls_changed || children_abandoned);
 
 	/* kill abandoned children */
 	_children.for_each_child([&] (Child &child) {
@@ -335,13 +395,8 @@ void Init::Main::_handle_config()
 		_config_xml.for_each_sub_node("start", [&] (Xml_node start_node) {
 
 			/* skip start node if corresponding child already exists */
-			bool exists = false;
-			_children.for_each_child([&] (Child const &child) {
-				if (child.name() == start_node.attribute_value("name", Child_policy::Name()))
-					exists = true; });
-			if (exists) {
+			if (_children.child(start_node.attribute_value("name", Child_policy::Name())))
 				return;
-			}
 
 			if (used_ram.value > avail_ram.value) {
 				error("RAM exhausted while starting childen");
@@ -423,6 +478,8 @@ void Init::Main::_handle_config()
 	_children.for_each_child([&] (Child &child) { child.apply_ram_upgrade(); });
 
 	_server.apply_config(_config_xml);
+
+	_state_reporter.reconfiguration_finished(updated_children);
 }
 
 
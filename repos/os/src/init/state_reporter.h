@@ -58,6 +58,22 @@ class Init::State_reporter : public Report_update_trigger
 
 		bool _scheduled = false;
 
+		/*
+		 * Statistics of the most recent reconfiguration
+		 *
+		 * The latency is measured only if the timer is already present at
+		 * the start of the reconfiguration, i.e., not for the initial
+		 * config.
+		 */
+		struct Reconfiguration
+		{
+			bool          timed            = false;
+			unsigned long start_us         = 0;
+			unsigned long latency_us       = 0;
+			unsigned      updated_children = 0;
+			bool          reported         = false;
+		} _reconfiguration;
+
 		void _handle_timer()
 		{
 			_scheduled = false;
@@ -68,6 +84,13 @@ class Init::State_reporter : public Report_update_trigger
 					if (_version.valid())
 						xml.attribute("version", _version);
 
+					if (_reconfiguration.reported)
+						xml.node("reconfiguration", [&] () {
+							xml.attribute("latency_us", _reconfiguration.latency_us);
+							xml.attribute("updated_children",
+							              _reconfiguration.updated_children);
+						});
+
 					_producer.produce_state_report(xml, *_report_detail);
 				});
 			}
@@ -136,6 +159,32 @@ class Init::State_reporter : public Report_update_trigger
 				trigger_report_update();
 		}
 
+		void reconfiguration_started()
+		{
+			_reconfiguration.timed = _timer.constructed();
+			if (_reconfiguration.timed)
+				_reconfiguration.start_us = _timer->elapsed_us();
+		}
+
+		/**
+		 * Record the completion of a reconfiguration
+		 *
+		 * \param updated_children  number of children the new config was
+		 *                          applied to
+		 */
+		void reconfiguration_finished(unsigned updated_children)
+		{
+			if (!_reconfiguration.timed)
+				return;
+
+			_reconfiguration.latency_us = _timer->elapsed_us()
+			                            - _reconfiguration.start_us;
+			_reconfiguration.updated_children = updated_children;
+			_reconfiguration.reported = true;
+
+			trigger_report_update();
+		}
+
 		void trigger_report_update() override
 		{
 			if (!_scheduled && _timer.constructed() && _report_delay_ms) {
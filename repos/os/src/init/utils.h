@@ -260,6 +260,22 @@ namespace Init {
 		} catch (...) {
 			return Affinity::Space(1, 1); }
 	}
+
+
+	typedef uint64_t Xml_hash;
+
+	/**
+	 * Return FNV-1a hash of the characters of an XML node
+	 *
+	 * \param hash  hash value to continue, used for hashing node sequences
+	 */
+	inline Xml_hash xml_hash(Xml_node node, Xml_hash hash = 14695981039346656037ULL)
+	{
+		char const * const s = node.addr();
+		for (size_t i = 0; i < node.size(); i++)
+			hash = (hash ^ (unsigned char)s[i])*1099511628211ULL;
+		return hash;
+	}
 }
 
 #endif /* _SRC__INIT__UTIL_H_ */
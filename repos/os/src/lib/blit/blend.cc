@@ -0,0 +1,50 @@
+/*
+ * \brief  Blending lines of pixels
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <blit/blend.h>
+#include <blend_kernels.h>
+#include <blend_helper.h>
+
+
+/**
+ * Return blending functions suited for the CPU, selected on first use
+ */
+static Blend::Functions const &functions()
+{
+	static Blend::Functions const f = select_blend_functions();
+	return f;
+}
+
+
+extern "C" void blend_rgb565(void *dst, void const *src,
+                             unsigned char const *alpha, int n)
+{
+	functions().rgb565((Blend::uint16_t *)dst, (Blend::uint16_t const *)src,
+	                   alpha, n);
+}
+
+
+extern "C" void blend_rgb888(void *dst, void const *src,
+                             unsigned char const *alpha, int n)
+{
+	functions().rgb888((Blend::uint32_t *)dst, (Blend::uint32_t const *)src,
+	                   alpha, n);
+}
+
+
+extern "C" void avr_rgb565(void *dst, void const *src,
+                           unsigned short mix, int n)
+{
+	functions().avr_rgb565((Blend::uint16_t *)dst,
+	                       (Blend::uint16_t const *)src, mix, n);
+}
@@ -0,0 +1,25 @@
+/*
+ * \brief  Selection of blending functions for CPUs without vector support
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__BLEND_HELPER_H_
+#define _LIB__BLIT__BLEND_HELPER_H_
+
+#include <blend_kernels.h>
+
+static inline Blend::Functions select_blend_functions()
+{
+	return { Blend::scalar_rgb565, Blend::scalar_rgb888,
+	         Blend::scalar_avr_rgb565 };
+}
+
+#endif /* _LIB__BLIT__BLEND_HELPER_H_ */
@@ -0,0 +1,243 @@
+/*
+ * \brief  Generic implementation of the blending functions
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The vector kernels are written with the vector extensions of GCC and are
+ * instantiated by the CPU-specific 'blend_helper.h' for the vector units at
+ * hand. They replicate the arithmetics of the scalar pixel functions bit by
+ * bit.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__BLEND_KERNELS_H_
+#define _LIB__BLIT__BLEND_KERNELS_H_
+
+#include <os/pixel_rgb565.h>
+#include <os/pixel_rgb888.h>
+
+namespace Blend {
+
+	using Genode::uint16_t;
+	using Genode::uint32_t;
+	using Genode::uint64_t;
+
+	struct Functions;
+
+	template <typename, typename> struct Vector_kernels;
+
+	void scalar_rgb565(uint16_t *, uint16_t const *, unsigned char const *, int);
+	void scalar_rgb888(uint32_t *, uint32_t const *, unsigned char const *, int);
+	void scalar_avr_rgb565(uint16_t *, uint16_t const *, uint16_t, int);
+}
+
+
+/**
+ * Set of blending functions selected for the CPU
+ */
+struct Blend::Functions
+{
+	void (*rgb565)(uint16_t *, uint16_t const *, unsigned char const *, int);
+	void (*rgb888)(uint32_t *, uint32_t const *, unsigned char const *, int);
+	void (*avr_rgb565)(uint16_t *, uint16_t const *, uint16_t, int);
+};
+
+
+inline void Blend::scalar_rgb565(uint16_t *dst, uint16_t const *src,
+                                 unsigned char const *alpha, int n)
+{
+	using Genode::Pixel_rgb565;
+
+	Pixel_rgb565       *d = (Pixel_rgb565 *)dst;
+	Pixel_rgb565 const *s = (Pixel_rgb565 const *)src;
+
+	for (; n-- > 0; d++, s++, alpha++)
+		if (*alpha)
+			*d = Pixel_rgb565::mix(*d, *s, *alpha);
+}
+
+
+inline void Blend::scalar_rgb888(uint32_t *dst, uint32_t const *src,
+                                 unsigned char const *alpha, int n)
+{
+	using Genode::Pixel_rgb888;
+
+	Pixel_rgb888       *d = (Pixel_rgb888 *)dst;
+	Pixel_rgb888 const *s = (Pixel_rgb888 const *)src;
+
+	for (; n-- > 0; d++, s++, alpha++)
+		if (*alpha)
+			*d = Pixel_rgb888::mix(*d, *s, *alpha);
+}
+
+
+inline void Blend::scalar_avr_rgb565(uint16_t *dst, uint16_t const *src,
+                                     uint16_t mix, int n)
+{
+	using Genode::Pixel_rgb565;
+
+	Pixel_rgb565 mix_pixel;
+	mix_pixel.pixel = mix;
+
+	Pixel_rgb565       *d = (Pixel_rgb565 *)dst;
+	Pixel_rgb565 const *s = (Pixel_rgb565 const *)src;
+
+	for (; n-- > 0; d++, s++)
+		*d = Pixel_rgb565::avr(mix_pixel, *s);
+}
+
+
+/*
+ * The kernels are always inlined into functions compiled for the respective
+ * instruction set. So the ABI for passing vectors does not matter.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/**
+ * Blending kernels for vectors of 16-bit and 32-bit lanes
+ *
+ * All functions are forcibly inlined so that they are compiled for the
+ * instruction set of the function that instantiates them. Vectors are
+ * passed by reference only. The ABI of passing vectors by value depends on
+ * the instruction set, and GCC reports the out-of-line variants of such
+ * functions at the end of the compilation unit, beyond the scope of the
+ * diagnostic pragmas.
+ */
+template <typename V16, typename V32>
+struct Blend::Vector_kernels
+{
+	enum { N16 = sizeof(V16)/2, N32 = sizeof(V32)/4 };
+
+	#define ALWAYS_INLINE static inline __attribute__((always_inline))
+
+	template <typename V>
+	ALWAYS_INLINE void _load(V &v, void const *p) { __builtin_memcpy(&v, p, sizeof(v)); }
+
+	template <typename V>
+	ALWAYS_INLINE void _store(void *p, V const &v) { __builtin_memcpy(p, &v, sizeof(v)); }
+
+	/**
+	 * Return true if all 'n' alpha values are zero
+	 */
+	ALWAYS_INLINE bool _transparent(unsigned char const *alpha, unsigned n)
+	{
+		uint64_t any = 0;
+		for (unsigned i = 0; i < n; i += 8) {
+			uint64_t v = 0;
+			_load(v, alpha + i);
+			any |= v;
+		}
+		return any == 0;
+	}
+
+	template <typename V>
+	ALWAYS_INLINE void _alpha(V &v, unsigned char const *alpha)
+	{
+		for (unsigned i = 0; i < sizeof(V)/sizeof(v[0]); i++)
+			v[i] = alpha[i];
+	}
+
+	/**
+	 * Counterpart of 'Pixel_rgb565::mix'
+	 *
+	 * The red and blue channels are scaled by the alpha value shifted to 5
+	 * bits, the green channel by the 8-bit alpha value. Channel-wise, the
+	 * products fit into 16 bits and the sums never exceed the channel
+	 * width, which makes the result equal to the packed scalar arithmetics.
+	 */
+	ALWAYS_INLINE void _mix_rgb565(V16 &m, V16 const &d, V16 const &s,
+	                               V16 const &a)
+	{
+		V16 const ad = 264 - a, ad5 = ad >> 3;
+		V16 const as = a,       as5 = as >> 3;
+
+		V16 const r = ((ad5*(d >> 11)) >> 5)
+		            + ((as5*(s >> 11)) >> 5);
+		V16 const g = ((ad*((d >> 6) & 0x1f)) >> 8)
+		            + ((as*((s >> 6) & 0x1f)) >> 8);
+		V16 const b = ((ad5*(d & 0x1f)) >> 5)
+		            + ((as5*(s & 0x1f)) >> 5);
+
+		m = (r << 11) | (g << 6) | b;
+	}
+
+	/**
+	 * Counterpart of 'Pixel_rgb888::blend'
+	 */
+	ALWAYS_INLINE void _blend_rgb888(V32 &b, V32 const &p, V32 const &a)
+	{
+		b = ((a*((p & 0xff00) >> 8)) & 0xff00)
+		  | (((a*(p & 0xff00ff)) >> 8) & 0xff00ff);
+	}
+
+	ALWAYS_INLINE void rgb565(uint16_t *dst, uint16_t const *src,
+	                          unsigned char const *alpha, int n)
+	{
+		for (; n >= N16; n -= N16, dst += N16, src += N16, alpha += N16) {
+
+			if (_transparent(alpha, N16))
+				continue;
+
+			V16 a { }, d { }, s { }, m { };
+			_alpha(a, alpha);
+			_load(d, dst);
+			_load(s, src);
+			_mix_rgb565(m, d, s, a);
+
+			/* keep destination pixels with an alpha value of zero */
+			V16 const keep = (V16)(a == 0);
+			_store(dst, (d & keep) | (m & ~keep));
+		}
+		scalar_rgb565(dst, src, alpha, n);
+	}
+
+	ALWAYS_INLINE void rgb888(uint32_t *dst, uint32_t const *src,
+	                          unsigned char const *alpha, int n)
+	{
+		for (; n >= N32; n -= N32, dst += N32, src += N32, alpha += N32) {
+
+			if (N32 % 8 == 0 && _transparent(alpha, N32))
+				continue;
+
+			V32 a { }, d { }, s { }, bd { }, bs { };
+			_alpha(a, alpha);
+			_load(d, dst);
+			_load(s, src);
+			_blend_rgb888(bd, d, 255 - a);
+			_blend_rgb888(bs, s, a);
+
+			V32 const m = bd + bs;
+
+			V32 const keep = (V32)(a == 0);
+			_store(dst, (d & keep) | (m & ~keep));
+		}
+		scalar_rgb888(dst, src, alpha, n);
+	}
+
+	ALWAYS_INLINE void avr_rgb565(uint16_t *dst, uint16_t const *src,
+	                              uint16_t mix, int n)
+	{
+		V16 const m = ((mix & 0xf7df) >> 1) + (V16){ };
+
+		for (; n >= N16; n -= N16, dst += N16, src += N16) {
+			V16 s { };
+			_load(s, src);
+			_store(dst, m + ((s & 0xf7df) >> 1));
+		}
+
+		scalar_avr_rgb565(dst, src, mix, n);
+	}
+
+	#undef ALWAYS_INLINE
+};
+
+#pragma GCC diagnostic pop
+
+#endif /* _LIB__BLIT__BLEND_KERNELS_H_ */
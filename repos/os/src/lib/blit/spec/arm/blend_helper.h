@@ -0,0 +1,59 @@
+/*
+ * \brief  Selection of blending functions for ARM
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The NEON unit cannot be probed from user level. Hence, the NEON kernels
+ * are used only if the library is compiled for a CPU that features NEON.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__SPEC__ARM__BLEND_HELPER_H_
+#define _LIB__BLIT__SPEC__ARM__BLEND_HELPER_H_
+
+#include <blend_kernels.h>
+
+#ifdef __ARM_NEON__
+
+namespace Blend {
+
+	typedef uint16_t Neon_u16 __attribute__((vector_size(16)));
+	typedef uint32_t Neon_u32 __attribute__((vector_size(16)));
+
+	typedef Vector_kernels<Neon_u16, Neon_u32> Neon;
+
+	static void neon_rgb565(uint16_t *dst, uint16_t const *src,
+	                        unsigned char const *alpha, int n) {
+		Neon::rgb565(dst, src, alpha, n); }
+
+	static void neon_rgb888(uint32_t *dst, uint32_t const *src,
+	                        unsigned char const *alpha, int n) {
+		Neon::rgb888(dst, src, alpha, n); }
+
+	static void neon_avr_rgb565(uint16_t *dst, uint16_t const *src,
+	                            uint16_t mix, int n) {
+		Neon::avr_rgb565(dst, src, mix, n); }
+}
+
+static inline Blend::Functions select_blend_functions()
+{
+	return { Blend::neon_rgb565, Blend::neon_rgb888, Blend::neon_avr_rgb565 };
+}
+
+#else
+
+static inline Blend::Functions select_blend_functions()
+{
+	return { Blend::scalar_rgb565, Blend::scalar_rgb888,
+	         Blend::scalar_avr_rgb565 };
+}
+
+#endif /* __ARM_NEON__ */
+
+#endif /* _LIB__BLIT__SPEC__ARM__BLEND_HELPER_H_ */
@@ -0,0 +1,125 @@
+/*
+ * \brief  Selection of blending functions for x86
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The SSE2 and AVX2 variants of the kernels are compiled for the respective
+ * instruction set regardless of the compiler flags and are selected at
+ * runtime according to the features reported by the CPU.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _LIB__BLIT__SPEC__X86__BLEND_HELPER_H_
+#define _LIB__BLIT__SPEC__X86__BLEND_HELPER_H_
+
+#include <blend_kernels.h>
+
+namespace Blend {
+
+	typedef uint16_t Sse2_u16 __attribute__((vector_size(16)));
+	typedef uint32_t Sse2_u32 __attribute__((vector_size(16)));
+	typedef uint16_t Avx2_u16 __attribute__((vector_size(32)));
+	typedef uint32_t Avx2_u32 __attribute__((vector_size(32)));
+
+	typedef Vector_kernels<Sse2_u16, Sse2_u32> Sse2;
+	typedef Vector_kernels<Avx2_u16, Avx2_u32> Avx2;
+
+	#define SSE2 __attribute__((target("sse2")))
+	#define AVX2 __attribute__((target("avx2")))
+
+	SSE2 static void sse2_rgb565(uint16_t *dst, uint16_t const *src,
+	                             unsigned char const *alpha, int n) {
+		Sse2::rgb565(dst, src, alpha, n); }
+
+	SSE2 static void sse2_rgb888(uint32_t *dst, uint32_t const *src,
+	                             unsigned char const *alpha, int n) {
+		Sse2::rgb888(dst, src, alpha, n); }
+
+	SSE2 static void sse2_avr_rgb565(uint16_t *dst, uint16_t const *src,
+	                                 uint16_t mix, int n) {
+		Sse2::avr_rgb565(dst, src, mix, n); }
+
+	AVX2 static void avx2_rgb565(uint16_t *dst, uint16_t const *src,
+	                             unsigned char const *alpha, int n) {
+		Avx2::rgb565(dst, src, alpha, n); }
+
+	AVX2 static void avx2_rgb888(uint32_t *dst, uint32_t const *src,
+	                             unsigned char const *alpha, int n) {
+		Avx2::rgb888(dst, src, alpha, n); }
+
+	AVX2 static void avx2_avr_rgb565(uint16_t *dst, uint16_t const *src,
+	                                 uint16_t mix, int n) {
+		Avx2::avr_rgb565(dst, src, mix, n); }
+
+	#undef SSE2
+	#undef AVX2
+
+	struct Cpuid { unsigned eax, ebx, ecx, edx; };
+
+	/**
+	 * Execute CPUID instruction
+	 *
+	 * On x86_32, the 'ebx' register may be reserved for the GOT pointer and
+	 * is therefore preserved explicitly.
+	 */
+	static inline Cpuid cpuid(unsigned leaf)
+	{
+		Cpuid r;
+#ifdef __x86_64__
+		asm volatile ("cpuid"
+		              : "=a" (r.eax), "=b" (r.ebx), "=c" (r.ecx), "=d" (r.edx)
+		              : "a" (leaf), "c" (0));
+#else
+		asm volatile ("xchg %%ebx, %%esi; cpuid; xchg %%ebx, %%esi"
+		              : "=a" (r.eax), "=S" (r.ebx), "=c" (r.ecx), "=d" (r.edx)
+		              : "a" (leaf), "c" (0));
+#endif
+		return r;
+	}
+
+	static inline bool sse2_supported() { return cpuid(1).edx & (1 << 26); }
+
+	/**
+	 * Return true if the CPU supports AVX2 and the kernel saves the AVX state
+	 */
+	static inline bool avx2_supported()
+	{
+		if (cpuid(0).eax < 7)
+			return false;
+
+		/* OSXSAVE and AVX */
+		unsigned const avx = (1 << 27) | (1 << 28);
+		if ((cpuid(1).ecx & avx) != avx)
+			return false;
+
+		/* SSE and AVX state enabled in XCR0 */
+		unsigned xcr0_lo, xcr0_hi;
+		asm volatile ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+		if ((xcr0_lo & 6) != 6)
+			return false;
+
+		return cpuid(7).ebx & (1 << 5);
+	}
+}
+
+
+static inline Blend::Functions select_blend_functions()
+{
+	using namespace Blend;
+
+	if (avx2_supported())
+		return { avx2_rgb565, avx2_rgb888, avx2_avr_rgb565 };
+
+	if (sse2_supported())
+		return { sse2_rgb565, sse2_rgb888, sse2_avr_rgb565 };
+
+	return { scalar_rgb565, scalar_rgb888, scalar_avr_rgb565 };
+}
+
+#endif /* _LIB__BLIT__SPEC__X86__BLEND_HELPER_H_ */
@@ -134,7 +134,7 @@ Ipv4_address Ipv4_packet::ip_from_string(const char *ip)
 Genode::uint16_t Ipv4_packet::calculate_checksum(Ipv4_packet const &packet)
 {
 	Genode::uint16_t const *data = (Genode::uint16_t *)&packet;
-	Genode::uint32_t const sum = host_to_big_endian(data[0])
+	Genode::uint32_t       sum = host_to_big_endian(data[0])
 	                           + host_to_big_endian(data[1])
 	                           + host_to_big_endian(data[2])
 	                           + host_to_big_endian(data[3])
@@ -143,7 +143,10 @@ Genode::uint16_t Ipv4_packet::calculate_checksum(Ipv4_packet const &packet)
 	                           + host_to_big_endian(data[7])
 	                           + host_to_big_endian(data[8])
 	                           + host_to_big_endian(data[9]);
-	return ~((0xFFFF & sum) + (sum >> 16));
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return ~sum;
 }
 
 
@@ -49,6 +49,13 @@ class Vfs::Fs_file_system : public File_system
 		typedef Genode::String<::File_system::MAX_NAME_LEN> Root_string;
 		Root_string _root;
 
+		/*
+		 * Maximum numbers of READ packets in flight per handle for
+		 * sequential reads and of WRITE packets not yet acknowledged
+		 */
+		unsigned const _read_ahead;
+		unsigned const _write_behind;
+
 		::File_system::Connection _fs;
 
 		typedef Genode::Id_space<::File_system::Node> Handle_space;
@@ -61,11 +68,60 @@ class Vfs::Fs_file_system : public File_system
 			Read_ready_state read_ready_state = Read_ready_state::IDLE;
 
 			enum class Queued_state { IDLE, QUEUED, ACK };
-			Queued_state queued_read_state = Queued_state::IDLE;
 			Queued_state queued_sync_state = Queued_state::IDLE;
 
-			::File_system::Packet_descriptor queued_read_packet;
 			::File_system::Packet_descriptor queued_sync_packet;
+
+			/*
+			 * Limits of the read and write pipelines, assigned by
+			 * 'Fs_file_system' for file handles
+			 */
+			unsigned read_ahead_max   = 1;
+			unsigned write_behind_max = 1;
+
+			/* WRITE packets not yet acknowledged by the server */
+			unsigned writes_in_flight = 0;
+
+			/* a WRITE packet failed since the last 'write' call */
+			bool write_failed = false;
+		};
+
+		enum { MAX_READ_AHEAD = 8, MAX_WRITE_BEHIND = 16 };
+
+		/**
+		 * READ packet of the read pipeline of a handle
+		 */
+		struct Read_slot
+		{
+			/*
+			 * A slot becomes 'STALE' if its data is no longer of interest
+			 * while the packet is still owned by the server. The packet is
+			 * released as soon as it is acknowledged.
+			 */
+			enum class State { FREE, QUEUED, ACK, STALE };
+
+			State                            state     = State::FREE;
+			::File_system::Packet_descriptor packet    { };
+			file_size                        requested = 0;
+
+			bool active() const {
+				return state == State::QUEUED || state == State::ACK; }
+
+			/**
+			 * Return true if the slot holds or will hold the data at 'pos'
+			 */
+			bool covers(file_size pos) const
+			{
+				if (!active() || pos < packet.position())
+					return false;
+
+				file_size const length = (state == State::ACK)
+				                       ? packet.length() : requested;
+
+				/* an empty acknowledged packet marks the end of the file */
+				return pos < packet.position() + length
+				    || pos == packet.position();
+			}
 		};
 
 		struct Fs_vfs_handle : Vfs_handle, ::File_system::Node,
@@ -74,62 +130,195 @@ class Vfs::Fs_file_system : public File_system
 			::File_system::Connection &_fs;
 			Io_response_handler       &_io_handler;
 
-			bool _queue_read(file_size count, file_size const seek_offset)
+			/*
+			 * Sequential reads are served from a window of READ packets
+			 * submitted ahead of the client. The window starts at the
+			 * packet of the demanded data only and is doubled with each
+			 * sequential read up to 'read_ahead_max'. A non-sequential read
+			 * drops the pipeline and shrinks the window again.
+			 */
+			Read_slot _read_slots[MAX_READ_AHEAD];
+			unsigned  _read_window     = 1;
+			file_size _read_ahead_pos  = 0; /* end of last submitted READ */
+			file_size _read_ahead_size = 0; /* size of read-ahead packets */
+			file_size _last_read_end   = ~(file_size)0;
+
+			enum { MIN_READ_AHEAD_SIZE = 4096 };
+
+			Read_slot *_read_slot_at(file_size pos)
 			{
-				if (queued_read_state != Handle_state::Queued_state::IDLE)
-					return false;
+				for (Read_slot &slot : _read_slots)
+					if (slot.covers(pos))
+						return &slot;
+				return nullptr;
+			}
+
+			unsigned _active_read_slots() const
+			{
+				unsigned cnt = 0;
+				for (Read_slot const &slot : _read_slots)
+					if (slot.active()) cnt++;
+				return cnt;
+			}
+
+			/**
+			 * Return bulk-buffer space occupied by the packets of the window
+			 */
+			file_size _read_window_bytes() const
+			{
+				file_size bytes = 0;
+				for (Read_slot const &slot : _read_slots)
+					if (slot.active()) bytes += slot.requested;
+				return bytes;
+			}
+
+			void _release_read_slot(Read_slot &slot)
+			{
+				_fs.tx()->release_packet(slot.packet);
+				slot = Read_slot();
+			}
+
+			bool _submit_read(file_size pos, file_size count)
+			{
+				Read_slot *slot = nullptr;
+				for (Read_slot &s : _read_slots)
+					if (s.state == Read_slot::State::FREE) { slot = &s; break; }
+
+				if (!slot) return false;
 
 				::File_system::Session::Tx::Source &source = *_fs.tx();
 
-				/* if not ready to submit suggest retry */
 				if (!source.ready_to_submit()) return false;
 
-				file_size const max_packet_size = source.bulk_buffer_size() / 2;
-				file_size const clipped_count = min(max_packet_size, count);
-
 				::File_system::Packet_descriptor p;
 				try {
-					p = source.alloc_packet(clipped_count);
+					p = source.alloc_packet(count);
 				} catch (::File_system::Session::Tx::Source::Packet_alloc_failed) {
 					return false;
 				}
 
-				::File_system::Packet_descriptor const
-					packet(p, file_handle(),
-					       ::File_system::Packet_descriptor::READ,
-					       clipped_count, seek_offset);
+				slot->packet    = ::File_system::Packet_descriptor(p, file_handle(),
+				                  ::File_system::Packet_descriptor::READ,
+				                  count, pos);
+				slot->requested = count;
+				slot->state     = Read_slot::State::QUEUED;
 
-				read_ready_state  = Handle_state::Read_ready_state::IDLE;
-				queued_read_state = Handle_state::Queued_state::QUEUED;
+				_read_ahead_pos = pos + count;
 
 				/* pass packet to server side */
-				source.submit_packet(packet);
+				source.submit_packet(slot->packet);
+
+				return true;
+			}
+
+			/**
+			 * Fill the read window with read-ahead packets
+			 *
+			 * Read-ahead is opportunistic. If the packet stream lacks
+			 * space, the pipeline stays shorter. A window of one packet
+			 * means no read-ahead.
+			 *
+			 * The packets of the window, including the packet of the
+			 * demanded data, occupy at most half of the bulk buffer.
+			 */
+			void _read_ahead()
+			{
+				if (_read_window < 2 || !_read_ahead_size)
+					return;
+
+				file_size const max_window_bytes = _fs.tx()->bulk_buffer_size() / 2;
+
+				while (_active_read_slots() < _read_window
+				    && _read_window_bytes() + _read_ahead_size <= max_window_bytes)
+					if (!_submit_read(_read_ahead_pos, _read_ahead_size))
+						break;
+			}
+
+			bool _queue_read(file_size count, file_size const seek_offset)
+			{
+				::File_system::Session::Tx::Source &source = *_fs.tx();
+
+				file_size const max_packet_size = source.bulk_buffer_size() / 2;
+
+				if (!_read_slot_at(seek_offset)) {
+
+					/* drop read-ahead data of the previous access pattern */
+					discard_read_ahead();
+
+					if (!_submit_read(seek_offset, min(max_packet_size, count)))
+						return false;
+				}
+
+				/*
+				 * The read-ahead packets share the space of the window left
+				 * by the demanded packet, see '_read_ahead'.
+				 */
+				_read_window = (seek_offset == _last_read_end)
+				             ? min(2*_read_window, read_ahead_max) : 1;
+
+				_read_ahead_size =
+					min(Genode::max(count, (file_size)MIN_READ_AHEAD_SIZE),
+					    max_packet_size / read_ahead_max);
+
+				_read_ahead();
+
+				read_ready_state = Handle_state::Read_ready_state::IDLE;
 
 				return true;
 			}
 
 			Read_result _complete_read(void *dst, file_size count,
+			                           file_size const seek_offset,
 			                           file_size &out_count)
 			{
-				if (queued_read_state != Handle_state::Queued_state::ACK)
+				Read_slot *slot = _read_slot_at(seek_offset);
+				if (!slot)
+					return READ_ERR_INVALID;
+
+				if (slot->state != Read_slot::State::ACK)
 					return READ_QUEUED;
 
-				/* obtain result packet descriptor with updated status info */
-				::File_system::Packet_descriptor const
-					packet = queued_read_packet;
+				::File_system::Session::Tx::Source &source = *_fs.tx();
 
-				file_size const read_num_bytes = min(packet.length(), count);
+				/* gather data from consecutive acknowledged packets */
+				file_size pos = seek_offset;
+				out_count = 0;
+				while (slot && slot->state == Read_slot::State::ACK
+				    && out_count < count) {
 
-				::File_system::Session::Tx::Source &source = *_fs.tx();
+					::File_system::Packet_descriptor const &packet = slot->packet;
 
-				memcpy(dst, source.packet_content(packet), read_num_bytes);
+					file_size const end = packet.position() + packet.length();
+					file_size const num_bytes = min(count - out_count, end - pos);
 
-				queued_read_state  = Handle_state::Queued_state::IDLE;
-				queued_read_packet = ::File_system::Packet_descriptor();
+					memcpy((char *)dst + out_count,
+					       source.packet_content(packet) + (pos - packet.position()),
+					       num_bytes);
 
-				out_count  = read_num_bytes;
+					out_count += num_bytes;
+					pos       += num_bytes;
 
-				source.release_packet(packet);
+					/*
+					 * A short read denotes the end of the file or an error.
+					 * The data of the subsequent packets cannot be used.
+					 */
+					bool const short_read = packet.length() < slot->requested;
+
+					if (short_read)
+						discard_read_ahead(slot);
+
+					if (pos == end)
+						_release_read_slot(*slot);
+
+					if (short_read)
+						break;
+
+					slot = _read_slot_at(pos);
+				}
+
+				_last_read_end = pos;
+
+				_read_ahead();
 
 				/*
 				 * Notify anyone who might have failed on
@@ -151,9 +340,68 @@ class Vfs::Fs_file_system : public File_system
 				_fs(fs_connection), _io_handler(io_handler)
 			{ }
 
+			~Fs_vfs_handle()
+			{
+				/*
+				 * Packets still owned by the server are released by the
+				 * ack handler, which no longer finds the handle.
+				 */
+				for (Read_slot &slot : _read_slots)
+					if (slot.state == Read_slot::State::ACK)
+						_release_read_slot(slot);
+			}
+
 			::File_system::File_handle file_handle() const
 			{ return ::File_system::File_handle { id().value }; }
 
+			/**
+			 * Drop data read ahead, e.g., because the file was modified
+			 *
+			 * \param keep  slot to retain
+			 */
+			void discard_read_ahead(Read_slot const *keep = nullptr)
+			{
+				for (Read_slot &slot : _read_slots) {
+					if (&slot == keep)
+						continue;
+
+					if (slot.state == Read_slot::State::ACK)
+						_release_read_slot(slot);
+					else if (slot.state == Read_slot::State::QUEUED)
+						slot.state = Read_slot::State::STALE;
+				}
+				_read_window = 1;
+			}
+
+			/**
+			 * Account acknowledged READ packet
+			 *
+			 * \return false if the packet belongs to no read slot of the
+			 *         handle and must be released by the caller
+			 */
+			bool read_acked(::File_system::Packet_descriptor const &packet)
+			{
+				for (Read_slot &slot : _read_slots) {
+
+					if (slot.state != Read_slot::State::QUEUED
+					 && slot.state != Read_slot::State::STALE)
+						continue;
+
+					if (slot.packet.offset() != packet.offset())
+						continue;
+
+					if (slot.state == Read_slot::State::STALE) {
+						_release_read_slot(slot);
+						return true;
+					}
+
+					slot.packet = packet;
+					slot.state  = Read_slot::State::ACK;
+					return true;
+				}
+				return false;
+			}
+
 			virtual bool queue_read(file_size count)
 			{
 				Genode::error("Fs_vfs_handle::queue_read() called");
@@ -234,7 +482,7 @@ class Vfs::Fs_file_system : public File_system
 			Read_result complete_read(char *dst, file_size count,
 			                          file_size &out_count) override
 			{
-				return _complete_read(dst, count, out_count);
+				return _complete_read(dst, count, seek(), out_count);
 			}
 		};
 
@@ -242,15 +490,27 @@ class Vfs::Fs_file_system : public File_system
 		{
 			enum { DIRENT_SIZE = sizeof(::File_system::Directory_entry) };
 
+			/*
+			 * Entries are requested in batches. The entries of a batch not
+			 * yet consumed are kept by the read slot of the batch.
+			 */
+			enum { DIRENT_BATCH = 64 };
+
 			using Fs_vfs_handle::Fs_vfs_handle;
 
+			file_size _entry_offset() const {
+				return seek() / sizeof(Dirent) * DIRENT_SIZE; }
+
 			bool queue_read(file_size count) override
 			{
 				if (count < sizeof(Dirent))
 					return true;
 
-				return _queue_read(DIRENT_SIZE,
-				                   (seek() / sizeof(Dirent) * DIRENT_SIZE));
+				/* re-read the directory if not listed sequentially */
+				if (_entry_offset() != _last_read_end)
+					discard_read_ahead();
+
+				return _queue_read(DIRENT_BATCH*DIRENT_SIZE, _entry_offset());
 			}
 
 			Read_result complete_read(char *dst, file_size count,
@@ -265,7 +525,8 @@ class Vfs::Fs_file_system : public File_system
 				file_size       entry_out_count;
 
 				Read_result read_result =
-					_complete_read(&entry, DIRENT_SIZE, entry_out_count);
+					_complete_read(&entry, DIRENT_SIZE, _entry_offset(),
+					               entry_out_count);
 
 				if (read_result != READ_OK)
 					return read_result;
@@ -315,7 +576,7 @@ class Vfs::Fs_file_system : public File_system
 			Read_result complete_read(char *dst, file_size count,
 			                          file_size &out_count) override
 			{
-				return _complete_read(dst, count, out_count);
+				return _complete_read(dst, count, seek(), out_count);
 			}
 		};
 
@@ -414,55 +675,6 @@ class Vfs::Fs_file_system : public File_system
 
 		Post_signal_hook _post_signal_hook { _env.ep(), _io_handler };
 
-		file_size _read(Fs_vfs_handle &handle, void *buf,
-		                file_size const count, file_size const seek_offset)
-		{
-			::File_system::Session::Tx::Source &source = *_fs.tx();
-			using ::File_system::Packet_descriptor;
-
-			file_size const max_packet_size = source.bulk_buffer_size() / 2;
-			file_size const clipped_count = min(max_packet_size, count);
-
-			/* XXX check if alloc_packet() and submit_packet() will succeed! */
-
-			Packet_descriptor const packet_in(source.alloc_packet(clipped_count),
-			                                  handle.file_handle(),
-			                                  Packet_descriptor::READ,
-			                                  clipped_count,
-			                                  seek_offset);
-
-			/* wait until packet was acknowledged */
-			handle.queued_read_state = Handle_state::Queued_state::QUEUED;
-
-			/* pass packet to server side */
-			source.submit_packet(packet_in);
-
-			while (handle.queued_read_state != Handle_state::Queued_state::ACK) {
-				_env.ep().wait_and_dispatch_one_io_signal();
-			}
-
-			/* obtain result packet descriptor with updated status info */
-			Packet_descriptor const packet_out = handle.queued_read_packet;
-
-			handle.queued_read_state  = Handle_state::Queued_state::IDLE;
-			handle.queued_read_packet = Packet_descriptor();
-
-			if (!packet_out.succeeded()) {
-				/* could be EOF or a real error */
-				::File_system::Status status = _fs.status(handle.file_handle());
-				if (seek_offset < status.size)
-					Genode::warning("unexpected failure on file-system read");
-			}
-
-			file_size const read_num_bytes = min(packet_out.length(), count);
-
-			memcpy(buf, source.packet_content(packet_out), read_num_bytes);
-
-			source.release_packet(packet_out);
-
-			return read_num_bytes;
-		}
-
 		file_size _write(Fs_vfs_handle &handle,
 		                 const char *buf, file_size count, file_size seek_offset)
 		{
@@ -472,9 +684,16 @@ class Vfs::Fs_file_system : public File_system
 			file_size const max_packet_size = source.bulk_buffer_size() / 2;
 			count = min(max_packet_size, count);
 
+			/* limit the number of writes not yet acknowledged */
+			if (handle.writes_in_flight >= handle.write_behind_max)
+				throw Insufficient_buffer();
+
 			if (!source.ready_to_submit())
 				throw Insufficient_buffer();
 
+			/* data read ahead may predate the write */
+			handle.discard_read_ahead();
+
 			try {
 				Packet_descriptor packet_in(source.alloc_packet(count),
 				                            handle.file_handle(),
@@ -486,6 +705,8 @@ class Vfs::Fs_file_system : public File_system
 
 				/* pass packet to server side */
 				source.submit_packet(packet_in);
+
+				handle.writes_in_flight++;
 			} catch (::File_system::Session::Tx::Source::Packet_alloc_failed) {
 				throw Insufficient_buffer();
 			} catch (...) {
@@ -506,6 +727,12 @@ class Vfs::Fs_file_system : public File_system
 
 				Handle_space::Id const id(packet.handle());
 
+				Lock::Guard guard(_lock);
+
+				/* READ packets of read slots are released by the handle */
+				bool release = (packet.operation() == Packet_descriptor::WRITE)
+				            || (packet.operation() == Packet_descriptor::READ);
+
 				try {
 					_handle_space.apply<Fs_vfs_handle>(id, [&] (Fs_vfs_handle &handle)
 					{
@@ -516,12 +743,17 @@ class Vfs::Fs_file_system : public File_system
 							break;
 
 						case Packet_descriptor::READ:
-							handle.queued_read_packet = packet;
-							handle.queued_read_state  = Handle_state::Queued_state::ACK;
+							release = !handle.read_acked(packet);
 							_post_signal_hook.arm(handle.context);
 							break;
 
 						case Packet_descriptor::WRITE:
+							if (handle.writes_in_flight)
+								handle.writes_in_flight--;
+
+							if (!packet.succeeded())
+								handle.write_failed = true;
+
 							/*
 							 * Notify anyone who might have failed on
 							 * 'alloc_packet()' or 'submit_packet()'
@@ -531,6 +763,7 @@ class Vfs::Fs_file_system : public File_system
 							break;
 
 						case Packet_descriptor::CONTENT_CHANGED:
+							handle.discard_read_ahead();
 							_post_signal_hook.arm(handle.context);
 							break;
 
@@ -542,11 +775,17 @@ class Vfs::Fs_file_system : public File_system
 						}
 					});
 				} catch (Handle_space::Unknown_id) {
-					Genode::warning("ack for unknown VFS handle"); }
 
-				if (packet.operation() == Packet_descriptor::WRITE) {
-					Lock::Guard guard(_lock);
+					/* outstanding reads and writes of a closed handle */
+					if (!release)
+						Genode::warning("ack for unknown VFS handle");
+				}
+
+				if (release) {
 					source.release_packet(packet);
+
+					/* notify anyone who might have failed on 'alloc_packet()' */
+					_post_signal_hook.arm(nullptr);
 				}
 			}
 		}
@@ -554,8 +793,35 @@ class Vfs::Fs_file_system : public File_system
 		Genode::Io_signal_handler<Fs_file_system> _ack_handler {
 			_env.ep(), *this, &Fs_file_system::_handle_ack };
 
+		enum { DEFAULT_TX_BUF_SIZE = ::File_system::DEFAULT_TX_BUF_SIZE };
+
+		typedef Genode::Number_of_bytes Number_of_bytes;
+
+		static unsigned _window(Xml_node config, char const *attr,
+		                        unsigned default_value, unsigned max_value)
+		{
+			unsigned const value = config.attribute_value(attr, default_value);
+			return Genode::max(1U, min(value, max_value));
+		}
+
 	public:
 
+		/**
+		 * Constructor
+		 *
+		 * Besides 'label', 'root', and 'writeable', the '<fs>' node
+		 * supports the following attributes:
+		 *
+		 * 'buffer_size'   size of the bulk buffer of the session
+		 * 'read_ahead'    maximum number of READ packets in flight per
+		 *                 handle for sequential reads, '1' disables
+		 *                 read-ahead
+		 * 'write_behind'  maximum number of WRITE packets per handle
+		 *                 not yet acknowledged by the server
+		 *
+		 * The packets of the read-ahead window of a handle share half of
+		 * the bulk buffer. Hence, large windows call for a larger buffer.
+		 */
 		Fs_file_system(Genode::Env         &env,
 		               Genode::Allocator   &alloc,
 		               Genode::Xml_node     config,
@@ -566,10 +832,13 @@ class Vfs::Fs_file_system : public File_system
 			_io_handler(io_handler),
 			_label(config.attribute_value("label", Label_string())),
 			_root( config.attribute_value("root",  Root_string())),
+			_read_ahead  (_window(config, "read_ahead",   4, MAX_READ_AHEAD)),
+			_write_behind(_window(config, "write_behind", 8, MAX_WRITE_BEHIND)),
 			_fs(env, _fs_packet_alloc,
 			    _label.string(), _root.string(),
 			    config.attribute_value("writeable", true),
-			    ::File_system::DEFAULT_TX_BUF_SIZE)
+			    config.attribute_value("buffer_size",
+			                           Number_of_bytes(DEFAULT_TX_BUF_SIZE)))
 		{
 			_fs.sigh_ack_avail(_ack_handler);
 		}
@@ -752,9 +1021,14 @@ class Vfs::Fs_file_system : public File_system
 				                                           file_name.base() + 1,
 				                                           mode, create);
 
-				*out_handle = new (alloc)
+				Fs_vfs_file_handle *handle = new (alloc)
 					Fs_vfs_file_handle(*this, alloc, vfs_mode, _handle_space,
 					                   file, _fs, _io_handler);
+
+				handle->read_ahead_max   = _read_ahead;
+				handle->write_behind_max = _write_behind;
+
+				*out_handle = handle;
 			}
 			catch (::File_system::Lookup_failed)       { return OPEN_ERR_UNACCESSIBLE;  }
 			catch (::File_system::Permission_denied)   { return OPEN_ERR_NO_PERM;       }
@@ -868,6 +1142,12 @@ class Vfs::Fs_file_system : public File_system
 
 			Fs_vfs_handle &handle = static_cast<Fs_vfs_handle &>(*vfs_handle);
 
+			/* report the failure of a previous write-behind packet */
+			if (handle.write_failed) {
+				handle.write_failed = false;
+				return WRITE_ERR_IO;
+			}
+
 			out_count = _write(handle, buf, buf_size, handle.seek());
 
 			return WRITE_OK;
@@ -932,7 +1212,11 @@ class Vfs::Fs_file_system : public File_system
 
 		Ftruncate_result ftruncate(Vfs_handle *vfs_handle, file_size len) override
 		{
-			Fs_vfs_handle const *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+			Lock::Guard guard(_lock);
+
+			Fs_vfs_handle *handle = static_cast<Fs_vfs_handle *>(vfs_handle);
+
+			handle->discard_read_ahead();
 
 			try {
 				_fs.truncate(handle->file_handle(), len);
@@ -15,9 +15,9 @@
 #define _INCLUDE__VFS__RAM_FILE_SYSTEM_H_
 
 #include <ram_fs/chunk.h>
+#include <ram_fs/directory_index.h>
 #include <vfs/file_system.h>
 #include <dataspace/client.h>
-#include <util/avl_tree.h>
 
 namespace Vfs_ram {
 
@@ -52,7 +52,8 @@ namespace Vfs_ram {
 namespace Vfs { class Ram_file_system; }
 
 
-class Vfs_ram::Node : public Genode::Avl_node<Node>, public Genode::Lock
+class Vfs_ram::Node : public ::File_system::Directory_index<Node>::Element,
+                      public Genode::Lock
 {
 	private:
 
@@ -122,45 +123,6 @@ class Vfs_ram::Node : public Genode::Avl_node<Node>, public Genode::Lock
 			Genode::error("Vfs_ram::Node::truncate() called");
 		}
 
-		/************************
-		 ** Avl node interface **
-		 ************************/
-
-		bool higher(Node *c) { return (strcmp(c->_name, _name) > 0); }
-
-		/**
-		 * Find index N by walking down the tree N times,
-		 * not the most efficient way to do this.
-		 */
-		Node *index(file_offset &i)
-		{
-			if (i-- == 0)
-				return this;
-
-			Node *n;
-
-			n = child(LEFT);
-			if (n)
-				n = n->index(i);
-
-			if (n) return n;
-
-			n = child(RIGHT);
-			if (n)
-				n = n->index(i);
-
-			return n;
-		}
-
-		Node *sibling(const char *name)
-		{
-			if (strcmp(name, _name) == 0) return this;
-
-			Node *c =
-				Avl_node<Node>::child(strcmp(name, _name) > 0);
-			return c ? c->sibling(name) : nullptr;
-		}
-
 		struct Guard
 		{
 			Node *node;
@@ -184,12 +146,19 @@ class Vfs_ram::File : public Vfs_ram::Node
 		Chunk_level_0 _chunk;
 		file_size     _length = 0;
 
-	public:
-
-		File(char const *name, Allocator &alloc)
-		: Node(name), _chunk(alloc, 0) { }
+		/*
+		 * Local mapping of the dataspace handed out for the file
+		 *
+		 * While the file is mapped, the dataspace holds the authoritative
+		 * content of its first '_ds_size' bytes. Writes are applied to both
+		 * the chunks and the dataspace, reads are served from the
+		 * dataspace, and the dataspace content is written back to the
+		 * chunks when the mapping is dissolved.
+		 */
+		char   *_ds_local = nullptr;
+		size_t  _ds_size  = 0;
 
-		size_t read(char *dst, size_t len, file_size seek_offset) override
+		size_t _read_chunks(char *dst, size_t len, file_size seek_offset)
 		{
 			file_size const chunk_used_size = _chunk.used_size();
 
@@ -223,6 +192,22 @@ class Vfs_ram::File : public Vfs_ram::Node
 			return len;
 		}
 
+	public:
+
+		File(char const *name, Allocator &alloc)
+		: Node(name), _chunk(alloc, 0) { }
+
+		size_t read(char *dst, size_t len, file_size seek_offset) override
+		{
+			len = _read_chunks(dst, len, seek_offset);
+
+			if (_ds_local && seek_offset < _ds_size)
+				memcpy(dst, _ds_local + seek_offset,
+				       min(len, (size_t)(_ds_size - seek_offset)));
+
+			return len;
+		}
+
 		Vfs::File_io_service::Read_result complete_read(char *dst,
 		                                                file_size count,
 		                                                file_size seek_offset,
@@ -250,6 +235,10 @@ class Vfs_ram::File : public Vfs_ram::Node
 			 */
 			_length = max(_length, seek_offset + len);
 
+			if (_ds_local && seek_offset < _ds_size)
+				memcpy(_ds_local + seek_offset, src,
+				       min(len, (size_t)(_ds_size - seek_offset)));
+
 			return len;
 		}
 
@@ -261,7 +250,60 @@ class Vfs_ram::File : public Vfs_ram::Node
 				_chunk.truncate(size);
 
 			_length = size;
+
+			if (_ds_local && size < _ds_size)
+				memset(_ds_local + size, 0, _ds_size - size);
 		}
+
+		/**
+		 * Attach locally mapped dataspace as storage of the file content
+		 *
+		 * The dataspace is initialized with the current content.
+		 */
+		void map(char *local, size_t size)
+		{
+			memset(local, 0, size);
+			_read_chunks(local, min(size, (size_t)_length), 0);
+
+			_ds_local = local;
+			_ds_size  = size;
+		}
+
+		/**
+		 * Write content of the dataspace back to the chunks and detach it
+		 *
+		 * Only blocks that differ from the chunks are written back, so
+		 * that unmapping a file that was mapped read-only is cheap.
+		 */
+		void unmap()
+		{
+			enum { BLOCK_SIZE = 512 };
+
+			char * const local = _ds_local;
+			size_t const size  = min(_ds_size, (size_t)_length);
+
+			_ds_local = nullptr;
+			_ds_size  = 0;
+
+			char block[BLOCK_SIZE];
+
+			for (size_t offset = 0; offset < size; offset += BLOCK_SIZE) {
+
+				size_t const len = min((size_t)BLOCK_SIZE, size - offset);
+
+				_read_chunks(block, len, offset);
+				if (memcmp(block, local + offset, len) == 0)
+					continue;
+
+				try { _chunk.write(local + offset, len, offset); }
+				catch (Out_of_memory) {
+					Genode::error("could not write back mapped content of ", name());
+					return;
+				}
+			}
+		}
+
+		bool mapped() const { return _ds_local != nullptr; }
 };
 
 
@@ -323,18 +365,20 @@ class Vfs_ram::Directory : public Vfs_ram::Node
 {
 	private:
 
-		Avl_tree<Node>  _entries;
-		file_size       _count = 0;
+		typedef ::File_system::Directory_index<Node> Entries;
+
+		/* list the entries in alphabetical order */
+		Entries _entries;
 
 	public:
 
-		Directory(char const *name)
-		: Node(name) { }
+		Directory(Allocator &alloc, char const *name)
+		: Node(name), _entries(alloc, Entries::Order::BY_NAME) { }
 
 		void empty(Allocator &alloc)
 		{
 			while (Node *node = _entries.first()) {
-				_entries.remove(node);
+				_entries.remove(*node);
 				if (File *file = dynamic_cast<File*>(node)) {
 					if (file->close_but_keep())
 						continue;
@@ -345,25 +389,13 @@ class Vfs_ram::Directory : public Vfs_ram::Node
 			}
 		}
 
-		void adopt(Node *node)
-		{
-			_entries.insert(node);
-			++_count;
-		}
+		void adopt(Node *node) { _entries.insert(*node); }
 
-		Node *child(char const *name)
-		{
-			Node *node = _entries.first();
-			return node ? node->sibling(name) : nullptr;
-		}
+		Node *child(char const *name) { return _entries.lookup(name); }
 
-		void release(Node *node)
-		{
-			_entries.remove(node);
-			--_count;
-		}
+		void release(Node *node) { _entries.remove(*node); }
 
-		file_size length() override { return _count; }
+		file_size length() override { return _entries.count(); }
 
 		Vfs::File_io_service::Read_result complete_read(char *dst,
 		                                                file_size count,
@@ -381,8 +413,7 @@ class Vfs_ram::Directory : public Vfs_ram::Node
 			*dirent = Dirent();
 			out_count = sizeof(Dirent);
 
-			Node *node = _entries.first();
-			if (node) node = node->index(index);
+			Node *node = _entries.entry(index);
 			if (!node) {
 				dirent->type = Directory_service::DIRENT_TYPE_END;
 				return Vfs::File_io_service::READ_OK;
@@ -432,9 +463,44 @@ class Vfs::Ram_file_system : public Vfs::File_system
 			}
 		};
 
+		/**
+		 * Dataspace handed out for a file via 'dataspace'
+		 *
+		 * All users of the same file share one dataspace. The mapping
+		 * holds a reference to the file like an open handle, which keeps
+		 * the file alive when it gets unlinked while being mapped.
+		 */
+		struct Mapping : Genode::List<Mapping>::Element
+		{
+			Vfs_ram::File                         &file;
+			Genode::Ram_dataspace_capability const ds;
+			char                           * const local_addr;
+			unsigned                               users = 1;
+
+			Mapping(Vfs_ram::File &file, Genode::Ram_dataspace_capability ds,
+			        char *local_addr)
+			: file(file), ds(ds), local_addr(local_addr) { }
+		};
+
 		Genode::Env        &_env;
 		Genode::Allocator  &_alloc;
-		Vfs_ram::Directory  _root = { "" };
+		Vfs_ram::Directory  _root = { _alloc, "" };
+
+		Genode::List<Mapping> _mappings;
+		Genode::Lock          _mappings_lock;
+
+		/**
+		 * Return mapping of file, must be called with the file locked
+		 */
+		Mapping *_mapping(Vfs_ram::File &file)
+		{
+			Genode::Lock::Guard guard(_mappings_lock);
+
+			for (Mapping *m = _mappings.first(); m; m = m->next())
+				if (&m->file == &file)
+					return m;
+			return nullptr;
+		}
 
 		Vfs_ram::Node *lookup(char const *path, bool return_parent = false)
 		{
@@ -592,7 +658,7 @@ class Vfs::Ram_file_system : public Vfs::File_system
 					return OPENDIR_ERR_NODE_ALREADY_EXISTS;
 
 				try {
-					dir = new (_alloc) Directory(name);
+					dir = new (_alloc) Directory(_alloc, name);
 				} catch (Out_of_memory) { return OPENDIR_ERR_NO_SPACE; }
 
 				parent->adopt(dir);
@@ -773,36 +839,88 @@ class Vfs::Ram_file_system : public Vfs::File_system
 		{
 			using namespace Vfs_ram;
 
-			Ram_dataspace_capability ds_cap;
-
 			Node *node = lookup(path);
-			if (!node) return ds_cap;
+			if (!node) return Dataspace_capability();
 			Node::Guard guard(node);
 
 			File *file = dynamic_cast<File *>(node);
-			if (!file) return ds_cap;
+			if (!file || !file->length()) return Dataspace_capability();
 
-			size_t len = file->length();
+			/* share the dataspace of a file that is already mapped */
+			if (Mapping *mapping = _mapping(*file)) {
+				mapping->users++;
+				return mapping->ds;
+			}
 
+			Ram_dataspace_capability ds_cap;
 			char *local_addr = nullptr;
 			try {
-				ds_cap = _env.ram().alloc(len);
-
+				ds_cap     = _env.ram().alloc(file->length());
 				local_addr = _env.rm().attach(ds_cap);
-				file->read(local_addr, file->length(), 0);
-				_env.rm().detach(local_addr);
+
+				size_t const size = Dataspace_client(ds_cap).size();
+
+				Mapping *mapping = new (_alloc) Mapping(*file, ds_cap, local_addr);
+
+				file->map(local_addr, size);
+				file->open();
+
+				Genode::Lock::Guard mappings_guard(_mappings_lock);
+				_mappings.insert(mapping);
 
 			} catch(...) {
-				_env.rm().detach(local_addr);
+				if (local_addr) _env.rm().detach(local_addr);
 				_env.ram().free(ds_cap);
 				return Dataspace_capability();
 			}
 			return ds_cap;
 		}
 
-		void release(char const *path, Dataspace_capability ds_cap) override {
-			_env.ram().free(
-				static_cap_cast<Genode::Ram_dataspace>(ds_cap)); }
+		void release(char const *, Dataspace_capability ds_cap) override
+		{
+			using namespace Vfs_ram;
+
+			/*
+			 * The dataspace may stem from another file system, or the file
+			 * may have been renamed or unlinked since it was mapped. Hence,
+			 * the mapping is looked up by the dataspace. The reference held
+			 * by the caller keeps the mapping alive until it is dropped
+			 * below.
+			 */
+			Mapping *mapping = nullptr;
+			{
+				Genode::Lock::Guard guard(_mappings_lock);
+
+				for (mapping = _mappings.first(); mapping; mapping = mapping->next())
+					if (mapping->ds == ds_cap)
+						break;
+			}
+			if (!mapping)
+				return;
+
+			File &file = mapping->file;
+			{
+				Node::Guard guard(&file);
+
+				if (--mapping->users)
+					return;
+
+				file.unmap();
+
+				Genode::Lock::Guard mappings_guard(_mappings_lock);
+				_mappings.remove(mapping);
+			}
+
+			_env.rm().detach(mapping->local_addr);
+			_env.ram().free(mapping->ds);
+			destroy(_alloc, mapping);
+
+			/* drop the reference of the mapping, see 'close' */
+			if (!file.close_but_keep())
+				destroy(_alloc, &file);
+		}
+
+		bool dataspace_holds_content() override { return true; }
 
 
 		/************************
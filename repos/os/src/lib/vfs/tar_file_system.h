@@ -426,6 +426,26 @@ class Vfs::Tar_file_system : public File_system
 		}
 	} _cached_num_dirent;
 
+	/**
+	 * Dataspace with the content of a file record
+	 *
+	 * The archive ROM cannot be mapped partially because the records are
+	 * not page-aligned. So the content is copied once into a RAM dataspace,
+	 * which is shared by all users of the record.
+	 */
+	struct Mapping : List<Mapping>::Element
+	{
+		Record const                   &record;
+		Ram_dataspace_capability const  ds;
+		unsigned                        users = 1;
+
+		Mapping(Record const &record, Ram_dataspace_capability ds)
+		: record(record), ds(ds) { }
+	};
+
+	List<Mapping> _mappings;
+	Lock          _mappings_lock;
+
 	/**
 	 * Walk hardlinks until we reach a file
 	 *
@@ -478,24 +498,53 @@ class Vfs::Tar_file_system : public File_system
 				return Dataspace_capability();
 			}
 
+			if (!record->size())
+				return Dataspace_capability();
+
+			Lock::Guard guard(_mappings_lock);
+
+			for (Mapping *m = _mappings.first(); m; m = m->next())
+				if (&m->record == record) {
+					m->users++;
+					return m->ds;
+				}
+
+			Ram_dataspace_capability ds_cap;
 			try {
-				Ram_dataspace_capability ds_cap =
-					_env.ram().alloc(record->size());
+				ds_cap = _env.ram().alloc(record->size());
 
 				void *local_addr = _env.rm().attach(ds_cap);
 				memcpy(local_addr, record->data(), record->size());
 				_env.rm().detach(local_addr);
 
+				_mappings.insert(new (_alloc) Mapping(*record, ds_cap));
 				return ds_cap;
 			}
 			catch (...) { Genode::warning(__func__, " could not create new dataspace"); }
 
+			if (ds_cap.valid())
+				_env.ram().free(ds_cap);
+
 			return Dataspace_capability();
 		}
 
 		void release(char const *, Dataspace_capability ds_cap) override
 		{
-			_env.ram().free(static_cap_cast<Genode::Ram_dataspace>(ds_cap));
+			Lock::Guard guard(_mappings_lock);
+
+			/* the dataspace may stem from another file system */
+			for (Mapping *m = _mappings.first(); m; m = m->next()) {
+
+				if (!(m->ds == ds_cap))
+					continue;
+
+				if (--m->users == 0) {
+					_mappings.remove(m);
+					_env.ram().free(m->ds);
+					destroy(_alloc, m);
+				}
+				return;
+			}
 		}
 
 		Stat_result stat(char const *path, Stat &out) override
@@ -577,13 +626,17 @@ class Vfs::Tar_file_system : public File_system
 			return node ? path : 0;
 		}
 
-		Open_result open(char const *path, unsigned, Vfs_handle **out_handle,
+		Open_result open(char const *path, unsigned mode, Vfs_handle **out_handle,
 		                 Genode::Allocator& alloc) override
 		{
 			Node const *node = dereference(path);
 			if (!node || !node->record || node->record->type() != Record::TYPE_FILE)
 				return OPEN_ERR_UNACCESSIBLE;
 
+			/* the archive is read-only */
+			if ((mode & OPEN_MODE_ACCMODE) != OPEN_MODE_RDONLY)
+				return OPEN_ERR_NO_PERM;
+
 			*out_handle = new (alloc) Tar_vfs_file_handle(*this, alloc, 0, node);
 
 			return OPEN_OK;
@@ -155,7 +155,61 @@ namespace Cache {
 
 				_num_entries = Genode::max(_num_entries, local_offset + len);
 
-				_writes++;
+				/* the content differs from the backend device */
+				_writes = Genode::max(_writes + 1, 2U);
+			}
+
+			/**
+			 * Populate chunk with content read from the backend device
+			 *
+			 * Chunks that are already valid are left untouched because
+			 * their content may have been changed in the meantime.
+			 */
+			void fill(char const *src, size_t len, offset_t seek_offset)
+			{
+				assert_valid_range(seek_offset, len, SIZE);
+
+				if (_writes || len != SIZE)
+					return;
+
+				POLICY::write(this);
+
+				Genode::memcpy(_data, src, len);
+
+				_num_entries = SIZE;
+				_writes      = 1;
+			}
+
+			/**
+			 * Fill range with zeroes and mark the chunk as dirty
+			 */
+			void clear(size_t len, offset_t seek_offset)
+			{
+				assert_valid_range(seek_offset, len, SIZE);
+
+				POLICY::write(this);
+
+				offset_t const local_offset = seek_offset - base_offset();
+
+				Genode::memset(&_data[local_offset], 0, len);
+
+				_num_entries = Genode::max(_num_entries, local_offset + len);
+
+				_writes = Genode::max(_writes + 1, 2U);
+			}
+
+			/**
+			 * Drop content if the range covers the whole chunk
+			 *
+			 * An invalidated chunk is neither written back nor used for
+			 * reading until it is populated from the backend device again.
+			 */
+			void invalidate(size_t len, offset_t seek_offset)
+			{
+				if (zero() || seek_offset != base_offset() || len != SIZE)
+					return;
+
+				_writes = 0;
 			}
 
 			void read(char *dst, size_t len, offset_t seek_offset) const
@@ -417,6 +471,42 @@ namespace Cache {
 					entry.stat(len, seek_offset); }
 			};
 
+			struct Fill_func
+			{
+				typedef ENTRY_TYPE Entry;
+
+				static Entry &lookup(Chunk_index &chunk, unsigned i) {
+					return chunk._alloc_entry(i); }
+
+				void operator () (Entry &entry, char const *src, size_t len,
+				                  offset_t seek_offset) const {
+					entry.fill(src, len, seek_offset); }
+			};
+
+			struct Clear_func
+			{
+				typedef ENTRY_TYPE Entry;
+
+				static Entry &lookup(Chunk_index &chunk, unsigned i) {
+					return chunk._entry(i); }
+
+				void operator () (Entry &entry, char*, size_t len,
+				                  offset_t seek_offset) const {
+					entry.clear(len, seek_offset); }
+			};
+
+			struct Invalidate_func
+			{
+				typedef ENTRY_TYPE Entry;
+
+				static Entry &lookup(Chunk_index const &chunk, unsigned i) {
+					return chunk._entry_for_syncing(i); }
+
+				void operator () (Entry &entry, char*, size_t len,
+				                  offset_t seek_offset) const {
+					entry.invalidate(len, seek_offset); }
+			};
+
 			struct Sync_func
 			{
 				typedef ENTRY_TYPE Entry;
@@ -517,6 +607,25 @@ namespace Cache {
 			void stat(size_t len, offset_t seek_offset) const {
 				_range_op(*this, (char*)0, len, seek_offset, Stat_func()); }
 
+			/**
+			 * Populate invalid chunks with data read from the backend
+			 */
+			void fill(char const *src, size_t len, offset_t seek_offset) {
+				_range_op(*this, src, len, seek_offset, Fill_func()); }
+
+			/**
+			 * Fill allocated chunks with zeroes
+			 */
+			void clear(size_t len, offset_t seek_offset) {
+				_range_op(*this, (char*)0, len, seek_offset, Clear_func()); }
+
+			/**
+			 * Drop content of the chunks covered by the range completely
+			 */
+			void invalidate(size_t len, offset_t seek_offset) {
+				if (zero()) return;
+				_range_op(*this, (char*)0, len, seek_offset, Invalidate_func()); }
+
 			/**
 			 * Synchronize chunk when dirty
 			 */
@@ -11,10 +11,14 @@
  * under the terms of the GNU Affero General Public License version 3.
  */
 
+#include <base/attached_ram_dataspace.h>
 #include <base/log.h>
 #include <block_session/connection.h>
 #include <block/component.h>
 #include <os/packet_allocator.h>
+#include <os/reporter.h>
+#include <util/xml_node.h>
+#include <timer_session/connection.h>
 
 #include "chunk.h"
 
@@ -95,11 +99,41 @@ class Driver : public Block::Driver
 		struct Policy : POLICY {
 			static void sync(const typename POLICY::Element *e, char *src); };
 
+		/*
+		 * Adjacent dirty chunks that are written back with a single request
+		 *
+		 * The content of the chunks is copied into a staging buffer when
+		 * they are added. So the chunks can be evicted before the request is
+		 * submitted, and the packet is allocated with the size of the
+		 * coalesced run only.
+		 */
+		struct Write_back
+		{
+			Cache::offset_t offset = 0;
+			unsigned        count  = 0;
+
+			Cache::offset_t end() const {
+				return offset + count*CACHE_BLK_SIZE; }
+		};
+
+		struct Statistics
+		{
+			Genode::uint64_t hits           = 0; /* reads served by cache  */
+			Genode::uint64_t misses         = 0; /* reads from the backend */
+			Genode::uint64_t read_ahead     = 0; /* chunks read ahead      */
+			Genode::uint64_t write_backs    = 0; /* write-back requests    */
+			Genode::uint64_t written_chunks = 0; /* chunks written back    */
+		};
+
 	public:
 
 		enum {
 			SLAB_SZ = Block::Session::TX_QUEUE_SIZE*sizeof(Request),
-			CACHE_BLK_SIZE = 4096
+			CACHE_BLK_SIZE = 4096,
+
+			/* limits of configurable number of chunks per request */
+			MAX_READ_AHEAD = 64,
+			MAX_WRITE_BACK = 64,
 		};
 
 		/**
@@ -127,6 +161,22 @@ class Driver : public Block::Driver
 		Genode::Io_signal_handler<Driver> _source_submit;
 		Genode::Io_signal_handler<Driver> _yield;
 
+		unsigned const  _read_ahead;         /* chunks to read ahead      */
+		unsigned const  _write_back_max;     /* chunks per write back     */
+
+		Genode::Attached_ram_dataspace _write_back_buf;  /* staged chunks */
+
+		Block::sector_t _seq_next   = 0;     /* block after last read     */
+		bool            _sequential = false; /* last read continued       */
+		bool            _replay     = false; /* request repeated on reply */
+		bool            _syncing    = false; /* write back coalesced      */
+		Write_back      _write_back { };
+		Statistics      _stats      { };
+
+		Genode::Constructible<Genode::Reporter>  _reporter { };
+		Genode::Constructible<Timer::Connection> _timer    { };
+		Genode::Io_signal_handler<Driver>        _report_handler;
+
 		Driver(Driver const&);            /* singleton pattern */
 		Driver& operator=(Driver const&); /* singleton pattern */
 
@@ -157,19 +207,40 @@ class Driver : public Block::Driver
 		 */
 		inline void _handle_reply(Block::Packet_descriptor &srv, Request *r)
 		{
+			if (!srv.succeeded()) {
+				ack_packet(r->cli, false);
+				return;
+			}
+
+			/* a repeated request is no cache hit */
+			_replay = true;
+
 			try {
-			if (r->cli.operation() == Block::Packet_descriptor::READ)
+			switch (r->cli.operation()) {
+			case Block::Packet_descriptor::READ:
 				read(r->cli.block_number(), r->cli.block_count(),
 				     r->buffer, r->cli);
-			else
+				break;
+			case Block::Packet_descriptor::WRITE:
 				write(r->cli.block_number(), r->cli.block_count(),
 				      r->buffer, r->cli);
+				break;
+			case Block::Packet_descriptor::WRITE_ZEROES:
+				write_zeroes(r->cli.block_number(), r->cli.block_count(),
+				             r->cli);
+				break;
+			default:
+				/* request forwarded to the backend device as is */
+				ack_packet(r->cli, srv.succeeded());
+			}
 			} catch(Block::Driver::Request_congestion) {
 				Genode::warning("cli (", r->cli.block_number(), " ",
 				                         r->cli.block_count(), ") "
 				                "srv (", r->srv.block_number(), " ",
 				                         r->srv.block_count(), ")");
 			}
+
+			_replay = false;
 		}
 
 		/*
@@ -180,11 +251,12 @@ class Driver : public Block::Driver
 			while (_blk.tx()->ack_avail()) {
 				Block::Packet_descriptor p = _blk.tx()->get_acked_packet();
 
-				/* when reading, write result into cache */
-				if (p.operation() == Block::Packet_descriptor::READ)
-					_cache.write(_blk.tx()->packet_content(p),
-					             p.block_count() * _blk_sz,
-					             p.block_number() * _blk_sz);
+				/* when reading, populate the cache with the result */
+				if (p.operation() == Block::Packet_descriptor::READ
+				 && p.succeeded())
+					_cache.fill(_blk.tx()->packet_content(p),
+					            p.block_count() * _blk_sz,
+					            p.block_number() * _blk_sz);
 
 				/* loop through the list of requests, and ack all related */
 				for (Request *r = _r_list.first(), *r_to_handle = r; r;
@@ -241,6 +313,11 @@ class Driver : public Block::Driver
 				Genode::size_t cnt = _cache_blk_round_up(block_count +
 				                                         (block_number - nr));
 
+				/* extend request of a sequential reader */
+				if (packet.operation() == Block::Packet_descriptor::READ
+				 && _sequential)
+					cnt += _read_ahead_blocks(nr + cnt);
+
 				/* ensure all memory is available before sending the request */
 				_cache.alloc(cnt * _blk_sz, nr * _blk_sz);
 
@@ -260,6 +337,95 @@ class Driver : public Block::Driver
 			}
 		}
 
+		/*
+		 * Return true if the cache block containing 'nr' is populated
+		 */
+		bool _cached(Block::sector_t nr)
+		{
+			try {
+				_cache.stat(CACHE_BLK_SIZE, _cache_blk_round_off(nr) * _blk_sz);
+				return true;
+			} catch (Cache::Chunk_base::Range_incomplete) { }
+			return false;
+		}
+
+		/*
+		 * Return number of blocks to read ahead starting at block 'nr'
+		 *
+		 * Read-ahead stops at the first populated cache block.
+		 */
+		Genode::size_t _read_ahead_blocks(Block::sector_t nr)
+		{
+			Genode::size_t cnt = 0;
+
+			for (unsigned i = 0; i < _read_ahead; i++) {
+
+				Block::sector_t const next = nr + cnt;
+				if (next + _cache_blk_mod() > _blk_cnt || _cached(next))
+					break;
+
+				cnt += _cache_blk_mod();
+				_stats.read_ahead++;
+			}
+			return cnt;
+		}
+
+		/*
+		 * Submit pending write-back request
+		 *
+		 * \return  false if the backend device is not ready to take the
+		 *          request, which stays pending in this case
+		 */
+		bool _submit_write_back()
+		{
+			if (!_write_back.count)
+				return true;
+
+			if (!_blk.tx()->ready_to_submit())
+				return false;
+
+			Block::sector_t const nr  = _write_back.offset / _blk_sz;
+			Genode::size_t  const cnt = Genode::min((Block::sector_t)
+			                                        (_write_back.count*_cache_blk_mod()),
+			                                        _blk_cnt - nr);
+
+			Block::Packet_descriptor p;
+			try { p = _blk.dma_alloc_packet(cnt*_blk_sz); }
+			catch (Block::Session::Tx::Source::Packet_alloc_failed) {
+				return false; }
+
+			Genode::memcpy(_blk.tx()->packet_content(p),
+			               _write_back_buf.local_addr<char>(), cnt*_blk_sz);
+
+			_blk.tx()->submit_packet(Block::Packet_descriptor(p,
+			                         Block::Packet_descriptor::WRITE, nr, cnt));
+
+			_stats.write_backs++;
+			_stats.written_chunks += _write_back.count;
+			_write_back.count = 0;
+			return true;
+		}
+
+		/*
+		 * Pass a request without payload to the backend device
+		 *
+		 * \param op      operation
+		 * \param packet  original packet request received from the client
+		 */
+		void _forward(Block::Packet_descriptor::Opcode op,
+		              Block::sector_t           block_number,
+		              Genode::size_t            block_count,
+		              Block::Packet_descriptor &packet)
+		{
+			if (!_blk.tx()->ready_to_submit())
+				throw Request_congestion();
+
+			Block::Packet_descriptor p_to_dev(Block::Packet_descriptor(), op,
+			                                  block_number, block_count);
+			_r_list.insert(new (&_r_slab) Request(p_to_dev, packet, nullptr));
+			_blk.tx()->submit_packet(p_to_dev);
+		}
+
 		/*
 		 * Synchronize dirty chunks with backend device
 		 */
@@ -268,6 +434,9 @@ class Driver : public Block::Driver
 			Cache::offset_t off = 0;
 			Cache::size_t len   = _blk_sz * _blk_cnt;
 
+			/* coalesce adjacent dirty chunks while traversing the cache */
+			_syncing = true;
+
 			while (len > 0) {
 				try {
 					_cache.sync(len, off);
@@ -282,6 +451,24 @@ class Driver : public Block::Driver
 					_env.ep().wait_and_dispatch_one_io_signal();
 				}
 			}
+
+			/* submit the last run of chunks */
+			while (!_submit_write_back())
+				_env.ep().wait_and_dispatch_one_io_signal();
+
+			_syncing = false;
+		}
+
+		void _report()
+		{
+			Genode::Reporter::Xml_generator xml(*_reporter, [&] () {
+				xml.attribute("hits",           _stats.hits);
+				xml.attribute("misses",         _stats.misses);
+				xml.attribute("evictions",      POLICY::evictions());
+				xml.attribute("read_ahead",     _stats.read_ahead);
+				xml.attribute("write_backs",    _stats.write_backs);
+				xml.attribute("written_chunks", _stats.written_chunks);
+			});
 		}
 
 		/*
@@ -330,9 +517,9 @@ class Driver : public Block::Driver
 		/*
 		 * Constructor
 		 *
-		 * \param ep  server entrypoint
+		 * \param config  component configuration
 		 */
-		Driver(Genode::Env &env, Genode::Heap &heap)
+		Driver(Genode::Env &env, Genode::Heap &heap, Genode::Xml_node config)
 		: Block::Driver(env.ram()),
 		  _env(env),
 		  _r_slab(&heap),
@@ -343,10 +530,28 @@ class Driver : public Block::Driver
 		  _cache(heap, 0),
 		  _source_ack(env.ep(), *this, &Driver::_ack_avail),
 		  _source_submit(env.ep(), *this, &Driver::_ready_to_submit),
-		  _yield(env.ep(), *this, &Driver::_parent_yield)
+		  _yield(env.ep(), *this, &Driver::_parent_yield),
+		  _read_ahead(Genode::min(config.attribute_value("read_ahead", 8U),
+		                          (unsigned)MAX_READ_AHEAD)),
+		  _write_back_max(Genode::max(1U,
+		                  Genode::min(config.attribute_value("write_back", 16U),
+		                              (unsigned)MAX_WRITE_BACK))),
+		  _write_back_buf(env.ram(), env.rm(), _write_back_max*CACHE_BLK_SIZE),
+		  _report_handler(env.ep(), *this, &Driver::_report)
 		{
 			using namespace Genode;
 
+			try {
+				Xml_node const report = config.sub_node("report");
+				if (report.attribute_value("statistics", false)) {
+					_reporter.construct(env, "statistics");
+					_reporter->enabled(true);
+					_timer.construct(env);
+					_timer->sigh(_report_handler);
+					_timer->trigger_periodic(1000*report.attribute_value("interval_ms", 1000U));
+				}
+			} catch (Xml_node::Nonexistent_sub_node) { }
+
 			_blk.info(&_blk_cnt, &_blk_sz, &_ops);
 			_blk.tx_channel()->sigh_ack_avail(_source_ack);
 			_blk.tx_channel()->sigh_ready_to_submit(_source_submit);
@@ -372,6 +577,39 @@ class Driver : public Block::Driver
 		Block::Session_client* blk()    { return &_blk;   }
 		Genode::size_t         blk_sz() { return _blk_sz; }
 
+		/*
+		 * Write back content of dirty chunk
+		 *
+		 * Chunks are collected into one request as long as they are
+		 * adjacent. Outside of a cache synchronization, the request is
+		 * submitted immediately.
+		 *
+		 * \throw Write_failed  backend device is not ready to proceed
+		 */
+		void write_back(Cache::offset_t off, char const *data)
+		{
+			/* submit pending run if the chunk cannot be appended */
+			if (_write_back.count && (off != _write_back.end()
+			                       || _write_back.count == _write_back_max))
+				if (!_submit_write_back())
+					throw Write_failed(off);
+
+			if (!_write_back.count)
+				_write_back.offset = off;
+
+			Genode::memcpy(_write_back_buf.local_addr<char>()
+			               + _write_back.count*CACHE_BLK_SIZE,
+			               data, CACHE_BLK_SIZE);
+			_write_back.count++;
+
+			if (_syncing || _submit_write_back())
+				return;
+
+			/* leave the chunk dirty to retry the write back later */
+			_write_back.count = 0;
+			throw Write_failed(off);
+		}
+
 
 		/****************************
 		 ** Block-driver interface **
@@ -379,7 +617,18 @@ class Driver : public Block::Driver
 
 		Genode::size_t  block_size()     { return _blk_sz;  }
 		Block::sector_t block_count()    { return _blk_cnt; }
-		Block::Session::Operations ops() { return _ops;     }
+
+		Block::Session::Operations ops()
+		{
+			Block::Session::Operations ops = _ops;
+
+			/* both operations are implemented by the cache */
+			if (_ops.supported(Block::Packet_descriptor::WRITE)) {
+				ops.set_operation(Block::Packet_descriptor::DISCARD);
+				ops.set_operation(Block::Packet_descriptor::WRITE_ZEROES);
+			}
+			return ops;
+		}
 
 		void read(Block::sector_t           block_number,
 		          Genode::size_t            block_count,
@@ -389,8 +638,20 @@ class Driver : public Block::Driver
 			if (!_ops.supported(Block::Packet_descriptor::READ))
 				throw Io_error();
 
-			if (!_stat(block_number, block_count, buffer, packet))
+			bool const first_attempt = !_replay;
+			if (first_attempt) {
+				_sequential = block_number == _seq_next;
+				_seq_next   = block_number + block_count;
+			}
+
+			if (!_stat(block_number, block_count, buffer, packet)) {
+				if (first_attempt)
+					_stats.misses++;
 				return;
+			}
+
+			if (first_attempt)
+				_stats.hits++;
 
 			_cache.read(buffer, block_count*_blk_sz, block_number*_blk_sz);
 			ack_packet(packet);
@@ -420,5 +681,69 @@ class Driver : public Block::Driver
 			ack_packet(packet);
 		}
 
+		void write_zeroes(Block::sector_t           block_number,
+		                  Genode::size_t            block_count,
+		                  Block::Packet_descriptor &packet)
+		{
+			if (!_ops.supported(Block::Packet_descriptor::WRITE))
+				throw Io_error();
+
+			_cache.alloc(block_count * _blk_sz, block_number * _blk_sz);
+
+			/* partially covered cache blocks must be populated first */
+			if ((block_number % _cache_blk_mod()) &&
+			    !_stat(block_number, 1, nullptr, packet))
+				return;
+
+			if (((block_number+block_count) % _cache_blk_mod())
+				&& !_stat(block_number+block_count-1, 1, nullptr, packet))
+				return;
+
+			_cache.clear(block_count * _blk_sz, block_number * _blk_sz);
+			ack_packet(packet);
+		}
+
+		void discard(Block::sector_t           block_number,
+		             Genode::size_t            block_count,
+		             Block::Packet_descriptor &packet)
+		{
+			if (!_ops.supported(Block::Packet_descriptor::WRITE))
+				throw Io_error();
+
+			/*
+			 * Cache blocks covered completely are dropped without being
+			 * written back. The content of partially covered ones is
+			 * retained, which is in line with the undefined content of
+			 * discarded blocks.
+			 */
+			_cache.invalidate(block_count * _blk_sz, block_number * _blk_sz);
+
+			if (!_ops.supported(Block::Packet_descriptor::DISCARD)) {
+				ack_packet(packet);
+				return;
+			}
+
+			_forward(Block::Packet_descriptor::DISCARD, block_number,
+			         block_count, packet);
+		}
+
+		void flush(Block::Packet_descriptor &packet)
+		{
+			_sync();
+
+			/*
+			 * The backend processes the flush after the write-back of the
+			 * dirty chunks submitted above. So the client gets acknowledged
+			 * once the data reached the backend persistently.
+			 */
+			if (!_ops.supported(Block::Packet_descriptor::FLUSH)) {
+				_blk.sync();
+				ack_packet(packet);
+				return;
+			}
+
+			_forward(Block::Packet_descriptor::FLUSH, 0, 0, packet);
+		}
+
 		void sync() { _sync(); }
 };
@@ -18,6 +18,7 @@ typedef Driver<Lru_policy>::Chunk_level_4 Chunk;
 
 static const Lru_policy::Element        *lru = 0;
 static Genode::List<Lru_policy::Element> lru_list;
+static Genode::uint64_t                  evicted;
 
 
 static void lru_access(const Lru_policy::Element *e)
@@ -51,6 +52,7 @@ void Lru_policy::flush(Cache::size_t size)
 			cb->free(Driver<Lru_policy>::CACHE_BLK_SIZE,
 			         cb->base_offset());
 			lru_list.remove(cb);
+			evicted++;
 		} catch(Chunk::Dirty_chunk &e) {
 			cb->sync(e.size, e.off);
 		}
@@ -60,3 +62,6 @@ void Lru_policy::flush(Cache::size_t size)
 
 	if (s < size) throw Block::Driver::Request_congestion();
 }
+
+
+Genode::uint64_t Lru_policy::evictions() { return evicted; }
@@ -22,4 +22,9 @@ struct Lru_policy
 	static void read(const Element  *e);
 	static void write(const Element *e);
 	static void flush(Cache::size_t size = 0);
+
+	/**
+	 * Return number of chunks evicted from the cache
+	 */
+	static Genode::uint64_t evictions();
 };
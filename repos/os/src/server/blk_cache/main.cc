@@ -11,65 +11,119 @@
  * under the terms of the GNU Affero General Public License version 3.
  */
 
+#include <base/attached_rom_dataspace.h>
 #include <base/component.h>
 
 #include "lru.h"
+#include "two_q.h"
 #include "driver.h"
 
-using Policy = Lru_policy;
-static Driver<Policy> * driver = nullptr;
+
+/**
+ * Return pointer to the driver instance that uses the policy
+ */
+template <typename POLICY>
+static Driver<POLICY> *&driver()
+{
+	static Driver<POLICY> *instance = nullptr;
+	return instance;
+}
 
 
 /**
  * Synchronize a chunk with the backend device
  */
 template <typename POLICY>
-void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *dst)
+void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *src)
 {
 	Cache::offset_t off =
 		static_cast<const Driver<POLICY>::Chunk_level_4*>(e)->base_offset();
 
-	if (!driver) throw Write_failed(off);
-
-	if (!driver->blk()->tx()->ready_to_submit())
-		throw Write_failed(off);
-	try {
-		Block::Packet_descriptor
-			p(driver->blk()->dma_alloc_packet(Driver::CACHE_BLK_SIZE),
-		      Block::Packet_descriptor::WRITE, off / driver->blk_sz(),
-		      Driver::CACHE_BLK_SIZE / driver->blk_sz());
-		driver->blk()->tx()->submit_packet(p);
-	} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
-		throw Write_failed(off);
-	}
+	if (!driver<POLICY>()) throw Write_failed(off);
+
+	driver<POLICY>()->write_back(off, src);
 }
 
 
 struct Main
 {
-	template <typename T>
+	enum Policy_type { LRU, TWO_Q };
+
 	struct Factory : Block::Driver_factory
 	{
 		Genode::Env  &env;
 		Genode::Heap &heap;
 
-		Factory(Genode::Env &env, Genode::Heap &heap) : env(env), heap(heap) {}
+		Genode::Constructible<Genode::Attached_rom_dataspace> _config { };
+
+		Policy_type policy = LRU;
+
+		/**
+		 * Return component configuration, which is optional
+		 */
+		Genode::Xml_node config()
+		{
+			return _config.constructed() ? _config->xml()
+			                             : Genode::Xml_node("<config/>");
+		}
+
+		static Policy_type policy_from_config(Genode::Xml_node config)
+		{
+			typedef Genode::String<8> Name;
+			Name const name = config.attribute_value("policy", Name("lru"));
+
+			if (name == "2q")  return TWO_Q;
+			if (name != "lru") Genode::warning("unknown policy '", name, "', "
+			                                   "using LRU");
+			return LRU;
+		}
+
+		Factory(Genode::Env &env, Genode::Heap &heap) : env(env), heap(heap)
+		{
+			/* the configuration is optional */
+			try { _config.construct(env, "config"); }
+			catch (Genode::Rom_connection::Rom_connection_failed) { }
+
+			policy = policy_from_config(config());
+		}
+
+		template <typename T>
+		Block::Driver *create_driver()
+		{
+			driver<T>() = new (&heap) ::Driver<T>(env, heap, config());
+			return driver<T>();
+		}
+
+		template <typename T>
+		void destroy_driver()
+		{
+			Genode::destroy(&heap, driver<T>());
+			driver<T>() = nullptr;
+		}
 
 		Block::Driver *create()
 		{
-			driver = new (&heap) ::Driver<T>(env, heap);
-			return driver;
+			switch (policy) {
+			case TWO_Q: return create_driver<Two_q_policy>();
+			case LRU:   break;
+			}
+			return create_driver<Lru_policy>();
 		}
 
-		void destroy(Block::Driver *driver) {
-			Genode::destroy(&heap, static_cast<::Driver<T>*>(driver)); }
+		void destroy(Block::Driver *)
+		{
+			switch (policy) {
+			case TWO_Q: destroy_driver<Two_q_policy>(); return;
+			case LRU:   destroy_driver<Lru_policy>();   return;
+			}
+		}
 	};
 
 	void resource_handler() { }
 
 	Genode::Env                 &env;
 	Genode::Heap                 heap    { env.ram(), env.rm()     };
-	Factory<Lru_policy>          factory { env, heap               };
+	Factory                      factory { env, heap               };
 	Block::Root                  root    { env.ep(), heap, env.rm(), factory, true };
 	Genode::Signal_handler<Main> resource_dispatcher {
 		env.ep(), *this, &Main::resource_handler };
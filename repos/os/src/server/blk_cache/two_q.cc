@@ -0,0 +1,219 @@
+/*
+ * \brief  Scan-resistant 2Q cache replacement strategy
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include "two_q.h"
+#include "driver.h"
+
+typedef Driver<Two_q_policy>::Chunk_level_4 Chunk;
+typedef Two_q_policy::Element               Element;
+
+
+namespace {
+
+	/**
+	 * Doubly-linked queue of chunks, ordered from the oldest to the newest
+	 */
+	struct Queue
+	{
+		Element const *head  = nullptr;
+		Element const *tail  = nullptr;
+		unsigned long  count = 0;
+	};
+
+	/**
+	 * Offsets of the chunks recently evicted from 'A1in'
+	 *
+	 * The offsets are kept in a ring buffer, which drops the oldest entry
+	 * when full. For a fast lookup, the slots of the ring are chained into
+	 * hash buckets by offset.
+	 */
+	struct Ghosts
+	{
+		enum { MAX = 4096, BUCKETS = 1024, NONE = ~0U };
+
+		Cache::offset_t offsets[MAX];
+		unsigned        chain[MAX];          /* next slot of the same bucket */
+		unsigned        buckets[BUCKETS];    /* first slot of each bucket    */
+		unsigned        next  = 0;
+		unsigned        count = 0;
+
+		Ghosts()
+		{
+			for (unsigned i = 0; i < BUCKETS; i++)
+				buckets[i] = NONE;
+		}
+
+		static unsigned bucket(Cache::offset_t off) {
+			return (unsigned)((off / Chunk::SIZE) % BUCKETS); }
+
+		void unlink(unsigned slot)
+		{
+			unsigned *link = &buckets[bucket(offsets[slot])];
+			while (*link != slot)
+				link = &chain[*link];
+			*link = chain[slot];
+		}
+
+		void insert(Cache::offset_t off)
+		{
+			if (count == MAX)
+				unlink(next);
+
+			unsigned const b = bucket(off);
+			offsets[next] = off;
+			chain[next]   = buckets[b];
+			buckets[b]    = next;
+
+			next  = (next + 1) % MAX;
+			count = Genode::min(count + 1, (unsigned)MAX);
+		}
+
+		bool contains(Cache::offset_t off) const
+		{
+			for (unsigned i = buckets[bucket(off)]; i != NONE; i = chain[i])
+				if (offsets[i] == off)
+					return true;
+			return false;
+		}
+	};
+}
+
+
+static Queue            a1in, am;
+static Ghosts           a1out;
+static Genode::uint64_t evicted;
+
+
+struct Two_q_access
+{
+	static Queue &queue(Element const &e) {
+		return e._queue == Element::AM ? am : a1in; }
+
+	static void enqueue(Element const &e, Element::Queue which)
+	{
+		Queue &q = which == Element::AM ? am : a1in;
+
+		e._queue = which;
+		e._prev  = q.tail;
+		e._next  = nullptr;
+
+		if (q.tail) q.tail->_next = &e;
+		else        q.head        = &e;
+
+		q.tail = &e;
+		q.count++;
+	}
+
+	static void dequeue(Element const &e)
+	{
+		Queue &q = queue(e);
+
+		if (e._prev) e._prev->_next = e._next;
+		else         q.head         = e._next;
+
+		if (e._next) e._next->_prev = e._prev;
+		else         q.tail         = e._prev;
+
+		e._prev = e._next = nullptr;
+		e._queue = Element::NONE;
+		q.count--;
+	}
+
+	static void access(Element const &e)
+	{
+		switch (e._queue) {
+
+		case Element::NONE:
+			{
+				/* chunks evicted from 'A1in' recently are hot */
+				Cache::offset_t const off =
+					static_cast<Chunk const &>(e).base_offset();
+				enqueue(e, a1out.contains(off) ? Element::AM : Element::A1IN);
+			}
+			return;
+
+		case Element::A1IN:
+			/* correlated reference */
+			return;
+
+		case Element::AM:
+			dequeue(e);
+			enqueue(e, Element::AM);
+			return;
+		}
+	}
+
+	/**
+	 * Select the next chunk to evict
+	 *
+	 * 'A1in' is limited to a quarter of the cached chunks.
+	 */
+	static Element const *victim()
+	{
+		unsigned long const a1in_max =
+			Genode::max(1UL, (a1in.count + am.count) / 4);
+
+		if (a1in.head && (a1in.count > a1in_max || !am.head))
+			return a1in.head;
+
+		return am.head;
+	}
+
+	static void evict(Element const &e)
+	{
+		Chunk &chunk = const_cast<Chunk &>(static_cast<Chunk const &>(e));
+
+		/*
+		 * Write back dirty chunk before releasing it. If the backend is
+		 * not ready to take the request, the eviction has to be retried
+		 * later.
+		 */
+		try { chunk.sync(Chunk::SIZE, chunk.base_offset()); }
+		catch (Genode::Exception) { throw Block::Driver::Request_congestion(); }
+
+		if (e._queue == Element::A1IN)
+			a1out.insert(chunk.base_offset());
+
+		dequeue(e);
+		chunk.free(Chunk::SIZE, chunk.base_offset());
+		evicted++;
+	}
+};
+
+
+void Two_q_policy::read(const Element *e) {
+	Two_q_access::access(*e); }
+
+
+void Two_q_policy::write(const Element *e) {
+	Two_q_access::access(*e); }
+
+
+void Two_q_policy::flush(Cache::size_t size)
+{
+	Cache::size_t s = 0;
+	while ((size == 0) || (s < size)) {
+
+		Element const *e = Two_q_access::victim();
+		if (!e)
+			break;
+
+		Two_q_access::evict(*e);
+		s += sizeof(Chunk);
+	}
+
+	if (s < size) throw Block::Driver::Request_congestion();
+}
+
+
+Genode::uint64_t Two_q_policy::evictions() { return evicted; }
@@ -0,0 +1,54 @@
+/*
+ * \brief  Scan-resistant 2Q cache replacement strategy
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * Chunks referenced for the first time enter the FIFO queue 'A1in'. Further
+ * references to a chunk in 'A1in' are considered as correlated and leave
+ * the queue unchanged. When a chunk is evicted from 'A1in', its offset is
+ * remembered in the ghost queue 'A1out'. Only a chunk that is referenced
+ * again while being remembered in 'A1out' enters the LRU queue 'Am' of hot
+ * chunks. Hence, a sequential scan passes through 'A1in' without evicting
+ * the hot chunks.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _TWO_Q_H_
+#define _TWO_Q_H_
+
+#include "chunk.h"
+
+struct Two_q_access;
+
+struct Two_q_policy
+{
+	class Element
+	{
+		private:
+
+			friend struct Two_q_access;
+
+			enum Queue { NONE, A1IN, AM };
+
+			mutable Element const *_prev  = nullptr;
+			mutable Element const *_next  = nullptr;
+			mutable Queue          _queue = NONE;
+	};
+
+	static void read(const Element *e);
+	static void write(const Element *e);
+	static void flush(Cache::size_t size = 0);
+
+	/**
+	 * Return number of chunks evicted from the cache
+	 */
+	static Genode::uint64_t evictions();
+};
+
+#endif /* _TWO_Q_H_ */
@@ -17,6 +17,8 @@
 #include <file_system/util.h>
 #include <os/path.h>
 #include <base/attached_ram_dataspace.h>
+#include <base/attached_rom_dataspace.h>
+#include <os/session_policy.h>
 #include <root/component.h>
 #include <base/component.h>
 #include <base/session_label.h>
@@ -33,15 +35,160 @@ namespace Fs_rom {
 
 	struct Packet_handler;
 
+	class Cached_file;
+	class File_cache;
 	class Rom_session_component;
 	class Rom_root;
 
+	typedef Genode::List<Cached_file>           Cached_files;
 	typedef Genode::List<Rom_session_component> Sessions;
 
 	typedef File_system::Session_client::Tx::Source Tx_source;
+
+	enum { PATH_MAX_LEN = 512 };
+	typedef Genode::Path<PATH_MAX_LEN> Path;
 }
 
 
+/**
+ * Version of a file shared by the ROM sessions that request it
+ *
+ * Once loaded, the content of a version stays unmodified.
+ */
+class Fs_rom::Cached_file : public Cached_files::Element
+{
+	private:
+
+		friend class File_cache;
+
+		Path const _path;
+
+		Genode::Attached_ram_dataspace _ds;
+
+		unsigned _users = 0;  /* number of sessions that hand out the file */
+
+		bool _current = true; /* false once the file has changed */
+
+	public:
+
+		Cached_file(Genode::Env &env, Path const &path, size_t size)
+		: _path(path), _ds(env.ram(), env.rm(), size) { }
+
+		char *content() { return _ds.local_addr<char>(); }
+
+		size_t size() const { return _ds.size(); }
+
+		Genode::Dataspace_capability cap() const { return _ds.cap(); }
+};
+
+
+/**
+ * Cache of the current versions of files, keyed by path
+ *
+ * If a file changes, its version gets removed from the cache. The sessions
+ * that hand out the outdated version keep it until their clients request
+ * the new version. The version gets destroyed once no session refers to it
+ * anymore.
+ */
+class Fs_rom::File_cache : Genode::Noncopyable
+{
+	private:
+
+		Genode::Env       &_env;
+		Genode::Allocator &_alloc;
+
+		Cached_files _files;
+
+		void _remove(Cached_file &file)
+		{
+			if (!file._current)
+				return;
+
+			_files.remove(&file);
+			file._current = false;
+		}
+
+		void _try_to_destroy(Cached_file &file)
+		{
+			if (file._users || file._current)
+				return;
+
+			Genode::destroy(_alloc, &file);
+		}
+
+	public:
+
+		File_cache(Genode::Env &env, Genode::Allocator &alloc)
+		: _env(env), _alloc(alloc) { }
+
+		/**
+		 * Return current version of file, or nullptr if not cached
+		 *
+		 * \param size  current file size, which must match the size of the
+		 *              cached version
+		 */
+		Cached_file *lookup(Path const &path, size_t size)
+		{
+			for (Cached_file *f = _files.first(); f; f = f->next())
+				if (f->_path.equals(path.base()))
+					return f->size() == size ? f : nullptr;
+
+			return nullptr;
+		}
+
+		/**
+		 * Create new current version of file, to be filled by the caller
+		 *
+		 * \throw Out_of_ram
+		 * \throw Out_of_caps
+		 */
+		Cached_file &create(Path const &path, size_t size)
+		{
+			invalidate(path);
+
+			Cached_file &file = *new (_alloc) Cached_file(_env, path, size);
+			_files.insert(&file);
+			return file;
+		}
+
+		/**
+		 * Remove current version of file from the cache
+		 */
+		void invalidate(Path const &path)
+		{
+			for (Cached_file *f = _files.first(); f; f = f->next())
+				if (f->_path.equals(path.base())) {
+					_remove(*f);
+					_try_to_destroy(*f);
+					return;
+				}
+		}
+
+		void acquire(Cached_file &file) { file._users++; }
+
+		void release(Cached_file &file)
+		{
+			if (file._users)
+				file._users--;
+
+			/* the current version is not kept without users */
+			if (!file._users)
+				_remove(file);
+
+			_try_to_destroy(file);
+		}
+
+		/**
+		 * Release version that could not be loaded
+		 */
+		void discard(Cached_file &file)
+		{
+			_remove(file);
+			release(file);
+		}
+};
+
+
 /**
  * A 'Rom_session_component' exports a single file of the file system
  */
@@ -54,8 +201,13 @@ class Fs_rom::Rom_session_component :
 
 		File_system::Session &_fs;
 
-		enum { PATH_MAX_LEN = 512 };
-		typedef Genode::Path<PATH_MAX_LEN> Path;
+		File_cache &_cache;
+
+		/**
+		 * True if the session hands out the file version shared via the
+		 * cache instead of a private copy
+		 */
+		bool const _shared;
 
 		/**
 		 * Name of requested file, interpreted at path into the file system
@@ -73,10 +225,18 @@ class Fs_rom::Rom_session_component :
 		File_system::file_size_t _file_size = 0;
 
 		/**
-		 * Read offset of the file
+		 * Number of bytes received while loading the file
 		 */
 		File_system::seek_off_t _file_seek = 0;
 
+		/**
+		 * Destination buffer and size of the requests of a file load
+		 */
+		char    *_read_dst      = nullptr;
+		size_t   _read_chunk    = 0;
+		unsigned _reads_pending = 0;
+		bool     _read_error    = false;
+
 		/**
 		 * Handle of currently watched compound directory
 		 *
@@ -90,6 +250,11 @@ class Fs_rom::Rom_session_component :
 		 */
 		Genode::Attached_ram_dataspace _file_ds;
 
+		/**
+		 * Cached file version exposed to the client instead of '_file_ds'
+		 */
+		Cached_file *_cached_file = nullptr;
+
 		/**
 		 * Signal destination for ROM file changes
 		 */
@@ -207,6 +372,107 @@ class Fs_rom::Rom_session_component :
 			}
 		}
 
+		/**
+		 * Read content of the opened file into 'dst'
+		 *
+		 * Several read requests are kept in flight at a time to hide the
+		 * latency of the file-system server.
+		 *
+		 * \return false if the content could not be read completely
+		 */
+		bool _read_file(char *dst, size_t size)
+		{
+			enum { MAX_PENDING_READS = 4 };
+
+			Tx_source &source = *_fs.tx();
+
+			_read_dst   = dst;
+			_read_chunk = max(source.bulk_buffer_size() / MAX_PENDING_READS, 1UL);
+			_read_error = false;
+			_file_size  = size;
+			_file_seek  = 0;
+
+			/* on error, wait for the requests in flight before returning */
+			size_t submitted = 0;
+			while ((_file_seek < _file_size && !_read_error) || _reads_pending) {
+
+				/* submit as many requests as the packet stream permits */
+				while (submitted < size && !_read_error && source.ready_to_submit()) {
+
+					size_t const chunk_size = min(size - submitted, _read_chunk);
+
+					File_system::Packet_descriptor packet;
+					try {
+						packet = File_system::Packet_descriptor(
+							source.alloc_packet(chunk_size), *_file_handle,
+							File_system::Packet_descriptor::READ,
+							chunk_size, submitted);
+					}
+					catch (Tx_source::Packet_alloc_failed) { break; }
+
+					source.submit_packet(packet);
+					submitted += chunk_size;
+					_reads_pending++;
+				}
+
+				/*
+				 * Process the global signal handler until we got a response
+				 * for one of the read requests
+				 */
+				_env.ep().wait_and_dispatch_one_io_signal();
+			}
+
+			_read_dst = nullptr;
+			return !_read_error;
+		}
+
+		void _release_cached_file()
+		{
+			if (_cached_file)
+				_cache.release(*_cached_file);
+
+			_cached_file = nullptr;
+		}
+
+		/**
+		 * Obtain the current version of the file from the cache
+		 *
+		 * If the cache lacks the current version, the version is loaded
+		 * into the cache.
+		 *
+		 * \return false if the version could not be obtained
+		 */
+		bool _update_cached_file(size_t file_size)
+		{
+			Cached_file *file = _cache.lookup(_file_path, file_size);
+
+			if (file) {
+				_cache.acquire(*file);
+			} else {
+				try { file = &_cache.create(_file_path, file_size); }
+				catch (...) {
+					Genode::error("couldn't allocate memory for file, empty result");
+					return false;
+				}
+
+				/* hold the new version while loading it */
+				_cache.acquire(*file);
+				if (!_read_file(file->content(), file_size)) {
+					_cache.discard(*file);
+					return false;
+				}
+			}
+
+			_release_cached_file();
+			_cached_file = file;
+
+			/* drop private copy obtained earlier */
+			if (_file_ds.size())
+				_file_ds.realloc(&_env.ram(), 0);
+
+			return true;
+		}
+
 		/**
 		 * Initialize '_file_ds' dataspace with file content
 		 */
@@ -261,6 +527,14 @@ class Fs_rom::Rom_session_component :
 			size_t const file_size = _file_handle.constructed()
 			                       ? _fs.status(*_file_handle).size : 0;
 
+			/* share the current version with other sessions */
+			if (_shared && file_size > 0) {
+				if (_update_cached_file(file_size))
+					return;
+
+				_release_cached_file();
+			}
+
 			/* allocate new RAM dataspace according to file size */
 			if (file_size > 0) {
 				try {
@@ -281,30 +555,8 @@ class Fs_rom::Rom_session_component :
 				return;
 
 			/* read content from file */
-			Tx_source &source = *_fs.tx();
-			while (_file_seek < _file_size) {
-				/* if we cannot submit then process acknowledgements */
-				if (source.ready_to_submit()) {
-					size_t chunk_size = min(_file_size - _file_seek,
-					                        source.bulk_buffer_size() / 2);
-					File_system::Packet_descriptor
-						packet(source.alloc_packet(chunk_size),
-						       *_file_handle,
-						       File_system::Packet_descriptor::READ,
-						       chunk_size,
-						       _file_seek);
-					source.submit_packet(packet);
-				}
-
-				/*
-				 * Process the global signal handler until we got a response
-				 * for the read request (indicated by a change of the seek
-				 * position).
-				 */
-				size_t const orig_file_seek = _file_seek;
-				while (_file_seek == orig_file_seek)
-					_env.ep().wait_and_dispatch_one_io_signal();
-			}
+			if (!_read_file(_file_ds.local_addr<char>(), _file_size))
+				_file_ds.realloc(&_env.ram(), 0);
 		}
 
 		void _notify_client_about_new_version()
@@ -319,6 +571,8 @@ class Fs_rom::Rom_session_component :
 		 * Constructor
 		 *
 		 * \param fs        file-system session to read the file from
+		 * \param cache     cache of file versions shared among sessions
+		 * \param shared    true if the session hands out the shared version
 		 * \param filename  requested file name
 		 * \param sig_rec   signal receiver used to get notified about changes
 		 *                  within the compound directory (in the case when
@@ -326,9 +580,10 @@ class Fs_rom::Rom_session_component :
 		 *                  creation time)
 		 */
 		Rom_session_component(Genode::Env &env,
-		                      File_system::Session &fs, const char *file_path)
+		                      File_system::Session &fs, File_cache &cache,
+		                      bool shared, const char *file_path)
 		:
-			_env(env), _fs(fs),
+			_env(env), _fs(fs), _cache(cache), _shared(shared),
 			_file_path(file_path),
 			_file_ds(env.ram(), env.rm(), 0) /* realloc later */
 		{
@@ -344,6 +599,8 @@ class Fs_rom::Rom_session_component :
 		 */
 		~Rom_session_component()
 		{
+			_release_cached_file();
+
 			/* close re-open the file */
 			if (_file_handle.constructed())
 				_fs.close(*_file_handle);
@@ -359,6 +616,8 @@ class Fs_rom::Rom_session_component :
 		{
 			_update_dataspace();
 			Genode::Dataspace_capability ds = _file_ds.cap();
+			if (_cached_file)
+				ds = _cached_file->cap();
 			_handed_out_version = _curr_version;
 			return Genode::static_cap_cast<Genode::Rom_dataspace>(ds);
 		}
@@ -382,6 +641,10 @@ class Fs_rom::Rom_session_component :
 
 				_curr_version = Version { _curr_version.value + 1 };
 
+				/* the cached version of the file has become outdated */
+				if (_file_handle.constructed() && (*_file_handle == packet.handle()))
+					_cache.invalidate(_file_path);
+
 				if ((_file_handle.constructed() && (*_file_handle == packet.handle())) ||
 				    (_compound_dir_handle.constructed() && (*_compound_dir_handle == packet.handle())))
 				{
@@ -395,16 +658,25 @@ class Fs_rom::Rom_session_component :
 				if (!(_file_handle.constructed() && (*_file_handle == packet.handle())))
 					return false;
 
-				if (packet.position() > _file_seek || _file_seek >= _file_size) {
+				if (_reads_pending)
+					_reads_pending--;
+
+				if (!_read_dst || packet.position() >= _file_size) {
 					error("bad packet seek position");
-					_file_ds.realloc(&_env.ram(), 0);
+					_read_error = true;
 					return true;
 				}
 
-				size_t const n = min(packet.length(), _file_size - _file_seek);
-				memcpy(_file_ds.local_addr<char>()+_file_seek,
-				       _fs.tx()->packet_content(packet), n);
-				_file_seek += n;
+				/*
+				 * The requests may be acknowledged in any order. A short
+				 * read leaves the remainder of the request zeroed.
+				 */
+				size_t const position  = packet.position();
+				size_t const requested = min(_read_chunk, _file_size - position);
+				size_t const n         = min(packet.length(), requested);
+
+				memcpy(_read_dst + position, _fs.tx()->packet_content(packet), n);
+				_file_seek += requested;
 				return true;
 			}
 
@@ -455,6 +727,30 @@ class Fs_rom::Rom_root : public Genode::Root_component<Fs_rom::Rom_session_compo
 		Genode::Heap          _heap { _env.ram(), _env.rm() };
 		Genode::Allocator_avl _fs_tx_block_alloc { &_heap };
 
+		File_cache _cache { _env, _heap };
+
+		Genode::Constructible<Genode::Attached_rom_dataspace> _config;
+
+		/**
+		 * Return true if the client shares file versions with other clients
+		 *
+		 * Because the shared RAM dataspaces are writeable, sharing is
+		 * enabled only for clients with a policy that permits it.
+		 */
+		bool _shared(Genode::Session_label const &label)
+		{
+			if (!_config.constructed())
+				return false;
+
+			_config->update();
+			try {
+				Genode::Session_policy policy(label, _config->xml());
+				return policy.attribute_value("shared", false);
+			}
+			catch (Genode::Session_policy::No_policy_defined) { }
+			return false;
+		}
+
 		/* open file-system session */
 		File_system::Connection _fs { _env, _fs_tx_block_alloc };
 
@@ -469,7 +765,8 @@ class Fs_rom::Rom_root : public Genode::Root_component<Fs_rom::Rom_session_compo
 
 			/* create new session for the requested file */
 			Rom_session_component *session = new (md_alloc())
-				Rom_session_component(_env, _fs, module_name.string());
+				Rom_session_component(_env, _fs, _cache, _shared(label),
+				                      module_name.string());
 
 			_packet_handler.sessions.insert(session);
 			return session;
@@ -495,6 +792,10 @@ class Fs_rom::Rom_root : public Genode::Root_component<Fs_rom::Rom_session_compo
 			Genode::Root_component<Rom_session_component>(env.ep(), md_alloc),
 			_env(env)
 		{
+			/* the configuration is optional */
+			try { _config.construct(_env, "config"); }
+			catch (Genode::Rom_connection::Rom_connection_failed) { }
+
 			/* Process CONTENT_CHANGED acknowledgement packets at the entrypoint  */
 			_fs.sigh_ack_avail(_packet_handler);
 
@@ -43,6 +43,14 @@ class Lx_fs::Directory : public Node
 		Path       _path;
 		Allocator &_alloc;
 
+		/*
+		 * Index of the entry returned by the next 'readdir' call
+		 *
+		 * Sequential reads of the directory continue at the cursor instead
+		 * of rewinding the directory stream.
+		 */
+		seek_off_t _cursor = 0;
+
 		unsigned long _inode(char const *path, bool create)
 		{
 			int ret;
@@ -80,13 +88,16 @@ class Lx_fs::Directory : public Node
 			return fd;
 		}
 
-		size_t _num_entries() const
+		size_t _num_entries()
 		{
 			unsigned num = 0;
 
 			rewinddir(_fd);
 			while (readdir(_fd)) ++num;
 
+			/* the stream is at its end now */
+			_cursor = num;
+
 			return num;
 		}
 
@@ -167,29 +178,44 @@ class Lx_fs::Directory : public Node
 
 			seek_off_t index = seek_offset / sizeof(Directory_entry);
 
-			/* seek to index and read entry */
-			struct dirent *dent;
-			rewinddir(_fd);
-			for (unsigned i = 0; i <= index; ++i) {
-				dent = readdir(_fd);
+			/* seek to index */
+			if (index < _cursor) {
+				rewinddir(_fd);
+				_cursor = 0;
 			}
+			for (; _cursor < index; _cursor++)
+				if (!readdir(_fd))
+					return 0;
+
+			/* fill the buffer with as many entries as fit */
+			Directory_entry *e   = (Directory_entry *)(dst);
+			size_t           cnt = 0;
+
+			for (; (cnt + 1)*sizeof(Directory_entry) <= len; e++, cnt++) {
+
+				/* keep the entry for the next read if it cannot be returned */
+				long const pos = telldir(_fd);
+
+				struct dirent *dent = readdir(_fd);
+				if (!dent)
+					break;
+
+				switch (dent->d_type) {
+				case DT_REG: e->type = Directory_entry::TYPE_FILE;      break;
+				case DT_DIR: e->type = Directory_entry::TYPE_DIRECTORY; break;
+				case DT_LNK: e->type = Directory_entry::TYPE_SYMLINK;   break;
+				default:
+					seekdir(_fd, pos);
+					return cnt*sizeof(Directory_entry);
+				}
 
-			if (!dent)
-				return 0;
-
-			Directory_entry *e = (Directory_entry *)(dst);
+				e->inode = dent->d_ino;
+				strncpy(e->name, dent->d_name, sizeof(e->name));
 
-			switch (dent->d_type) {
-			case DT_REG: e->type = Directory_entry::TYPE_FILE;      break;
-			case DT_DIR: e->type = Directory_entry::TYPE_DIRECTORY; break;
-			case DT_LNK: e->type = Directory_entry::TYPE_SYMLINK;   break;
-			default:
-				return 0;
+				_cursor++;
 			}
 
-			strncpy(e->name, dent->d_name, sizeof(e->name));
-
-			return sizeof(Directory_entry);
+			return cnt*sizeof(Directory_entry);
 		}
 
 		size_t write(char const *src, size_t len, seek_off_t seek_offset) override
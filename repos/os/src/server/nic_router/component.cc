@@ -13,6 +13,7 @@
 
 /* Genode includes */
 #include <os/session_policy.h>
+#include <base/env.h>
 
 /* local includes */
 #include <component.h>
@@ -37,13 +38,27 @@ Communication_buffer::Communication_buffer(Ram_session          &ram,
  ** Session_component_base **
  ****************************/
 
+Entrypoint &
+Session_component_base::_init_own_ep(Env                &env,
+                                     Affinity::Location  location)
+{
+	_own_ep.construct(env, (size_t)EP_STACK_SIZE, "nic_session", location);
+	return *_own_ep;
+}
+
+
 Session_component_base::
-Session_component_base(Allocator    &guarded_alloc_backing,
-                       size_t const  guarded_alloc_amount,
-                       Ram_session  &buf_ram,
-                       size_t const  tx_buf_size,
-                       size_t const  rx_buf_size)
+Session_component_base(Env                &env,
+                       Entrypoint         &ep,
+                       bool         const  own_ep,
+                       Affinity::Location  location,
+                       Allocator          &guarded_alloc_backing,
+                       size_t       const  guarded_alloc_amount,
+                       Ram_session        &buf_ram,
+                       size_t       const  tx_buf_size,
+                       size_t       const  rx_buf_size)
 :
+	_ep(own_ep ? _init_own_ep(env, location) : ep),
 	_guarded_alloc(&guarded_alloc_backing, guarded_alloc_amount),
 	_range_alloc(&_guarded_alloc), _tx_buf(buf_ram, tx_buf_size),
 	_rx_buf(buf_ram, rx_buf_size)
@@ -54,26 +69,40 @@ Session_component_base(Allocator    &guarded_alloc_backing,
  ** Session_component **
  ***********************/
 
-Net::Session_component::Session_component(Allocator         &alloc,
-                                          Timer::Connection &timer,
-                                          size_t      const  amount,
-                                          Ram_session       &buf_ram,
-                                          size_t      const  tx_buf_size,
-                                          size_t      const  rx_buf_size,
-                                          Region_map        &region_map,
-                                          Mac_address const  mac,
-                                          Entrypoint        &ep,
-                                          Mac_address const &router_mac,
-                                          Domain            &domain)
+Net::Session_component::Session_component(Env                &env,
+                                          Allocator          &alloc,
+                                          Timer::Connection  &timer,
+                                          size_t       const  amount,
+                                          Ram_session        &buf_ram,
+                                          size_t       const  tx_buf_size,
+                                          size_t       const  rx_buf_size,
+                                          Region_map         &region_map,
+                                          Mac_address  const  mac,
+                                          Entrypoint         &ep,
+                                          bool         const  own_ep,
+                                          Affinity::Location  location,
+                                          Mac_address  const &router_mac,
+                                          Domain             &domain)
 :
-	Session_component_base(alloc, amount, buf_ram, tx_buf_size, rx_buf_size),
+	Session_component_base(env, ep, own_ep, location, alloc, amount, buf_ram,
+	                       tx_buf_size, rx_buf_size),
 	Session_rpc_object(region_map, _tx_buf, _rx_buf, &_range_alloc, ep.rpc_ep()),
-	Interface(ep, timer, router_mac, _guarded_alloc, mac, domain)
+	Interface(_ep, timer, router_mac, _guarded_alloc, mac, domain)
+{
+	_tx.sigh_ready_to_ack(*_sink_ack);
+	_tx.sigh_packet_avail(*_sink_submit);
+	_rx.sigh_ack_avail(*_source_ack);
+	_rx.sigh_ready_to_submit(*_source_submit);
+}
+
+
+Net::Session_component::~Session_component()
 {
-	_tx.sigh_ready_to_ack(_sink_ack);
-	_tx.sigh_packet_avail(_sink_submit);
-	_rx.sigh_ack_avail(_source_ack);
-	_rx.sigh_ready_to_submit(_source_submit);
+	/*
+	 * Detach the interface while '_sink' and '_source' are still valid and
+	 * before the entrypoint of the session's own gets destructed
+	 */
+	_dissolve();
 }
 
 
@@ -81,20 +110,29 @@ Net::Session_component::Session_component(Allocator         &alloc,
  ** Root **
  **********/
 
-Net::Root::Root(Entrypoint        &ep,
+Net::Root::Root(Env               &env,
                 Timer::Connection &timer,
                 Allocator         &alloc,
                 Mac_address const &router_mac,
-                Configuration     &config,
-                Ram_session       &buf_ram,
-                Region_map        &region_map)
+                Configuration     &config)
 :
-	Root_component<Session_component>(&ep.rpc_ep(), &alloc), _timer(timer),
-	_ep(ep), _router_mac(router_mac), _config(config), _buf_ram(buf_ram),
-	_region_map(region_map)
+	Root_component<Session_component>(&env.ep().rpc_ep(), &alloc),
+	_env(env), _timer(timer), _ep(env.ep()), _router_mac(router_mac),
+	_config(config), _buf_ram(env.ram()), _region_map(env.rm())
 { }
 
 
+Affinity::Location Net::Root::_next_session_location()
+{
+	Affinity::Space const space = _env.cpu().affinity_space();
+	unsigned        const total = space.total();
+	unsigned        const cpu   = total > 1 ? 1 + _session_cnt++ % (total - 1)
+	                                        : 0;
+
+	return Affinity::Location(cpu % space.width(), cpu / space.width());
+}
+
+
 Session_component *Net::Root::_create_session(char const *args)
 {
 	try {
@@ -126,11 +164,16 @@ Session_component *Net::Root::_create_session(char const *args)
 			error("insufficient 'ram_quota' for session creation");
 			throw Insufficient_ram_quota();
 		}
+		bool const own_ep = _config.multi_threaded();
+		Affinity::Location const location =
+			own_ep ? _next_session_location() : Affinity::Location();
+
 		return new (md_alloc())
-			Session_component(*md_alloc(), _timer, ram_quota - session_size,
-			                  _buf_ram, tx_buf_size, rx_buf_size, _region_map,
-			                  _mac_alloc.alloc(), _ep, _router_mac,
-			                  domain);
+			Session_component(_env, *md_alloc(), _timer,
+			                  ram_quota - session_size, _buf_ram,
+			                  tx_buf_size, rx_buf_size, _region_map,
+			                  _mac_alloc.alloc(), _ep, own_ep, location,
+			                  _router_mac, domain);
 	}
 	catch (Session_policy::No_policy_defined) {
 		error("no matching policy");
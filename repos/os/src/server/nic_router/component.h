@@ -16,6 +16,8 @@
 
 /* Genode includes */
 #include <base/allocator_guard.h>
+#include <base/entrypoint.h>
+#include <util/reconstructible.h>
 #include <root/component.h>
 #include <nic/packet_allocator.h>
 #include <nic_session/rpc_object.h>
@@ -53,18 +55,38 @@ class Net::Session_component_base
 {
 	protected:
 
-		Genode::Allocator_guard _guarded_alloc;
-		Nic::Packet_allocator   _range_alloc;
-		Communication_buffer    _tx_buf;
-		Communication_buffer    _rx_buf;
+		enum { EP_STACK_SIZE = 16 * 1024 * sizeof(long) };
+
+		Genode::Constructible<Genode::Entrypoint>  _own_ep;
+		Genode::Entrypoint                        &_ep;
+		Genode::Allocator_guard                    _guarded_alloc;
+		Nic::Packet_allocator                      _range_alloc;
+		Communication_buffer                       _tx_buf;
+		Communication_buffer                       _rx_buf;
+
+		Genode::Entrypoint &_init_own_ep(Genode::Env                &env,
+		                                 Genode::Affinity::Location  location);
 
 	public:
 
-		Session_component_base(Genode::Allocator    &guarded_alloc_backing,
-		                       Genode::size_t const  guarded_alloc_amount,
-		                       Genode::Ram_session  &buf_ram,
-		                       Genode::size_t const  tx_buf_size,
-		                       Genode::size_t const  rx_buf_size);
+		/**
+		 * Constructor
+		 *
+		 * \param ep        entrypoint that handles the packets of the session
+		 *                  if 'own_ep' is false
+		 * \param own_ep    whether to handle the packets at an entrypoint
+		 *                  of the session's own
+		 * \param location  CPU affinity of the session's own entrypoint
+		 */
+		Session_component_base(Genode::Env                &env,
+		                       Genode::Entrypoint         &ep,
+		                       bool                 const  own_ep,
+		                       Genode::Affinity::Location  location,
+		                       Genode::Allocator          &guarded_alloc_backing,
+		                       Genode::size_t       const  guarded_alloc_amount,
+		                       Genode::Ram_session        &buf_ram,
+		                       Genode::size_t       const  tx_buf_size,
+		                       Genode::size_t       const  rx_buf_size);
 };
 
 
@@ -83,17 +105,22 @@ class Net::Session_component : public Session_component_base,
 
 	public:
 
-		Session_component(Genode::Allocator    &alloc,
-		                  Timer::Connection    &timer,
-		                  Genode::size_t const  amount,
-		                  Genode::Ram_session  &buf_ram,
-		                  Genode::size_t const  tx_buf_size,
-		                  Genode::size_t const  rx_buf_size,
-		                  Genode::Region_map   &region_map,
-		                  Mac_address    const  mac,
-		                  Genode::Entrypoint   &ep,
-		                  Mac_address    const &router_mac,
-		                  Domain               &domain);
+		Session_component(Genode::Env                &env,
+		                  Genode::Allocator          &alloc,
+		                  Timer::Connection          &timer,
+		                  Genode::size_t       const  amount,
+		                  Genode::Ram_session        &buf_ram,
+		                  Genode::size_t       const  tx_buf_size,
+		                  Genode::size_t       const  rx_buf_size,
+		                  Genode::Region_map         &region_map,
+		                  Mac_address          const  mac,
+		                  Genode::Entrypoint         &ep,
+		                  bool                 const  own_ep,
+		                  Genode::Affinity::Location  location,
+		                  Mac_address          const &router_mac,
+		                  Domain                     &domain);
+
+		~Session_component();
 
 
 		/******************
@@ -110,6 +137,7 @@ class Net::Root : public Genode::Root_component<Session_component>
 {
 	private:
 
+		Genode::Env         &_env;
 		Timer::Connection   &_timer;
 		Mac_allocator        _mac_alloc;
 		Genode::Entrypoint  &_ep;
@@ -117,6 +145,16 @@ class Net::Root : public Genode::Root_component<Session_component>
 		Configuration       &_config;
 		Genode::Ram_session &_buf_ram;
 		Genode::Region_map  &_region_map;
+		unsigned             _session_cnt = 0;
+
+		/**
+		 * Return CPU for the entrypoint of the next session
+		 *
+		 * Sessions are distributed round-robin over the affinity space
+		 * while the first CPU is left to the uplink, which is handled by
+		 * the component entrypoint.
+		 */
+		Genode::Affinity::Location _next_session_location();
 
 
 		/********************
@@ -127,13 +165,11 @@ class Net::Root : public Genode::Root_component<Session_component>
 
 	public:
 
-		Root(Genode::Entrypoint  &ep,
-		     Timer::Connection   &timer,
-		     Genode::Allocator   &alloc,
-		     Mac_address const   &router_mac,
-		     Configuration       &config,
-		     Genode::Ram_session &buf_ram,
-		     Genode::Region_map  &region_map);
+		Root(Genode::Env       &env,
+		     Timer::Connection &timer,
+		     Genode::Allocator &alloc,
+		     Mac_address const &router_mac,
+		     Configuration     &config);
 };
 
 #endif /* _COMPONENT_H_ */
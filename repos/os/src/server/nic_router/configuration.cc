@@ -39,6 +39,7 @@ Configuration::Configuration(Xml_node const  node,
                              Allocator      &alloc)
 :
 	_alloc(alloc), _verbose(node.attribute_value("verbose", false)),
+	_multi_threaded(node.attribute_value("multi_threaded", false)),
 	_rtt(_init_rtt(node)), _node(node)
 {
 	/* read domains */
@@ -19,6 +19,7 @@
 
 /* Genode includes */
 #include <os/duration.h>
+#include <base/lock.h>
 
 namespace Genode { class Allocator; }
 
@@ -31,10 +32,18 @@ class Net::Configuration
 
 		Genode::Allocator          &_alloc;
 		bool                 const  _verbose;
+		bool                 const  _multi_threaded;
 		Genode::Microseconds const  _rtt;
 		Domain_tree                 _domains;
 		Genode::Xml_node     const  _node;
 
+		/*
+		 * Serializes all accesses to the routing state, i.e., domains,
+		 * interfaces, links, ARP caches and IP allocations, in case the
+		 * interfaces are handled by multiple entrypoints
+		 */
+		Genode::Lock                _state_lock { };
+
 		Genode::Microseconds _init_rtt(Genode::Xml_node const node);
 
 	public:
@@ -48,10 +57,12 @@ class Net::Configuration
 		 ** Accessors **
 		 ***************/
 
-		bool                  verbose() const { return _verbose; }
-		Genode::Microseconds  rtt()     const { return _rtt; }
-		Domain_tree          &domains()       { return _domains; }
-		Genode::Xml_node      node()    const { return _node; }
+		bool                  verbose()        const { return _verbose; }
+		bool                  multi_threaded() const { return _multi_threaded; }
+		Genode::Microseconds  rtt()            const { return _rtt; }
+		Domain_tree          &domains()              { return _domains; }
+		Genode::Xml_node      node()           const { return _node; }
+		Genode::Lock         &state_lock()           { return _state_lock; }
 };
 
 #endif /* _CONFIGURATION_H_ */
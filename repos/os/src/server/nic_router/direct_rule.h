@@ -21,6 +21,7 @@
 
 /* local includes */
 #include <rule.h>
+#include <prefix_tree.h>
 
 namespace Genode { class Xml_node; }
 
@@ -60,41 +61,43 @@ class Net::Direct_rule_base : public Rule
 
 template <typename T>
 struct Net::Direct_rule : Direct_rule_base,
-                          Direct_rule_list<T>::Element
+                          Direct_rule_list<T>::Element,
+                          Prefix_tree<T>::Element
 {
 	Direct_rule(Genode::Xml_node const node) : Direct_rule_base(node) { }
 };
 
 
+/**
+ * List of direct rules with a prefix tree for the per-packet lookup
+ */
 template <typename T>
-struct Net::Direct_rule_list : Genode::List<T>
+class Net::Direct_rule_list : public Genode::List<T>
 {
-	using List = Genode::List<T>;
+	private:
+
+		using List = Genode::List<T>;
 
-	struct No_match : Genode::Exception { };
+		Prefix_tree<T> _tree { };
+
+	public:
 
-	T const &longest_prefix_match(Ipv4_address const &ip) const
-	{
-		/* first match is sufficient as the list is prefix-size-sorted */
-		for (T const *curr = List::first(); curr; curr = curr->next()) {
-			if (curr->dst().prefix_matches(ip)) {
-				return *curr; }
+		struct No_match : Genode::Exception { };
+
+		T const &longest_prefix_match(Ipv4_address const &ip) const
+		{
+			T const *rule = _tree.longest_prefix_match(ip);
+			if (!rule) {
+				throw No_match(); }
+
+			return *rule;
 		}
-		throw No_match();
-	}
-
-	void insert(T &rule)
-	{
-		/* ensure that the list stays prefix-size-sorted (descending) */
-		T *behind = nullptr;
-		for (T *curr = List::first(); curr; curr = curr->next()) {
-			if (rule.dst().prefix >= curr->dst().prefix) {
-				break; }
-
-			behind = curr;
+
+		void insert(T &rule)
+		{
+			_tree.insert(rule.dst(), rule);
+			List::insert(&rule);
 		}
-		List::insert(&rule, behind);
-	}
 };
 
 #endif /* _RULE_H_ */
@@ -51,31 +51,6 @@ class Size_guard
  ** Utilities **
  ***************/
 
-template <typename LINK_TYPE>
-static void _destroy_closed_links(Link_list   &closed_links,
-                                  Deallocator &dealloc)
-{
-	while (Link *link = closed_links.first()) {
-		closed_links.remove(link);
-		destroy(dealloc, static_cast<LINK_TYPE *>(link));
-	}
-}
-
-
-template <typename LINK_TYPE>
-static void _destroy_links(Link_side_tree &links,
-                           Link_list      &closed_links,
-                           Deallocator    &dealloc)
-{
-	_destroy_closed_links<LINK_TYPE>(closed_links, dealloc);
-	while (Link_side *link_side = links.first()) {
-		Link &link = link_side->link();
-		link.dissolve();
-		destroy(dealloc, static_cast<LINK_TYPE *>(&link));
-	}
-}
-
-
 static void _link_packet(L3_protocol  const  prot,
                          void        *const  prot_base,
                          Link               &link,
@@ -97,23 +72,6 @@ static void _link_packet(L3_protocol  const  prot,
 }
 
 
-static void _update_checksum(L3_protocol   const prot,
-                             void         *const prot_base,
-                             size_t        const prot_size,
-                             Ipv4_address  const src,
-                             Ipv4_address  const dst)
-{
-	switch (prot) {
-	case L3_protocol::TCP:
-		((Tcp_packet *)prot_base)->update_checksum(src, dst, prot_size);
-		return;
-	case L3_protocol::UDP:
-		((Udp_packet *)prot_base)->update_checksum(src, dst);
-		return;
-	default: throw Interface::Bad_transport_protocol(); }
-}
-
-
 static Port _dst_port(L3_protocol const prot, void *const prot_base)
 {
 	switch (prot) {
@@ -128,8 +86,8 @@ static void _dst_port(L3_protocol  const prot,
                       Port         const port)
 {
 	switch (prot) {
-	case L3_protocol::TCP: (*(Tcp_packet *)prot_base).dst_port(port); return;
-	case L3_protocol::UDP: (*(Udp_packet *)prot_base).dst_port(port); return;
+	case L3_protocol::TCP: (*(Tcp_packet *)prot_base).dst_port_adapt_checksum(port); return;
+	case L3_protocol::UDP: (*(Udp_packet *)prot_base).dst_port_adapt_checksum(port); return;
 	default: throw Interface::Bad_transport_protocol(); }
 }
 
@@ -148,12 +106,47 @@ static void _src_port(L3_protocol  const prot,
                       Port         const port)
 {
 	switch (prot) {
-	case L3_protocol::TCP: ((Tcp_packet *)prot_base)->src_port(port); return;
-	case L3_protocol::UDP: ((Udp_packet *)prot_base)->src_port(port); return;
+	case L3_protocol::TCP: ((Tcp_packet *)prot_base)->src_port_adapt_checksum(port); return;
+	case L3_protocol::UDP: ((Udp_packet *)prot_base)->src_port_adapt_checksum(port); return;
 	default: throw Interface::Bad_transport_protocol(); }
 }
 
 
+/**
+ * Adapt transport checksum to the change of an address of the pseudo header
+ */
+static void _adapt_checksum(L3_protocol   const  prot,
+                            void         *const  prot_base,
+                            Ipv4_address  const &old_ip,
+                            Ipv4_address  const &new_ip)
+{
+	switch (prot) {
+	case L3_protocol::TCP: ((Tcp_packet *)prot_base)->adapt_checksum(old_ip, new_ip); return;
+	case L3_protocol::UDP: ((Udp_packet *)prot_base)->adapt_checksum(old_ip, new_ip); return;
+	default: throw Interface::Bad_transport_protocol(); }
+}
+
+
+static void _src_ip(Ipv4_packet        &ip,
+                    L3_protocol  const  prot,
+                    void        *const  prot_base,
+                    Ipv4_address const &src)
+{
+	_adapt_checksum(prot, prot_base, ip.src(), src);
+	ip.src_adapt_checksum(src);
+}
+
+
+static void _dst_ip(Ipv4_packet        &ip,
+                    L3_protocol  const  prot,
+                    void        *const  prot_base,
+                    Ipv4_address const &dst)
+{
+	_adapt_checksum(prot, prot_base, ip.dst(), dst);
+	ip.dst_adapt_checksum(dst);
+}
+
+
 static void *_prot_base(L3_protocol const  prot,
                         size_t      const  prot_size,
                         Ipv4_packet       &ip)
@@ -169,24 +162,29 @@ static void *_prot_base(L3_protocol const  prot,
  ** Interface **
  ***************/
 
-void Interface::_pass_prot(Ethernet_frame       &eth,
-                           size_t         const  eth_size,
-                           Ipv4_packet          &ip,
-                           L3_protocol    const  prot,
-                           void          *const  prot_base,
-                           size_t         const  prot_size)
+void Interface::_pass(Interface      &dst,
+                      Ethernet_frame &eth,
+                      size_t   const  eth_size)
 {
-	_update_checksum(prot, prot_base, prot_size, ip.src(), ip.dst());
-	_pass_ip(eth, eth_size, ip);
-}
-
-
-void Interface::_pass_ip(Ethernet_frame &eth,
-                         size_t   const  eth_size,
-                         Ipv4_packet    &ip)
-{
-	ip.checksum(Ipv4_packet::calculate_checksum(ip));
-	_send(eth, eth_size);
+	/*
+	 * Address and port rewrites adapt the IPv4 and transport checksums
+	 * incrementally (RFC 1624), so the packet can be sent as is.
+	 */
+	if (!_deferred_send) {
+		dst._send(eth, eth_size);
+		return;
+	}
+	/*
+	 * While handling a packet of our own sink, copying the frame is left
+	 * to '_ready_to_submit' after it released the state lock. This way,
+	 * the data planes of different interfaces run in parallel. Holding the
+	 * source lock of the destination meanwhile keeps the destination from
+	 * being destructed.
+	 */
+	dst._source_lock.lock();
+	_deferred_send->dst  = &dst;
+	_deferred_send->eth  = &eth;
+	_deferred_send->size = eth_size;
 }
 
 
@@ -220,11 +218,11 @@ Interface::_new_link(L3_protocol                   const  protocol,
 	switch (protocol) {
 	case L3_protocol::TCP:
 		{
-			Tcp_link &link = *new (_alloc)
+			Tcp_link &link = *new (_tcp_link_slab)
 				Tcp_link(*this, local, remote_port_alloc, remote_interface,
-				         remote, _timer, _config(), protocol);
-			_tcp_links.insert(&link.client());
-			remote_interface._tcp_links.insert(&link.server());
+				         remote, _link_wheel, _config(), protocol);
+			_tcp_links.insert(link.client());
+			remote_interface._tcp_links.insert(link.server());
 			if (_config().verbose()) {
 				log("New TCP client link: ", link.client(), " at ", *this);
 				log("New TCP server link: ", link.server(),
@@ -234,11 +232,11 @@ Interface::_new_link(L3_protocol                   const  protocol,
 		}
 	case L3_protocol::UDP:
 		{
-			Udp_link &link = *new (_alloc)
+			Udp_link &link = *new (_udp_link_slab)
 				Udp_link(*this, local, remote_port_alloc, remote_interface,
-				         remote, _timer, _config(), protocol);
-			_udp_links.insert(&link.client());
-			remote_interface._udp_links.insert(&link.server());
+				         remote, _link_wheel, _config(), protocol);
+			_udp_links.insert(link.client());
+			remote_interface._udp_links.insert(link.server());
 			if (_config().verbose()) {
 				log("New UDP client link: ", link.client(), " at ", *this);
 				log("New UDP server link: ", link.server(),
@@ -250,7 +248,7 @@ Interface::_new_link(L3_protocol                   const  protocol,
 }
 
 
-Link_side_tree &Interface::_links(L3_protocol const protocol)
+Link_side_table &Interface::_links(L3_protocol const protocol)
 {
 	switch (protocol) {
 	case L3_protocol::TCP: return _tcp_links;
@@ -259,6 +257,43 @@ Link_side_tree &Interface::_links(L3_protocol const protocol)
 }
 
 
+Deallocator &Interface::_link_slab(L3_protocol const protocol)
+{
+	switch (protocol) {
+	case L3_protocol::TCP: return _tcp_link_slab;
+	case L3_protocol::UDP: return _udp_link_slab;
+	default: throw Bad_transport_protocol(); }
+}
+
+
+template <typename LINK_TYPE>
+void Interface::_destroy_closed_links(Link_list &closed_links)
+{
+	/* closed links are listed at the client interface, which owns them */
+	while (Link *link = closed_links.first()) {
+		closed_links.remove(link);
+		destroy(_link_slab(link->protocol()), static_cast<LINK_TYPE *>(link));
+	}
+}
+
+
+template <typename LINK_TYPE>
+void Interface::_destroy_links(Link_side_table &links,
+                               Link_list       &closed_links)
+{
+	_destroy_closed_links<LINK_TYPE>(closed_links);
+	while (Link_side *link_side = links.first()) {
+		Link &link = link_side->link();
+		link.dissolve();
+
+		/* the link is owned by the slab of its client interface */
+		Interface &owner = link.client().interface();
+		destroy(owner._link_slab(link.protocol()),
+		        static_cast<LINK_TYPE *>(&link));
+	}
+}
+
+
 void Interface::link_closed(Link &link, L3_protocol const prot)
 {
 	_closed_links(prot).insert(&link);
@@ -274,7 +309,7 @@ void Interface::ip_allocation_expired(Ip_allocation &allocation)
 
 void Interface::dissolve_link(Link_side &link_side, L3_protocol const prot)
 {
-	_links(prot).remove(&link_side);
+	_links(prot).remove(link_side);
 }
 
 
@@ -309,7 +344,6 @@ void Interface::_nat_link_and_pass(Ethernet_frame        &eth,
                                    Ipv4_packet           &ip,
                                    L3_protocol     const  prot,
                                    void           *const  prot_base,
-                                   size_t          const  prot_size,
                                    Link_side_id    const &local,
                                    Interface             &interface)
 {
@@ -320,14 +354,14 @@ void Interface::_nat_link_and_pass(Ethernet_frame        &eth,
 			log("Using NAT rule: ", nat); }
 
 		_src_port(prot, prot_base, nat.port_alloc(prot).alloc());
-		ip.src(interface._router_ip());
+		_src_ip(ip, prot, prot_base, interface._router_ip());
 		remote_port_alloc.set(nat.port_alloc(prot));
 	}
 	catch (Nat_rule_tree::No_match) { }
 	Link_side_id const remote = { ip.dst(), _dst_port(prot, prot_base),
 	                              ip.src(), _src_port(prot, prot_base) };
 	_new_link(prot, local, remote_port_alloc, interface, remote);
-	interface._pass_prot(eth, eth_size, ip, prot, prot_base, prot_size);
+	_pass(interface, eth, eth_size);
 }
 
 
@@ -601,16 +635,16 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 				log("Using ", l3_protocol_name(prot), " link: ", link); }
 
 			_adapt_eth(eth, eth_size, remote_side.src_ip(), pkt, interface);
-			ip.src(remote_side.dst_ip());
-			ip.dst(remote_side.src_ip());
+			_src_ip(ip, prot, prot_base, remote_side.dst_ip());
+			_dst_ip(ip, prot, prot_base, remote_side.src_ip());
 			_src_port(prot, prot_base, remote_side.dst_port());
 			_dst_port(prot, prot_base, remote_side.src_port());
 
-			interface._pass_prot(eth, eth_size, ip, prot, prot_base, prot_size);
+			_pass(interface, eth, eth_size);
 			_link_packet(prot, prot_base, link, client);
 			return;
 		}
-		catch (Link_side_tree::No_match) { }
+		catch (Link_side_table::No_match) { }
 
 		/* try to route via forward rules */
 		if (local.dst_ip == _router_ip()) {
@@ -623,8 +657,8 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 					log("Using forward rule: ", l3_protocol_name(prot), " ", rule); }
 
 				_adapt_eth(eth, eth_size, rule.to(), pkt, interface);
-				ip.dst(rule.to());
-				_nat_link_and_pass(eth, eth_size, ip, prot, prot_base, prot_size,
+				_dst_ip(ip, prot, prot_base, rule.to());
+				_nat_link_and_pass(eth, eth_size, ip, prot, prot_base,
 				                   local, interface);
 				return;
 			}
@@ -644,7 +678,7 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 				    " ", permit_rule); }
 
 			_adapt_eth(eth, eth_size, local.dst_ip, pkt, interface);
-			_nat_link_and_pass(eth, eth_size, ip, prot, prot_base, prot_size,
+			_nat_link_and_pass(eth, eth_size, ip, prot, prot_base,
 			                   local, interface);
 			return;
 		}
@@ -663,7 +697,7 @@ void Interface::_handle_ip(Ethernet_frame          &eth,
 			log("Using IP rule: ", rule); }
 
 		_adapt_eth(eth, eth_size, ip.dst(), pkt, interface);
-		interface._pass_ip(eth, eth_size, ip);
+		_pass(interface, eth, eth_size);
 		return;
 	}
 	catch (Ip_rule_list::No_match) { }
@@ -785,8 +819,24 @@ void Interface::_ready_to_submit()
 		if (!pkt.size()) {
 			continue; }
 
-		try { _handle_eth(_sink().packet_content(pkt), pkt.size(), pkt); }
-		catch (Packet_postponed) { continue; }
+		Deferred_send send;
+		{
+			Lock_guard<Lock> guard(_config().state_lock());
+			if (_dissolved) {
+				return; }
+
+			_deferred_send = &send;
+			try { _handle_eth(_sink().packet_content(pkt), pkt.size(), pkt); }
+			catch (Packet_postponed) {
+				_deferred_send = nullptr;
+				continue;
+			}
+			_deferred_send = nullptr;
+		}
+		if (send.dst) {
+			send.dst->_copy_and_submit(*send.eth, send.size);
+			send.dst->_source_lock.unlock();
+		}
 		_ack_packet(pkt);
 	}
 }
@@ -794,14 +844,26 @@ void Interface::_ready_to_submit()
 
 void Interface::_continue_handle_eth(Packet_descriptor const &pkt)
 {
+	/*
+	 * The packet may be resumed while this interface handles a packet of
+	 * its own sink. The deferred send is reserved for the latter. Hence,
+	 * the resumed packet is sent directly, which also ensures that its
+	 * payload got copied before we acknowledge it.
+	 */
+	Deferred_send * const deferred_send = _deferred_send;
+	_deferred_send = nullptr;
+
 	try { _handle_eth(_sink().packet_content(pkt), pkt.size(), pkt); }
 	catch (Packet_postponed) { error("failed twice to handle packet"); }
+
+	_deferred_send = deferred_send;
 	_ack_packet(pkt);
 }
 
 
 void Interface::_ready_to_ack()
 {
+	Lock_guard<Lock> guard(_source_lock);
 	while (_source().ack_avail()) {
 		_source().release_packet(_source().get_acked_packet()); }
 }
@@ -828,8 +890,8 @@ void Interface::_handle_eth(void              *const  eth_base,
                             Packet_descriptor  const &pkt)
 {
 	/* do garbage collection over transport-layer links and IP allocations */
-	_destroy_closed_links<Udp_link>(_closed_udp_links, _alloc);
-	_destroy_closed_links<Tcp_link>(_closed_tcp_links, _alloc);
+	_destroy_closed_links<Udp_link>(_closed_udp_links);
+	_destroy_closed_links<Tcp_link>(_closed_tcp_links);
 	_destroy_released_ip_allocations();
 
 	/* inspect and handle ethernet frame */
@@ -878,6 +940,13 @@ void Interface::_handle_eth(void              *const  eth_base,
 
 
 void Interface::_send(Ethernet_frame &eth, Genode::size_t const size)
+{
+	Lock_guard<Lock> guard(_source_lock);
+	_copy_and_submit(eth, size);
+}
+
+
+void Interface::_copy_and_submit(Ethernet_frame &eth, Genode::size_t const size)
 {
 	if (_config().verbose()) {
 		log("\033[33m(", _domain, " <- router)\033[0m ", eth); }
@@ -902,13 +971,16 @@ Interface::Interface(Entrypoint        &ep,
                      Mac_address const  mac,
                      Domain            &domain)
 :
-	_sink_ack(ep, *this, &Interface::_ack_avail),
-	_sink_submit(ep, *this, &Interface::_ready_to_submit),
-	_source_ack(ep, *this, &Interface::_ready_to_ack),
-	_source_submit(ep, *this, &Interface::_packet_avail),
 	_router_mac(router_mac), _mac(mac), _timer(timer), _alloc(alloc),
-	_domain(domain)
+	_domain(domain),
+	_link_wheel(timer, _config().rtt(), _config().state_lock())
 {
+	_sink_ack     .construct(ep, *this, &Interface::_ack_avail);
+	_sink_submit  .construct(ep, *this, &Interface::_ready_to_submit);
+	_source_ack   .construct(ep, *this, &Interface::_ready_to_ack);
+	_source_submit.construct(ep, *this, &Interface::_packet_avail);
+
+	Lock_guard<Lock> guard(_config().state_lock());
 	if (_config().verbose()) {
 		log("Interface connected ", *this);
 		log("  MAC ", _mac);
@@ -939,28 +1011,55 @@ void Interface::_cancel_arp_waiting(Arp_waiter &waiter)
 
 Interface::~Interface()
 {
-	_domain.interface().unset();
-	if (_config().verbose()) {
-		log("Interface disconnected ", *this); }
+	if (!_dissolved) {
+		error("interface not dissolved by derived class"); }
+}
+
 
-	/* destroy ARP waiters */
-	while (_own_arp_waiters.first()) {
-		_cancel_arp_waiting(*_foreign_arp_waiters.first()->object()); }
+void Interface::_dissolve()
+{
+	/*
+	 * Dissolving a signal handler blocks until its execution, possibly at
+	 * the session's own entrypoint, finished. Afterwards, no packet-stream
+	 * signal of the interface gets handled anymore.
+	 */
+	_sink_ack.destruct();
+	_sink_submit.destruct();
+	_source_ack.destruct();
+	_source_submit.destruct();
 
-	while (_foreign_arp_waiters.first()) {
-		Arp_waiter &waiter = *_foreign_arp_waiters.first()->object();
-		waiter.src()._cancel_arp_waiting(waiter); }
+	{
+		Lock_guard<Lock> guard(_config().state_lock());
+		_dissolved = true;
+		_domain.interface().unset();
+		if (_config().verbose()) {
+			log("Interface disconnected ", *this); }
 
-	/* destroy links */
-	_destroy_links<Tcp_link>(_tcp_links, _closed_tcp_links, _alloc);
-	_destroy_links<Udp_link>(_udp_links, _closed_udp_links, _alloc);
+		/* destroy ARP waiters */
+		while (_own_arp_waiters.first()) {
+			_cancel_arp_waiting(*_own_arp_waiters.first()->object()); }
 
-	/* destroy IP allocations */
-	_destroy_released_ip_allocations();
-	while (Ip_allocation *allocation = _ip_allocations.first()) {
-		_ip_allocations.remove(allocation);
-		_destroy_ip_allocation(*allocation);
+		while (_foreign_arp_waiters.first()) {
+			Arp_waiter &waiter = *_foreign_arp_waiters.first()->object();
+			waiter.src()._cancel_arp_waiting(waiter); }
+
+		/* destroy links */
+		_destroy_links<Tcp_link>(_tcp_links, _closed_tcp_links);
+		_destroy_links<Udp_link>(_udp_links, _closed_udp_links);
+
+		/* destroy IP allocations */
+		_destroy_released_ip_allocations();
+		while (Ip_allocation *allocation = _ip_allocations.first()) {
+			_ip_allocations.remove(allocation);
+			_destroy_ip_allocation(*allocation);
+		}
 	}
+
+	/*
+	 * Once the interface is unset, no other interface can pick it as
+	 * destination. Wait until the ongoing copies to our source finished.
+	 */
+	Lock_guard<Lock> guard(_source_lock);
 }
 
 
@@ -1027,6 +1126,7 @@ void Ip_allocation::print(Output &output) const
 
 void Ip_allocation::_handle_release_timeout(Duration)
 {
+	Lock_guard<Lock> guard(_config.state_lock());
 	_interface.ip_allocation_expired(*this);
 }
 
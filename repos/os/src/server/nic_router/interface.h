@@ -23,6 +23,7 @@
 /* Genode includes */
 #include <nic_session/nic_session.h>
 #include <net/dhcp.h>
+#include <base/tslab.h>
 
 namespace Net {
 
@@ -112,13 +113,28 @@ class Net::Interface
 
 		using Signal_handler = Genode::Signal_handler<Interface>;
 
-		Signal_handler    _sink_ack;
-		Signal_handler    _sink_submit;
-		Signal_handler    _source_ack;
-		Signal_handler    _source_submit;
+		/*
+		 * The handlers may be executed at an entrypoint of the session's
+		 * own. They are destructed by '_dissolve' before the derived
+		 * class, which implements '_sink' and '_source', vanishes.
+		 */
+		Genode::Constructible<Signal_handler> _sink_ack;
+		Genode::Constructible<Signal_handler> _sink_submit;
+		Genode::Constructible<Signal_handler> _source_ack;
+		Genode::Constructible<Signal_handler> _source_submit;
+
 		Mac_address const _router_mac;
 		Mac_address const _mac;
 
+		/**
+		 * Detach the interface from the router
+		 *
+		 * Must be called by the destructor of the derived class. When
+		 * returning, no signal handler of the interface is executing
+		 * anymore and no other interface copies frames to its source.
+		 */
+		void _dissolve();
+
 	private:
 
 		Timer::Connection  &_timer;
@@ -127,13 +143,34 @@ class Net::Interface
 		Arp_cache           _arp_cache;
 		Arp_waiter_list     _own_arp_waiters;
 		Arp_waiter_list     _foreign_arp_waiters;
-		Link_side_tree      _tcp_links;
-		Link_side_tree      _udp_links;
+		enum { LINK_SLAB_BLOCK_SIZE = 4000 };
+
+		Genode::Tslab<Tcp_link, LINK_SLAB_BLOCK_SIZE> _tcp_link_slab { _alloc };
+		Genode::Tslab<Udp_link, LINK_SLAB_BLOCK_SIZE> _udp_link_slab { _alloc };
+
+		Link_side_table     _tcp_links { _alloc };
+		Link_side_table     _udp_links { _alloc };
 		Link_list           _closed_tcp_links;
 		Link_list           _closed_udp_links;
+		Link_wheel          _link_wheel;
 		Ip_allocation_tree  _ip_allocations;
 		Ip_allocation_list  _released_ip_allocations;
 
+		/**
+		 * Frame that is copied to another interface only after the
+		 * state lock is released
+		 */
+		struct Deferred_send
+		{
+			Interface      *dst  = nullptr;
+			Ethernet_frame *eth  = nullptr;
+			Genode::size_t  size = 0;
+		};
+
+		Genode::Lock        _source_lock { };
+		Deferred_send      *_deferred_send = nullptr;
+		bool                _dissolved     = false;
+
 		void _new_link(L3_protocol                   const  protocol,
 		               Link_side_id                  const &local_id,
 		               Pointer<Port_allocator_guard> const  remote_port_alloc,
@@ -183,7 +220,6 @@ class Net::Interface
 		                        Ipv4_packet            &ip,
 		                        L3_protocol      const  prot,
 		                        void            *const  prot_base,
-		                        Genode::size_t   const  prot_size,
 		                        Link_side_id     const &local_id,
 		                        Interface              &interface);
 
@@ -191,22 +227,26 @@ class Net::Interface
 
 		void _send(Ethernet_frame &eth, Genode::size_t const eth_size);
 
-		void _pass_prot(Ethernet_frame         &eth,
-		                Genode::size_t   const  eth_size,
-		                Ipv4_packet            &ip,
-		                L3_protocol      const  prot,
-		                void            *const  prot_base,
-		                Genode::size_t   const  prot_size);
+		void _copy_and_submit(Ethernet_frame       &eth,
+		                      Genode::size_t const  eth_size);
 
-		void _pass_ip(Ethernet_frame       &eth,
-		              Genode::size_t const  eth_size,
-		              Ipv4_packet          &ip);
+		void _pass(Interface            &dst,
+		           Ethernet_frame       &eth,
+		           Genode::size_t const  eth_size);
 
 		void _continue_handle_eth(Packet_descriptor const &pkt);
 
 		Link_list &_closed_links(L3_protocol const protocol);
 
-		Link_side_tree &_links(L3_protocol const protocol);
+		Link_side_table &_links(L3_protocol const protocol);
+
+		Genode::Deallocator &_link_slab(L3_protocol const protocol);
+
+		template <typename LINK_TYPE>
+		void _destroy_closed_links(Link_list &closed_links);
+
+		template <typename LINK_TYPE>
+		void _destroy_links(Link_side_table &links, Link_list &closed_links);
 
 		Configuration &_config() const;
 
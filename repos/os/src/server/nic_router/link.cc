@@ -41,9 +41,16 @@ bool Link_side_id::operator == (Link_side_id const &id) const
 }
 
 
-bool Link_side_id::operator > (Link_side_id const &id) const
+uint32_t Link_side_id::hash() const
 {
-	return memcmp(id.data_base(), data_base(), data_size()) > 0;
+	/* FNV-1a */
+	uint8_t const *byte = (uint8_t const *)data_base();
+	uint32_t       hash = 2166136261U;
+	for (size_t i = 0; i < data_size(); i++) {
+		hash ^= byte[i];
+		hash *= 16777619U;
+	}
+	return hash;
 }
 
 
@@ -55,24 +62,10 @@ Link_side::Link_side(Interface          &interface,
                      Link_side_id const &id,
                      Link               &link)
 :
-	_interface(interface), _id(id), _link(link)
+	_interface(interface), _id(id), _hash(id.hash()), _link(link)
 { }
 
 
-Link_side const &Link_side::find_by_id(Link_side_id const &id) const
-{
-	if (id == _id) {
-		return *this; }
-
-	bool const side = id > _id;
-	Link_side *const link_side = Avl_node<Link_side>::child(side);
-	if (!link_side) {
-		throw Link_side_tree::No_match(); }
-
-	return link_side->find_by_id(id);
-}
-
-
 void Link_side::print(Output &output) const
 {
 	Genode::print(output, "src ", src_ip(), ":", src_port(),
@@ -86,17 +79,197 @@ bool Link_side::is_client() const
 }
 
 
-/********************
- ** Link_side_tree **
- ********************/
+/*********************
+ ** Link_side_table **
+ *********************/
+
+Link_side_table::~Link_side_table()
+{
+	if (_slots) {
+		_alloc.free(_slots, _capacity * sizeof(Link_side *)); }
+}
+
 
-Link_side const &Link_side_tree::find_by_id(Link_side_id const &id) const
+Link_side const &Link_side_table::find_by_id(Link_side_id const &id) const
 {
-	Link_side *const link_side = first();
-	if (!link_side) {
+	if (!_used) {
 		throw No_match(); }
 
-	return link_side->find_by_id(id);
+	uint32_t const hash = id.hash();
+	for (size_t i = _slot(hash); _slots[i]; i = _next(i)) {
+		Link_side const &side = *_slots[i];
+		if (side._hash == hash && side._id == id) {
+			return side; }
+	}
+	throw No_match();
+}
+
+
+void Link_side_table::_insert(Link_side &side)
+{
+	size_t i = _slot(side._hash);
+	for (; _slots[i]; i = _next(i));
+	_slots[i] = &side;
+	_used++;
+	_first_hint = min(_first_hint, i);
+}
+
+
+void Link_side_table::_grow()
+{
+	Link_side  **const old_slots    = _slots;
+	size_t       const old_capacity = _capacity;
+
+	_capacity = old_capacity ? old_capacity * 2 : (size_t)INITIAL_CAPACITY;
+	_slots    = (Link_side **)_alloc.alloc(_capacity * sizeof(Link_side *));
+	memset(_slots, 0, _capacity * sizeof(Link_side *));
+	_used       = 0;
+	_first_hint = 0;
+
+	for (size_t i = 0; i < old_capacity; i++) {
+		if (old_slots[i]) {
+			_insert(*old_slots[i]); }
+	}
+	if (old_slots) {
+		_alloc.free(old_slots, old_capacity * sizeof(Link_side *)); }
+}
+
+
+void Link_side_table::insert(Link_side &side)
+{
+	/* keep the load factor below one half */
+	if ((_used + 1) * 2 > _capacity) {
+		_grow(); }
+
+	_insert(side);
+}
+
+
+void Link_side_table::remove(Link_side &side)
+{
+	if (!_used) {
+		return; }
+
+	size_t hole = _slot(side._hash);
+	for (; _slots[hole] != &side; hole = _next(hole)) {
+		if (!_slots[hole]) {
+			return; }
+	}
+	_slots[hole] = nullptr;
+	_used--;
+	_first_hint = min(_first_hint, hole);
+
+	/* move subsequent entries of the probe sequence into the hole */
+	for (size_t i = _next(hole); _slots[i]; i = _next(i)) {
+
+		size_t const home = _slot(_slots[i]->_hash);
+
+		/* entry may stay if its home lies cyclically in (hole, i] */
+		bool const stays = hole <= i ? (hole < home && home <= i)
+		                             : (hole < home || home <= i);
+		if (stays) {
+			continue; }
+
+		_slots[hole] = _slots[i];
+		_slots[i]    = nullptr;
+		_first_hint  = min(_first_hint, hole);
+		hole         = i;
+	}
+}
+
+
+Link_side *Link_side_table::first()
+{
+	for (; _first_hint < _capacity; _first_hint++) {
+		if (_slots[_first_hint]) {
+			return _slots[_first_hint]; }
+	}
+	return nullptr;
+}
+
+
+/****************
+ ** Link_wheel **
+ ****************/
+
+Link_wheel::Link_wheel(Timer::Connection &timer,
+                       Microseconds       rtt,
+                       Lock              &state_lock)
+:
+	_state_lock(state_lock),
+	_timeout(timer, *this, &Link_wheel::_handle_tick),
+	_tick_us(Microseconds(max(rtt.value / TICKS_PER_RTT, 1UL)))
+{ }
+
+
+void Link_wheel::_insert(Link &link)
+{
+	Link *&head = _slots[link._deadline % SLOTS];
+
+	link._wheel_prev = nullptr;
+	link._wheel_next = head;
+	if (head) {
+		head->_wheel_prev = &link; }
+
+	head = &link;
+}
+
+
+void Link_wheel::insert(Link &link)
+{
+	if (link._in_wheel) {
+		return; }
+
+	_insert(link);
+	link._in_wheel = true;
+	if (!_num++) {
+		_timeout.schedule(_tick_us); }
+}
+
+
+void Link_wheel::remove(Link &link)
+{
+	if (!link._in_wheel) {
+		return; }
+
+	if (link._wheel_next) {
+		link._wheel_next->_wheel_prev = link._wheel_prev; }
+
+	if (link._wheel_prev) {
+		link._wheel_prev->_wheel_next = link._wheel_next; }
+	else {
+		_slots[link._deadline % SLOTS] = link._wheel_next; }
+
+	link._in_wheel = false;
+	_num--;
+}
+
+
+void Link_wheel::_handle_tick(Duration)
+{
+	Lock_guard<Lock> guard(_state_lock);
+
+	_now++;
+
+	/* detach the links of the current slot */
+	Link *link = _slots[_now % SLOTS];
+	_slots[_now % SLOTS] = nullptr;
+
+	while (link) {
+		Link &curr = *link;
+		link = curr._wheel_next;
+
+		/* links that were renewed meanwhile move to their new slot */
+		if (curr._deadline > _now) {
+			_insert(curr);
+			continue;
+		}
+		curr._in_wheel = false;
+		_num--;
+		curr._expire();
+	}
+	if (_num) {
+		_timeout.schedule(_tick_us); }
 }
 
 
@@ -115,7 +288,7 @@ Link::Link(Interface                           &cln_interface,
            Pointer<Port_allocator_guard> const  srv_port_alloc,
            Interface                           &srv_interface,
            Link_side_id                  const &srv_id,
-           Timer::Connection                   &timer,
+           Link_wheel                          &wheel,
            Configuration                       &config,
            L3_protocol                   const  protocol)
 :
@@ -123,15 +296,15 @@ Link::Link(Interface                           &cln_interface,
 	_client(cln_interface, cln_id, *this),
 	_server_port_alloc(srv_port_alloc),
 	_server(srv_interface, srv_id, *this),
-	_close_timeout(timer, *this, &Link::_handle_close_timeout),
-	_close_timeout_us(_config.rtt()),
-	_protocol(protocol)
+	_wheel(wheel),
+	_protocol(protocol),
+	_deadline(_wheel.deadline())
 {
-	_close_timeout.schedule(_close_timeout_us);
+	_wheel.insert(*this);
 }
 
 
-void Link::_handle_close_timeout(Duration)
+void Link::_expire()
 {
 	dissolve();
 	_client._interface.link_closed(*this, _protocol);
@@ -140,6 +313,7 @@ void Link::_handle_close_timeout(Duration)
 
 void Link::dissolve()
 {
+	_wheel.remove(*this);
 	_client._interface.dissolve_link(_client, _protocol);
 	_server._interface.dissolve_link(_server, _protocol);
 	if (_config.verbose()) {
@@ -167,11 +341,11 @@ Tcp_link::Tcp_link(Interface                           &cln_interface,
                    Pointer<Port_allocator_guard> const  srv_port_alloc,
                    Interface                           &srv_interface,
                    Link_side_id                  const &srv_id,
-                   Timer::Connection                   &timer,
+                   Link_wheel                          &wheel,
                    Configuration                       &config,
                    L3_protocol                   const  protocol)
 :
-	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, timer,
+	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, wheel,
 	     config, protocol)
 { }
 
@@ -179,7 +353,7 @@ Tcp_link::Tcp_link(Interface                           &cln_interface,
 void Tcp_link::_fin_acked()
 {
 	if (_server_fin_acked && _client_fin_acked) {
-		_close_timeout.schedule(_close_timeout_us);
+		_packet();
 		_closed = true;
 	}
 }
@@ -228,10 +402,10 @@ Udp_link::Udp_link(Interface                           &cln_interface,
                    Pointer<Port_allocator_guard> const  srv_port_alloc,
                    Interface                           &srv_interface,
                    Link_side_id                  const &srv_id,
-                   Timer::Connection                   &timer,
+                   Link_wheel                          &wheel,
                    Configuration                       &config,
                    L3_protocol                   const  protocol)
 :
-	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, timer,
+	Link(cln_interface, cln_id, srv_port_alloc, srv_interface, srv_id, wheel,
 	     config, protocol)
 { }
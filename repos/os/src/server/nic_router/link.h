@@ -16,7 +16,7 @@
 
 /* Genode includes */
 #include <timer_session/connection.h>
-#include <util/avl_tree.h>
+#include <base/lock.h>
 #include <util/list.h>
 #include <net/ipv4.h>
 #include <net/port.h>
@@ -33,8 +33,9 @@ namespace Net {
 	class  Interface;
 	class  Link_side_id;
 	class  Link_side;
-	class  Link_side_tree;
+	class  Link_side_table;
 	class  Link;
+	class  Link_wheel;
 	struct Link_list : Genode::List<Link> { };
 	class  Tcp_link;
 	class  Udp_link;
@@ -52,27 +53,33 @@ struct Net::Link_side_id
 
 	void *data_base() const { return (void *)&src_ip; }
 
+	/**
+	 * Return hash value over the 4-tuple (the protocol is implied by the
+	 * table that holds the link side)
+	 */
+	Genode::uint32_t hash() const;
+
 
 	/************************
 	 ** Standard operators **
 	 ************************/
 
 	bool operator == (Link_side_id const &id) const;
-
-	bool operator > (Link_side_id const &id) const;
 }
 __attribute__((__packed__));
 
 
-class Net::Link_side : public Genode::Avl_node<Link_side>
+class Net::Link_side
 {
 	friend class Link;
+	friend class Link_side_table;
 
 	private:
 
-		Interface          &_interface;
-		Link_side_id const  _id;
-		Link               &_link;
+		Interface              &_interface;
+		Link_side_id     const  _id;
+		Genode::uint32_t const  _hash;
+		Link                   &_link;
 
 	public:
 
@@ -80,18 +87,9 @@ class Net::Link_side : public Genode::Avl_node<Link_side>
 		          Link_side_id const &id,
 		          Link               &link);
 
-		Link_side const &find_by_id(Link_side_id const &id) const;
-
 		bool is_client() const;
 
 
-		/**************
-		 ** Avl_node **
-		 **************/
-
-		bool higher(Link_side *side) { return side->_id > _id; }
-
-
 		/*********
 		 ** Log **
 		 *********/
@@ -112,29 +110,121 @@ class Net::Link_side : public Genode::Avl_node<Link_side>
 };
 
 
-struct Net::Link_side_tree : Genode::Avl_tree<Link_side>
+/**
+ * Open-addressing hash table of link sides keyed by their ID
+ *
+ * The table uses linear probing and removes entries by shifting subsequent
+ * entries of the same probe sequence backwards, so it needs no tombstones.
+ * It grows when half of its slots are in use.
+ */
+class Net::Link_side_table
 {
-	struct No_match : Genode::Exception { };
+	private:
+
+		enum { INITIAL_CAPACITY = 64 };
+
+		Genode::Allocator &_alloc;
+		Link_side        **_slots      = nullptr;
+		Genode::size_t     _capacity   = 0;
+		Genode::size_t     _used       = 0;
+		Genode::size_t     _first_hint = 0;
+
+		Genode::size_t _slot(Genode::uint32_t hash) const {
+			return hash & (_capacity - 1); }
+
+		Genode::size_t _next(Genode::size_t slot) const {
+			return (slot + 1) & (_capacity - 1); }
+
+		void _insert(Link_side &side);
+
+		void _grow();
+
+	public:
+
+		struct No_match : Genode::Exception { };
+
+		Link_side_table(Genode::Allocator &alloc) : _alloc(alloc) { }
+
+		~Link_side_table();
+
+		Link_side const &find_by_id(Link_side_id const &id) const;
 
-	Link_side const &find_by_id(Link_side_id const &id) const;
+		void insert(Link_side &side);
+
+		void remove(Link_side &side);
+
+		/**
+		 * Return any link side of the table or nullptr if it is empty
+		 */
+		Link_side *first();
+};
+
+
+/**
+ * Expiry of links at the granularity of a fraction of the round-trip time
+ *
+ * A packet merely renews the deadline of its link. The link stays in the
+ * slot of its former deadline. When the wheel reaches this slot, it moves
+ * the link to the slot of the renewed deadline or, if the deadline passed,
+ * closes the link. Hence, the work per packet is constant and the wheel
+ * needs a timeout only while it contains links.
+ */
+class Net::Link_wheel
+{
+	private:
+
+		enum { SLOTS = 32, TICKS_PER_RTT = 16 };
+
+		Genode::Lock                       &_state_lock;
+		Timer::One_shot_timeout<Link_wheel> _timeout;
+		Genode::Microseconds const          _tick_us;
+		unsigned long                       _now   = 0;
+		unsigned long                       _num   = 0;
+		Link                               *_slots[SLOTS] { };
+
+		void _insert(Link &link);
+
+		void _handle_tick(Genode::Duration);
+
+	public:
+
+		Link_wheel(Timer::Connection    &timer,
+		           Genode::Microseconds  rtt,
+		           Genode::Lock         &state_lock);
+
+		/**
+		 * Return the deadline of a link that is renewed now
+		 */
+		unsigned long deadline() const { return _now + TICKS_PER_RTT; }
+
+		void insert(Link &link);
+
+		void remove(Link &link);
 };
 
 
 class Net::Link : public Link_list::Element
 {
+	friend class Link_wheel;
+
 	protected:
 
 		Configuration                       &_config;
 		Link_side                            _client;
 		Pointer<Port_allocator_guard> const  _server_port_alloc;
 		Link_side                            _server;
-		Timer::One_shot_timeout<Link>        _close_timeout;
-		Genode::Microseconds          const  _close_timeout_us;
+		Link_wheel                          &_wheel;
 		L3_protocol                   const  _protocol;
 
-		void _handle_close_timeout(Genode::Duration);
+		/* state maintained by the link wheel */
+		unsigned long  _deadline;
+		bool           _in_wheel   = false;
+		Link          *_wheel_prev = nullptr;
+		Link          *_wheel_next = nullptr;
 
-		void _packet() { _close_timeout.schedule(_close_timeout_us); }
+		void _expire();
+
+		void _packet() { _deadline = _wheel.deadline(); }
 
 	public:
 
@@ -145,12 +235,14 @@ class Net::Link : public Link_list::Element
 		     Pointer<Port_allocator_guard> const  srv_port_alloc,
 		     Interface                           &srv_interface,
 		     Link_side_id                  const &srv_id,
-		     Timer::Connection                   &timer,
+		     Link_wheel                          &wheel,
 		     Configuration                       &config,
 		     L3_protocol                   const  protocol);
 
 		void dissolve();
 
+		L3_protocol protocol() const { return _protocol; }
+
 
 		/*********
 		 ** Log **
@@ -187,7 +279,7 @@ class Net::Tcp_link : public Link
 		         Pointer<Port_allocator_guard> const  srv_port_alloc,
 		         Interface                           &srv_interface,
 		         Link_side_id                  const &srv_id,
-		         Timer::Connection                   &timer,
+		         Link_wheel                          &wheel,
 		         Configuration                       &config,
 		         L3_protocol                   const  protocol);
 
@@ -204,7 +296,7 @@ struct Net::Udp_link : Link
 	         Pointer<Port_allocator_guard> const  srv_port_alloc,
 	         Interface                           &srv_interface,
 	         Link_side_id                  const &srv_id,
-	         Timer::Connection                   &timer,
+	         Link_wheel                          &wheel,
 	         Configuration                       &config,
 	         L3_protocol                   const  protocol);
 
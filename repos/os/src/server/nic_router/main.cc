@@ -48,8 +48,7 @@ Main::Main(Env &env)
 :
 	_timer(env), _heap(&env.ram(), &env.rm()), _config_rom(env, "config"),
 	_config(_config_rom.xml(), _heap), _uplink(env, _timer, _heap, _config),
-	_root(env.ep(), _timer, _heap, _uplink.router_mac(), _config,
-	      env.ram(), env.rm())
+	_root(env, _timer, _heap, _uplink.router_mac(), _config)
 {
 	env.parent().announce(env.ep().manage(_root));
 }
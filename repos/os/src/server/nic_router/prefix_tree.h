@@ -0,0 +1,162 @@
+/*
+ * \brief  Path-compressed binary trie for longest-prefix matching
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _PREFIX_TREE_H_
+#define _PREFIX_TREE_H_
+
+/* Genode includes */
+#include <net/ipv4.h>
+
+namespace Net { template <typename> class Prefix_tree; }
+
+
+/**
+ * Path-compressed binary trie over IPv4 address prefixes
+ *
+ * Each inner node stores the complete prefix it represents, so a lookup
+ * descends at most one node per distinct prefix length on the path instead
+ * of one node per address bit. Objects that are inserted into the tree
+ * must inherit from 'Prefix_tree::Element', which provides the memory for
+ * the node of the object and for at most one branching node that the
+ * insertion may create. Hence, the tree does not need an allocator. The tree
+ * does not support removal as it is built once per configuration.
+ */
+template <typename T>
+class Net::Prefix_tree
+{
+	public:
+
+		class Node
+		{
+			friend class Prefix_tree;
+
+			private:
+
+				T const         *_object = nullptr;
+				Genode::uint32_t _key    = 0;
+				unsigned         _len    = 0;
+				Node            *_child[2] { nullptr, nullptr };
+		};
+
+		struct Element
+		{
+			Node _prefix_tree_node { };
+			Node _prefix_tree_glue { };
+		};
+
+	private:
+
+		Node *_root = nullptr;
+
+		static Genode::uint32_t _mask(Genode::uint32_t value, unsigned len) {
+			return len ? value & ~((1ULL << (32 - len)) - 1) : 0; }
+
+		static unsigned _bit(Genode::uint32_t value, unsigned idx) {
+			return (value >> (31 - idx)) & 1; }
+
+		static unsigned _common_len(Genode::uint32_t a, Genode::uint32_t b,
+		                            unsigned max)
+		{
+			Genode::uint32_t const diff = a ^ b;
+			unsigned const len = diff ? __builtin_clz(diff) : 32;
+			return len < max ? len : max;
+		}
+
+		static Genode::uint32_t _value(Ipv4_address const &ip) {
+			return ip.to_uint32_little_endian(); }
+
+	public:
+
+		/**
+		 * Insert object for the given prefix
+		 *
+		 * If an object with the same prefix exists already, the new object
+		 * shadows it.
+		 */
+		void insert(Ipv4_address_prefix const &prefix, T &object)
+		{
+			Element          &elem = object;
+			Node             &node = elem._prefix_tree_node;
+			unsigned   const  len  = prefix.prefix;
+			Genode::uint32_t  key  = _mask(_value(prefix.address), len);
+
+			node._object = &object;
+			node._key    = key;
+			node._len    = len;
+
+			Node **link = &_root;
+			while (Node *curr = *link) {
+
+				unsigned const common =
+					_common_len(curr->_key, key, len < curr->_len ? len : curr->_len);
+
+				/* the prefix of 'curr' is a prefix of the new one */
+				if (common == curr->_len) {
+
+					if (curr->_len == len) {
+
+						/* take the place of the existing node */
+						node._child[0] = curr->_child[0];
+						node._child[1] = curr->_child[1];
+						*link = &node;
+						return;
+					}
+					link = &curr->_child[_bit(key, curr->_len)];
+					continue;
+				}
+				/* the new prefix is a prefix of the one of 'curr' */
+				if (common == len) {
+					node._child[_bit(curr->_key, len)] = curr;
+					*link = &node;
+					return;
+				}
+				/* both prefixes diverge, insert branching node */
+				Node &glue = elem._prefix_tree_glue;
+				glue._key  = _mask(key, common);
+				glue._len  = common;
+				glue._child[_bit(key,        common)] = &node;
+				glue._child[_bit(curr->_key, common)] = curr;
+				*link = &glue;
+				return;
+			}
+			*link = &node;
+		}
+
+		/**
+		 * Return object with the longest prefix that matches 'ip'
+		 *
+		 * \return  nullptr if no prefix matches
+		 */
+		T const *longest_prefix_match(Ipv4_address const &ip) const
+		{
+			Genode::uint32_t const value = _value(ip);
+
+			T const *match = nullptr;
+			for (Node const *curr = _root; curr; ) {
+
+				if (_mask(value, curr->_len) != curr->_key)
+					break;
+
+				if (curr->_object)
+					match = curr->_object;
+
+				if (curr->_len == 32)
+					break;
+
+				curr = curr->_child[_bit(value, curr->_len)];
+			}
+			return match;
+		}
+};
+
+#endif /* _PREFIX_TREE_H_ */
@@ -33,8 +33,8 @@ Net::Uplink::Uplink(Env               &env,
 	Interface(env.ep(), timer, mac_address(), alloc, Mac_address(),
 	          config.domains().find_by_name(Cstring("uplink")))
 {
-	rx_channel()->sigh_ready_to_ack(_sink_ack);
-	rx_channel()->sigh_packet_avail(_sink_submit);
-	tx_channel()->sigh_ack_avail(_source_ack);
-	tx_channel()->sigh_ready_to_submit(_source_submit);
+	rx_channel()->sigh_ready_to_ack(*_sink_ack);
+	rx_channel()->sigh_packet_avail(*_sink_submit);
+	tx_channel()->sigh_ack_avail(*_source_ack);
+	tx_channel()->sigh_ready_to_submit(*_source_submit);
 }
@@ -51,6 +51,8 @@ class Net::Uplink : public Nic::Packet_allocator,
 		       Genode::Allocator  &alloc,
 		       Configuration      &config);
 
+		~Uplink() { _dissolve(); }
+
 
 		/***************
 		 ** Accessors **
@@ -75,24 +75,58 @@ class Block::Session_component : public Block::Session_rpc_object,
 			_p_to_handle = packet;
 			_p_to_handle.succeeded(false);
 
+			Packet_descriptor::Opcode const op = _p_to_handle.operation();
+
+			bool const flush   = op == Packet_descriptor::FLUSH;
+			bool const discard = op == Packet_descriptor::DISCARD;
+
+			sector_t const nr  = _p_to_handle.block_number();
+			size_t         cnt = _p_to_handle.block_count();
+
+			/*
+			 * Blocks to discard beyond the end of the partition are ignored
+			 * instead of rejecting the whole request.
+			 */
+			if (discard && nr < _partition->sectors)
+				cnt = min(cnt, (size_t)(_partition->sectors - nr));
+
 			/* ignore invalid packets */
-			if (!packet.size() || !_range_check(_p_to_handle)) {
+			bool const in_range = flush   ? true
+			                    : discard ? nr < _partition->sectors
+			                    :           _range_check(_p_to_handle);
+			if ((_p_to_handle.payload() && !packet.size()) || !in_range) {
 				_ack_packet(_p_to_handle);
 				return;
 			}
 
-			bool write   = _p_to_handle.operation() == Packet_descriptor::WRITE;
-			sector_t off = _p_to_handle.block_number() + _partition->lba;
-			size_t cnt   = _p_to_handle.block_count();
-			void* addr   = tx_sink()->packet_content(_p_to_handle);
+			if (_p_to_handle.modifies() && !_writeable) {
+				_ack_packet(_p_to_handle);
+				return;
+			}
 
-			if (write && !_writeable) {
+			/* the partition's block range is irrelevant for a flush */
+			sector_t off = flush ? 0 : nr + _partition->lba;
+			void* addr   = _p_to_handle.payload()
+			             ? tx_sink()->packet_content(_p_to_handle) : nullptr;
+
+			/*
+			 * The backend supports flushes if it uses the generic block
+			 * component. Otherwise, fall back to the synchronous sync RPC.
+			 */
+			if (flush && !_driver.ops().supported(op)) {
+				_driver.session().sync();
+				_p_to_handle.succeeded(true);
+				_ack_packet(_p_to_handle);
+				return;
+			}
+
+			if (!_driver.ops().supported(op)) {
 				_ack_packet(_p_to_handle);
 				return;
 			}
 
 			try {
-				_driver.io(write, off, cnt, addr, *this, _p_to_handle);
+				_driver.io(op, off, cnt, addr, *this, _p_to_handle);
 			} catch (Block::Session::Tx::Source::Packet_alloc_failed) {
 				if (!_req_queue_full) {
 					_req_queue_full = true;
@@ -214,6 +248,13 @@ class Block::Session_component : public Block::Session_rpc_object,
 				ops->set_operation(Opcode::READ);
 			if (_writeable && driver_ops.supported(Opcode::WRITE))
 				ops->set_operation(Opcode::WRITE);
+			if (_writeable && driver_ops.supported(Opcode::DISCARD))
+				ops->set_operation(Opcode::DISCARD);
+			if (_writeable && driver_ops.supported(Opcode::WRITE_ZEROES))
+				ops->set_operation(Opcode::WRITE_ZEROES);
+
+			/* emulated via the sync RPC if not supported by the backend */
+			ops->set_operation(Opcode::FLUSH);
 		}
 
 		void sync() { _driver.session().sync(); }
@@ -134,22 +134,21 @@ class Block::Driver
 
 		static Driver& driver();
 
-		void io(bool write, sector_t nr, Genode::size_t cnt, void* addr,
-		        Block_dispatcher &dispatcher, Packet_descriptor& cli)
+		void io(Packet_descriptor::Opcode op, sector_t nr, Genode::size_t cnt,
+		        void* addr, Block_dispatcher &dispatcher, Packet_descriptor& cli)
 		{
 			if (!_session.tx()->ready_to_submit())
 				throw Block::Session::Tx::Source::Packet_alloc_failed();
 
-			Block::Packet_descriptor::Opcode op = write
-			    ? Block::Packet_descriptor::WRITE
-			    : Block::Packet_descriptor::READ;
+			/* operations without payload occupy no space in the bulk buffer */
 			Genode::size_t size = _blk_size * cnt;
-			Packet_descriptor p(_session.dma_alloc_packet(size),
-			                    op,  nr, cnt);
+			Packet_descriptor p(cli.payload()
+			                    ? _session.dma_alloc_packet(size)
+			                    : Packet_descriptor(), op, nr, cnt);
 			Request *r = new (&_r_slab) Request(dispatcher, cli, p);
 			_r_list.insert(r);
 
-			if (write)
+			if (op == Packet_descriptor::WRITE)
 				Genode::memcpy(_session.tx()->packet_content(p),
 				               addr, size);
 
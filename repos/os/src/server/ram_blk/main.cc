@@ -32,73 +32,142 @@ class Ram_blk : public Block::Driver
 	private:
 
 		Env       &_env;
-		Allocator *_alloc { nullptr };
-
-		Attached_rom_dataspace *_rom_ds { nullptr };
-		size_t                  _size;
-		size_t                  _block_size;
-		size_t                  _block_count;
-		Attached_ram_dataspace  _ram_ds;
-		addr_t                  _ram_addr;
-
-		void _io(Block::sector_t           block_number,
-		         size_t                    block_count,
-		         char*                     buffer,
-		         Block::Packet_descriptor &packet,
-		         bool                      read)
+		Allocator &_alloc;
+
+		size_t const _size;
+		size_t const _block_size;
+		size_t const _block_count;
+
+		/*
+		 * The backing store consists of chunks of RAM. A sparse device
+		 * allocates chunks on the first write and releases them when they
+		 * get discarded or zeroed as a whole. Blocks of absent chunks read
+		 * as zero. Otherwise, the device is backed by a single chunk that
+		 * is allocated up front.
+		 */
+		bool   const _sparse;
+		size_t const _chunk_size;
+		size_t const _num_chunks;
+
+		Attached_ram_dataspace **_chunks;
+
+		size_t _chunk_bytes(size_t index) const {
+			return min(_chunk_size, _size - index*_chunk_size); }
+
+		char *_chunk(size_t index) const
+		{
+			return _chunks[index] ? _chunks[index]->local_addr<char>()
+			                      : nullptr;
+		}
+
+		char *_populated_chunk(size_t index)
+		{
+			if (!_chunks[index])
+				_chunks[index] = new (_alloc)
+					Attached_ram_dataspace(_env.ram(), _env.rm(),
+					                       _chunk_bytes(index));
+			return _chunk(index);
+		}
+
+		void _release_chunk(size_t index)
+		{
+			if (!_chunks[index])
+				return;
+
+			destroy(_alloc, _chunks[index]);
+			_chunks[index] = nullptr;
+		}
+
+		/**
+		 * Call 'fn' for each chunk within the specified blocks
+		 *
+		 * The functor is called with the chunk index, the offset within the
+		 * chunk, and the number of bytes within the chunk.
+		 */
+		template <typename FN>
+		bool _for_each_chunk(Block::sector_t block_number,
+		                     size_t block_count, FN const &fn)
 		{
 			/* sanity check block number */
 			if (block_number + block_count > _block_count) {
 				Genode::warning("requested blocks ", block_number, "-",
 				                block_number + block_count," out of range!");
-				return;
+				return false;
 			}
 
 			size_t offset = (size_t) block_number * _block_size;
 			size_t size   = block_count  * _block_size;
 
-			void *src = read ? (void *)(_ram_addr + offset) : (void *)buffer;
-			void *dst = read ? (void *)buffer : (void *)(_ram_addr + offset);
-			/* copy file content to packet payload */
-			memcpy(dst, src, size);
+			while (size) {
+				size_t const index        = offset / _chunk_size;
+				size_t const chunk_offset = offset % _chunk_size;
+				size_t const length       = min(size, _chunk_bytes(index)
+				                                      - chunk_offset);
+				fn(index, chunk_offset, length);
 
-			ack_packet(packet);
+				offset += length;
+				size   -= length;
+			}
+			return true;
 		}
 
+		bool _full_chunk(size_t index, size_t offset, size_t length) const {
+			return offset == 0 && length == _chunk_bytes(index); }
+
 	public:
 
 		/**
-		 * Construct populated RAM dataspace
+		 * Constructor
+		 *
+		 * \param size        size of the device in bytes
+		 * \param chunk_size  granularity of the backing store of a sparse
+		 *                    device, or 0 for a non-sparse device
 		 */
-		Ram_blk(Env &env, Allocator &alloc,
-		        const char *name, size_t block_size)
+		Ram_blk(Env &env, Allocator &alloc, size_t size, size_t block_size,
+		        size_t chunk_size)
 		:	Block::Driver(env.ram()),
-			_env(env), _alloc(&alloc),
-			_rom_ds(new (_alloc) Attached_rom_dataspace(_env, name)),
-			_size(_rom_ds->size()),
+			_env(env), _alloc(alloc),
+			_size(size),
 			_block_size(block_size),
 			_block_count(_size/_block_size),
-			_ram_ds(_env.ram(), _env.rm(), _size),
-			_ram_addr((addr_t)_ram_ds.local_addr<addr_t>())
+			_sparse(chunk_size != 0),
+			_chunk_size(_sparse ? align_addr(max(chunk_size, block_size), 12)
+			                    : _size),
+			_num_chunks((_size + _chunk_size - 1) / _chunk_size),
+			_chunks((Attached_ram_dataspace **)
+			        alloc.alloc(_num_chunks*sizeof(Attached_ram_dataspace *)))
 		{
-			/* populate backing store from file */
-			memcpy(_ram_ds.local_addr<void>(), _rom_ds->local_addr<void>(), _size);
+			for (size_t i = 0; i < _num_chunks; i++)
+				_chunks[i] = nullptr;
+
+			if (!_sparse)
+				_populated_chunk(0);
 		}
 
 		/**
-		 * Construct empty RAM dataspace
+		 * Construct device populated from ROM module
 		 */
-		Ram_blk(Env &env, size_t size, size_t block_size)
-		:	Block::Driver(env.ram()),
-			_env(env),
-			_size(size),
-			_block_size(block_size),
-			_block_count(_size/_block_size),
-			_ram_ds(_env.ram(), _env.rm(), _size),
-			_ram_addr((addr_t)_ram_ds.local_addr<addr_t>())
-		{ }
+		Ram_blk(Env &env, Allocator &alloc, const char *name,
+		        size_t block_size, size_t chunk_size)
+		:	Ram_blk(env, alloc, Attached_rom_dataspace(env, name).size(),
+			        block_size, chunk_size)
+		{
+			Attached_rom_dataspace rom(_env, name);
+
+			/* populate backing store from file */
+			for (size_t i = 0; i < _num_chunks; i++)
+				memcpy(_populated_chunk(i),
+				       rom.local_addr<char>() + i*_chunk_size,
+				       _chunk_bytes(i));
+		}
+
+		~Ram_blk()
+		{
+			for (size_t i = 0; i < _num_chunks; i++)
+				_release_chunk(i);
 
-		~Ram_blk() { destroy(_alloc, _rom_ds); }
+			_alloc.free(_chunks, _num_chunks*sizeof(Attached_ram_dataspace *));
+		}
 
 
 		/****************************
@@ -113,6 +182,8 @@ class Ram_blk : public Block::Driver
 			Block::Session::Operations o;
 			o.set_operation(Block::Packet_descriptor::READ);
 			o.set_operation(Block::Packet_descriptor::WRITE);
+			o.set_operation(Block::Packet_descriptor::DISCARD);
+			o.set_operation(Block::Packet_descriptor::WRITE_ZEROES);
 			return o;
 		}
 
@@ -121,7 +192,18 @@ class Ram_blk : public Block::Driver
 		          char*              buffer,
 		          Block::Packet_descriptor &packet)
 		{
-			_io(block_number, block_count, buffer, packet, true);
+			auto read_fn = [&] (size_t index, size_t offset, size_t length)
+			{
+				if (char const *chunk = _chunk(index))
+					memcpy(buffer, chunk + offset, length);
+				else
+					memset(buffer, 0, length);
+
+				buffer += length;
+			};
+
+			if (_for_each_chunk(block_number, block_count, read_fn))
+				ack_packet(packet);
 		}
 
 		void write(Block::sector_t  block_number,
@@ -129,7 +211,52 @@ class Ram_blk : public Block::Driver
 		           const char *     buffer,
 		           Block::Packet_descriptor &packet)
 		{
-			_io(block_number, block_count, const_cast<char *>(buffer), packet, false);
+			bool success = true;
+
+			auto write_fn = [&] (size_t index, size_t offset, size_t length)
+			{
+				try {
+					memcpy(_populated_chunk(index) + offset, buffer, length);
+				}
+				catch (Out_of_ram)  { success = false; }
+				catch (Out_of_caps) { success = false; }
+
+				buffer += length;
+			};
+
+			if (_for_each_chunk(block_number, block_count, write_fn))
+				ack_packet(packet, success);
+		}
+
+		void discard(Block::sector_t           block_number,
+		             size_t                    block_count,
+		             Block::Packet_descriptor &packet)
+		{
+			/* the content of partially discarded chunks is retained */
+			auto discard_fn = [&] (size_t index, size_t offset, size_t length)
+			{
+				if (_sparse && _full_chunk(index, offset, length))
+					_release_chunk(index);
+			};
+
+			if (_for_each_chunk(block_number, block_count, discard_fn))
+				ack_packet(packet);
+		}
+
+		void write_zeroes(Block::sector_t           block_number,
+		                  size_t                    block_count,
+		                  Block::Packet_descriptor &packet)
+		{
+			auto zero_fn = [&] (size_t index, size_t offset, size_t length)
+			{
+				if (_sparse && _full_chunk(index, offset, length))
+					_release_chunk(index);
+				else if (char *chunk = _chunk(index))
+					memset(chunk + offset, 0, length);
+			};
+
+			if (_for_each_chunk(block_number, block_count, zero_fn))
+				ack_packet(packet);
 		}
 };
 
@@ -151,6 +278,7 @@ struct Main
 
 		size_t       size { 0 };
 		size_t block_size { 512 };
+		size_t chunk_size { 0 };
 
 		Factory(Env &env, Allocator &alloc,
 		        Xml_node config)
@@ -172,6 +300,10 @@ struct Main
 			}
 
 			block_size = config.attribute_value("block_size", block_size);
+
+			if (config.attribute_value("sparse", false))
+				chunk_size = config.attribute_value("chunk_size",
+				                                    Number_of_bytes(1024*1024));
 		}
 
 		Block::Driver *create()
@@ -180,11 +312,13 @@ struct Main
 				if (use_file) {
 					Genode::log("Creating RAM-basd block device populated by file='",
 					            Genode::Cstring(file), "' with block size ", block_size);
-					return new (&alloc) Ram_blk(env, alloc, file, block_size);
+					return new (&alloc) Ram_blk(env, alloc, file, block_size,
+					                            chunk_size);
 				} else {
 					Genode::log("Creating RAM-based block device with size ",
 					            size, " and block size ", block_size);
-					return new (&alloc) Ram_blk(env, size, block_size);
+					return new (&alloc) Ram_blk(env, alloc, size, block_size,
+					                            chunk_size);
 				}
 			}
 			catch (...) { throw Service_denied(); }
@@ -29,28 +29,24 @@ class Ram_fs::Directory : public Node
 {
 	private:
 
-		List<Node> _entries;
-		size_t     _num_entries;
+		typedef File_system::Directory_index<Node> Entries;
 
-		Node *_entry_unsynchronized(size_t index)
-		{
-			Node *node = _entries.first();
-			for (unsigned i = 0; i < index && node; node = node->next(), i++);
-			return node;
-		}
+		/* list the most recently created entries first */
+		Entries _entries;
 
-	public:
+		Node *_entry_unsynchronized(size_t index) { return _entries.entry(index); }
 
-		Directory(char const *name) : _num_entries(0) { Node::name(name); }
+	public:
 
-		bool has_sub_node_unsynchronized(char const *name) const override
+		Directory(Allocator &alloc, char const *name)
+		: _entries(alloc, Entries::Order::NEWEST_FIRST)
 		{
-			Node const *sub_node = _entries.first();
-			for (; sub_node; sub_node = sub_node->next())
-				if (strcmp(sub_node->name(), name) == 0)
-					return true;
+			Node::name(name);
+		}
 
-			return false;
+		bool has_sub_node_unsynchronized(char const *name) override
+		{
+			return _entries.lookup(name) != nullptr;
 		}
 
 		void adopt_unsynchronized(Node *node) override
@@ -58,16 +54,14 @@ class Ram_fs::Directory : public Node
 			/*
 			 * XXX inc ref counter
 			 */
-			_entries.insert(node);
-			_num_entries++;
+			_entries.insert(*node);
 
 			mark_as_updated();
 		}
 
 		void discard(Node *node) override
 		{
-			_entries.remove(node);
-			_num_entries--;
+			_entries.remove(*node);
 
 			mark_as_updated();
 		}
@@ -100,11 +94,7 @@ class Ram_fs::Directory : public Node
 			 */
 
 			/* try to find entry that matches the first path element */
-			Node *sub_node = _entries.first();
-			for (; sub_node; sub_node = sub_node->next())
-				if ((strlen(sub_node->name()) == i) &&
-					(strcmp(sub_node->name(), path, i) == 0))
-					break;
+			Node *sub_node = _entries.lookup(path, i);
 
 			if (!sub_node)
 				throw File_system::Lookup_failed();
@@ -195,23 +185,24 @@ class Ram_fs::Directory : public Node
 				return 0;
 			}
 
-			Node *node = _entry_unsynchronized(index);
-
-			/* index out of range */
-			if (!node)
-				return 0;
+			/* fill the buffer with as many entries as fit */
+			Directory_entry *e   = (Directory_entry *)(dst);
+			size_t           cnt = 0;
 
-			Directory_entry *e = (Directory_entry *)(dst);
+			for (Node *node = _entry_unsynchronized(index);
+			     node && (cnt + 1)*sizeof(Directory_entry) <= len;
+			     node = _entries.next(*node), e++, cnt++) {
 
-			e->inode = node->inode();
+				e->inode = node->inode();
 
-			if (dynamic_cast<File      *>(node)) e->type = Directory_entry::TYPE_FILE;
-			if (dynamic_cast<Directory *>(node)) e->type = Directory_entry::TYPE_DIRECTORY;
-			if (dynamic_cast<Symlink   *>(node)) e->type = Directory_entry::TYPE_SYMLINK;
+				if (dynamic_cast<File      *>(node)) e->type = Directory_entry::TYPE_FILE;
+				if (dynamic_cast<Directory *>(node)) e->type = Directory_entry::TYPE_DIRECTORY;
+				if (dynamic_cast<Symlink   *>(node)) e->type = Directory_entry::TYPE_SYMLINK;
 
-			strncpy(e->name, node->name(), sizeof(e->name));
+				strncpy(e->name, node->name(), sizeof(e->name));
+			}
 
-			return sizeof(Directory_entry);
+			return cnt*sizeof(Directory_entry);
 		}
 
 		size_t write(char const *src, size_t len, seek_off_t seek_offset) override
@@ -224,7 +215,7 @@ class Ram_fs::Directory : public Node
 		{
 			Status s;
 			s.inode = inode();
-			s.size = _num_entries * sizeof(File_system::Directory_entry);
+			s.size = _entries.count() * sizeof(File_system::Directory_entry);
 			s.mode = File_system::Status::MODE_DIRECTORY;
 			return s;
 		}
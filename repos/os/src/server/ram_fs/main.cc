@@ -316,7 +316,7 @@ class Ram_fs::Session_component : public File_system::Session_rpc_object
 					throw Node_already_exists();
 
 				try {
-					parent->adopt_unsynchronized(new (_alloc) Directory(name));
+					parent->adopt_unsynchronized(new (_alloc) Directory(_alloc, name));
 				} catch (Allocator::Out_of_memory) {
 					throw No_space();
 				}
@@ -434,14 +434,15 @@ class Ram_fs::Session_component : public File_system::Session_rpc_object
 					Node &from_dir = open_from_dir_node.node();
 
 					Node *node = from_dir.lookup(from_name.string());
-					node->name(to_name.string());
 
 					Node &to_dir = open_to_dir_node.node();
 
-					if (&to_dir != &from_dir) {
+					/* the name of an entry must not change within the index */
+					from_dir.discard(node);
+					node->name(to_name.string());
+					to_dir.adopt_unsynchronized(node);
 
-						from_dir.discard(node);
-						to_dir.adopt_unsynchronized(node);
+					if (&to_dir != &from_dir) {
 
 						/*
 						 * If the file was moved from one directory to another we
@@ -661,7 +662,7 @@ static void preload_content(Genode::Env            &env,
 		 */
 		if (sub_node.has_type("dir")) {
 
-			Ram_fs::Directory *sub_dir = new (&alloc) Ram_fs::Directory(name);
+			Ram_fs::Directory *sub_dir = new (&alloc) Ram_fs::Directory(alloc, name);
 
 			/* traverse into the new directory */
 			preload_content(env, alloc, sub_node, *sub_dir);
@@ -708,8 +709,6 @@ struct Ram_fs::Main
 {
 	Genode::Env &_env;
 
-	Directory _root_dir { "" };
-
 	Genode::Attached_rom_dataspace _config { _env, "config" };
 
 	/*
@@ -719,6 +718,8 @@ struct Ram_fs::Main
 
 	Genode::Heap _heap { _env.ram(), _env.rm() };
 
+	Directory _root_dir { _heap, "" };
+
 	Root _fs_root { _env.ep(), _env.ram(), _env.rm(), _config.xml(),
 	                _sliced_heap, _heap, _root_dir };
 
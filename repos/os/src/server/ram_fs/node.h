@@ -17,7 +17,7 @@
 /* Genode includes */
 #include <file_system/listener.h>
 #include <file_system/node.h>
-#include <util/list.h>
+#include <ram_fs/directory_index.h>
 
 namespace Ram_fs {
 	using namespace Genode;
@@ -29,7 +29,8 @@ namespace Ram_fs {
 }
 
 
-class Ram_fs::Node : public File_system::Node_base, public List<Node>::Element
+class Ram_fs::Node : public File_system::Node_base,
+                     public File_system::Directory_index<Node>::Element
 {
 	public:
 
@@ -80,7 +81,7 @@ class Ram_fs::Node : public File_system::Node_base, public List<Node>::Element
 
 		/* Directory functionality  */
 
-		virtual bool has_sub_node_unsynchronized(char const *name) const
+		virtual bool has_sub_node_unsynchronized(char const *name)
 		{
 			Genode::error(__PRETTY_FUNCTION__, " called on a non-directory node");
 			return false;
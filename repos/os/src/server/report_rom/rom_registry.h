@@ -16,6 +16,7 @@
 
 /* Genode includes */
 #include <report_rom/rom_registry.h>
+#include <report_rom/rom_service.h>
 #include <os/session_policy.h>
 
 namespace Rom { struct Registry; }
@@ -34,6 +35,11 @@ struct Rom::Registry : Registry_for_reader, Registry_for_writer, Genode::Noncopy
 
 		struct Read_write_policy : Module::Read_policy, Module::Write_policy
 		{
+			Genode::Attached_rom_dataspace &_config_rom;
+
+			Read_write_policy(Genode::Attached_rom_dataspace &config_rom)
+			: _config_rom(config_rom) { }
+
 			bool read_permitted(Module const &,
 			                    Writer const &,
 			                    Reader const &) const override
@@ -47,6 +53,35 @@ struct Rom::Registry : Registry_for_reader, Registry_for_writer, Genode::Noncopy
 				return true;
 			}
 
+			bool content_shared(Module const &, Reader const &reader) const override
+			{
+				/*
+				 * Readers share the content only if explicitly permitted
+				 * by their policy because each sharing reader is able to
+				 * modify the content seen by the other sharing readers.
+				 */
+				using namespace Genode;
+
+				Session_label const label =
+					static_cast<Session_component const &>(reader).label();
+
+				try {
+					Session_policy policy(label, _config_rom.xml());
+					return policy.attribute_value("shared", false);
+				}
+				catch (Session_policy::No_policy_defined) { }
+
+				/* FIXME backwards compatibility, remove at next release */
+				try {
+					Session_policy policy(label, _config_rom.xml().sub_node("rom"));
+					return policy.attribute_value("shared", false);
+				}
+				catch (Xml_node::Nonexistent_sub_node) { /* no <rom> node */ }
+				catch (Session_policy::No_policy_defined) { }
+
+				return false;
+			}
+
 			bool write_permitted(Module const &, Writer const &) const override
 			{
 				/*
@@ -58,7 +93,7 @@ struct Rom::Registry : Registry_for_reader, Registry_for_writer, Genode::Noncopy
 				return true;
 			}
 
-		} _read_write_policy;
+		} _read_write_policy { _config_rom };
 
 		Module &_lookup(Module::Name const name)
 		{
@@ -72,7 +107,7 @@ struct Rom::Registry : Registry_for_reader, Registry_for_writer, Genode::Noncopy
 			/* XXX if we run out of memory, the server will abort */
 
 			Module * const module = new (&_md_alloc)
-				Module(_ram, _rm, name, _read_write_policy, _read_write_policy);
+				Module(_ram, _rm, _md_alloc, name, _read_write_policy, _read_write_policy);
 
 			_modules.insert(module);
 			return *module;
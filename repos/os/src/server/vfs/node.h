@@ -433,10 +433,23 @@ struct Vfs_server::Directory : Node
 
 		size_t remains = len;
 
-		while (remains >= blocksize) {
+		/* fill the packet with as many entries as fit */
+		for (; remains >= blocksize; index++) {
 
-			if ((_read((char*)&vfs_dirent, sizeof(vfs_dirent),
-			          index * sizeof(vfs_dirent)) < sizeof(vfs_dirent)) ||
+			size_t res = 0;
+			try {
+				res = _read((char*)&vfs_dirent, sizeof(vfs_dirent),
+				            index * sizeof(vfs_dirent));
+			} catch (Operation_incomplete) {
+
+				/* deliver the entries obtained so far */
+				if (remains < len)
+					return len - remains;
+
+				throw;
+			}
+
+			if ((res < sizeof(vfs_dirent)) ||
 			    (vfs_dirent.type == Vfs::Directory_service::DIRENT_TYPE_END))
 				return len - remains;
 
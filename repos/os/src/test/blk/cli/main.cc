@@ -374,6 +374,82 @@ struct Violation_test : Test
 };
 
 
+struct Zero_test : Test
+{
+	struct Not_zero : Block_exception
+	{
+		Not_zero(Block::sector_t nr, Genode::size_t cnt)
+		: Block_exception(nr, cnt, false) {}
+
+		void print_error()
+		{
+			Genode::error("block ", _nr, " - ", _nr+_cnt, " not zeroed");
+		}
+	};
+
+	enum { BLOCKS = 16 };
+
+	int p_in_fly;
+
+	Zero_test(Genode::Env &env, Genode::Heap &heap, unsigned timeo)
+	: Test(env, heap, BLOCKS*blk_sz, timeo), p_in_fly(0) {}
+
+	void submit(Block::Packet_descriptor::Opcode op, Block::sector_t nr,
+	            Genode::size_t cnt)
+	{
+		/* only reads need space in the bulk buffer */
+		Block::Packet_descriptor p(op == Block::Packet_descriptor::READ
+		                           ? _session.dma_alloc_packet(cnt*blk_sz)
+		                           : Block::Packet_descriptor(), op, nr, cnt);
+		_session.tx()->submit_packet(p);
+		p_in_fly++;
+	}
+
+	void perform()
+	{
+		using Block::Packet_descriptor;
+
+		if (!blk_ops.supported(Packet_descriptor::WRITE_ZEROES))
+			return;
+
+		Genode::size_t const cnt = Genode::min<Block::sector_t>(BLOCKS, test_cnt);
+
+		Genode::log("zero/flush/read block 0 - ", cnt - 1);
+
+		submit(Packet_descriptor::WRITE_ZEROES, 0, cnt);
+		if (blk_ops.supported(Packet_descriptor::DISCARD))
+			submit(Packet_descriptor::DISCARD, cnt, cnt);
+		submit(Packet_descriptor::FLUSH, 0, 0);
+		submit(Packet_descriptor::READ, 0, cnt);
+
+		while (p_in_fly > 0)
+			_handle_signal();
+	}
+
+	void ack_avail()
+	{
+		 _handle = false;
+
+		while (_session.tx()->ack_avail()) {
+			Block::Packet_descriptor p = _session.tx()->get_acked_packet();
+			bool const read = p.operation() == Block::Packet_descriptor::READ;
+
+			if (!p.succeeded())
+				throw Block_exception(p.block_number(), p.block_count(), !read);
+
+			if (read) {
+				char const *content = _session.tx()->packet_content(p);
+				for (Genode::size_t i = 0; i < p.block_count()*blk_sz; i++)
+					if (content[i])
+						throw Not_zero(p.block_number(), p.block_count());
+			}
+			_session.tx()->release_packet(p);
+			p_in_fly--;
+		}
+	}
+};
+
+
 template <typename TEST>
 void perform(Genode::Env &env, Genode::Heap &heap, unsigned timeo_ms = 0)
 {
@@ -423,6 +499,7 @@ void Component::construct(Genode::Env &env)
 		perform<Read_test<Block::Session::TX_QUEUE_SIZE*5, 1> >(env, heap);
 		perform<Read_test<Block::Session::TX_QUEUE_SIZE, 1> >(env, heap);
 		perform<Write_test<Block::Session::TX_QUEUE_SIZE, 8, 16> >(env, heap);
+		perform<Zero_test>(env, heap, 1000);
 		perform<Violation_test>(env, heap, 1000);
 
 		log("Tests finished successfully!");
@@ -60,6 +60,9 @@ class Driver : public Block::Driver
 		Genode::size_t  block_size()  { return _size;   }
 		Block::sector_t block_count() { return _number; }
 
+		/* the ring buffer holds one element less than its size */
+		unsigned request_slots() { return MAX_REQUESTS - 1; }
+
 		Block::Session::Operations ops()
 		{
 			Block::Session::Operations ops;
@@ -17,6 +17,8 @@
 #include <base/heap.h>
 #include <base/attached_dataspace.h>
 #include <blit/blit.h>
+#include <nitpicker_gfx/texture_painter.h>
+#include <os/pixel_rgb565.h>
 #include <framebuffer_session/connection.h>
 #include <timer_session/connection.h>
 
@@ -120,12 +122,76 @@ struct Unaligned_blit_test : Test
 	}
 };
 
+struct Blend_test : Test
+{
+	typedef Pixel_rgb565 PT;
+
+	unsigned char *alpha = nullptr;
+
+	Blend_test(Env &env, int id, char const *brief,
+	           Texture_painter::Mode mode, bool to_fb)
+	: Test(env, id, brief)
+	{
+		Surface_base::Area const size(fb_mode.width(), fb_mode.height());
+		size_t const num_pixels = size.count();
+
+		/* alpha gradient with fully transparent and opaque areas */
+		if (!heap.alloc(num_pixels, (void **)&alpha)) {
+			env.parent().exit(-1); }
+		for (size_t i = 0; i < num_pixels; i++)
+			alpha[i] = (i % fb_mode.width()) < 64 ? 0 : i % 256;
+
+		PT *dst_pixels = to_fb ? fb_ds.local_addr<PT>() : (PT *)buf[0];
+
+		Surface<PT>       surface(dst_pixels, size);
+		Texture<PT> const texture((PT *)buf[1], alpha, size);
+
+		unsigned       kib      = 0;
+		unsigned const start_ms = timer.elapsed_ms();
+		for (; timer.elapsed_ms() - start_ms < DURATION_MS;) {
+			Texture_painter::paint(surface, texture, Color(127, 127, 127),
+			                       Texture_painter::Point(0, 0), mode, true);
+			kib += (num_pixels*sizeof(PT)) / 1024;
+		}
+		conclusion(kib, start_ms, timer.elapsed_ms());
+	}
+
+	~Blend_test() { heap.free(alpha, 0); }
+};
+
+struct Alpha_blend_test : Blend_test
+{
+	static constexpr char const *brief = "alpha-blend texture from RAM to RAM";
+
+	Alpha_blend_test(Env &env, int id)
+	: Blend_test(env, id, brief, Texture_painter::SOLID, false) { }
+};
+
+struct Alpha_blend_fb_test : Blend_test
+{
+	static constexpr char const *brief = "alpha-blend texture from RAM to FB";
+
+	Alpha_blend_fb_test(Env &env, int id)
+	: Blend_test(env, id, brief, Texture_painter::SOLID, true) { }
+};
+
+struct Mixed_blend_test : Blend_test
+{
+	static constexpr char const *brief = "mix texture with color from RAM to RAM";
+
+	Mixed_blend_test(Env &env, int id)
+	: Blend_test(env, id, brief, Texture_painter::MIXED, false) { }
+};
+
 struct Main
 {
 	Constructible<Bytewise_ram_test>   test_1;
 	Constructible<Bytewise_fb_test>    test_2;
 	Constructible<Blit_test>           test_3;
 	Constructible<Unaligned_blit_test> test_4;
+	Constructible<Alpha_blend_test>    test_5;
+	Constructible<Alpha_blend_fb_test> test_6;
+	Constructible<Mixed_blend_test>    test_7;
 
 	Main(Env &env)
 	{
@@ -134,6 +200,9 @@ struct Main
 		test_2.construct(env, 2); test_2.destruct();
 		test_3.construct(env, 3); test_3.destruct();
 		test_4.construct(env, 4); test_4.destruct();
+		test_5.construct(env, 5); test_5.destruct();
+		test_6.construct(env, 6); test_6.destruct();
+		test_7.construct(env, 7); test_7.destruct();
 		log("--- Framebuffer benchmark finished ---");
 	}
 };
@@ -0,0 +1,279 @@
+/*
+ * \brief  Throughput benchmark of the NIC router
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The component is a client of the NIC router that acts either as sender or
+ * as receiver of a stream of UDP packets. The sender resolves the MAC address
+ * of its gateway, which is the router, and saturates its NIC session with
+ * packets for the receiver. The receiver measures the throughput for a given
+ * duration and logs it.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <net/ethernet.h>
+#include <net/arp.h>
+#include <net/ipv4.h>
+#include <net/udp.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/attached_rom_dataspace.h>
+#include <nic_session/connection.h>
+#include <nic/packet_allocator.h>
+#include <timer_session/connection.h>
+
+using namespace Net;
+using namespace Genode;
+
+
+class Main
+{
+	private:
+
+		using Packet_descriptor = Nic::Packet_descriptor;
+		using Mode              = String<16>;
+
+		enum {
+			PKT_SIZE  = Nic::Packet_allocator::DEFAULT_PACKET_SIZE,
+			BUF_SIZE  = Nic::Session::QUEUE_SIZE * PKT_SIZE,
+			UDP_PORT  = 9,
+			IPV4_TTL  = 64,
+		};
+
+		Env                                 &_env;
+		Attached_rom_dataspace               _config      { _env, "config" };
+		Xml_node                      const  _node        { _config.xml() };
+		bool                          const  _sender      { _node.attribute_value("mode", Mode()) == "sender" };
+		Ipv4_address                  const  _ip          { _node.attribute_value("ip", Ipv4_address()) };
+		Ipv4_address                  const  _peer_ip     { _node.attribute_value("peer_ip", Ipv4_address()) };
+		Ipv4_address                  const  _gateway_ip  { _node.attribute_value("gateway", Ipv4_address()) };
+		size_t                        const  _packet_size { _node.attribute_value("packet_size", (size_t)1024) };
+		unsigned long                 const  _duration_us { _node.attribute_value("duration_sec", 10UL) * 1000 * 1000 };
+		Heap                                 _heap        { &_env.ram(), &_env.rm() };
+		Nic::Packet_allocator                _pkt_alloc   { &_heap };
+		Nic::Connection                      _nic         { _env, &_pkt_alloc, BUF_SIZE, BUF_SIZE };
+		Timer::Connection                    _timer       { _env };
+		Mac_address                   const  _mac         { _nic.mac_address() };
+		Mac_address                          _gateway_mac { };
+		void                                *_udp_frame   { nullptr };
+		bool                                 _resolved    { false };
+		bool                                 _measuring   { false };
+		bool                                 _done        { false };
+		unsigned long                        _start_us    { 0 };
+		unsigned long long                   _rx_bytes    { 0 };
+		unsigned long                        _rx_packets  { 0 };
+		Signal_handler<Main>                 _nic_handler { _env.ep(), *this, &Main::_handle_nic };
+		Timer::Periodic_timeout<Main>        _tick        { _timer, *this, &Main::_handle_tick,
+		                                                    Microseconds(1000 * 1000) };
+
+		unsigned long _now_us() {
+			return _timer.curr_time().trunc_to_plain_us().value; }
+
+		bool _submit(void const *frame, size_t size);
+
+		void _build_udp_frame();
+
+		void _send_arp(Arp_packet::Opcode   opcode,
+		               Mac_address   const &dst_mac,
+		               Ipv4_address  const &dst_ip);
+
+		void _handle_arp(Ethernet_frame &eth, size_t eth_size);
+
+		void _handle_ip(Ethernet_frame &eth, size_t eth_size);
+
+		void _handle_nic();
+
+		void _handle_tick(Duration);
+
+	public:
+
+		Main(Env &env);
+};
+
+
+bool Main::_submit(void const *frame, size_t size)
+{
+	try {
+		Packet_descriptor const pkt = _nic.tx()->alloc_packet(size);
+		memcpy(_nic.tx()->packet_content(pkt), frame, size);
+		_nic.tx()->submit_packet(pkt);
+		return true;
+	}
+	catch (Nic::Session::Tx::Source::Packet_alloc_failed) { return false; }
+}
+
+
+void Main::_build_udp_frame()
+{
+	size_t const ip_size  = _packet_size - sizeof(Ethernet_frame);
+	size_t const udp_size = ip_size - sizeof(Ipv4_packet);
+
+	_heap.alloc(_packet_size, &_udp_frame);
+	memset(_udp_frame, 0, _packet_size);
+
+	Ethernet_frame &eth = *new (_udp_frame) Ethernet_frame();
+	eth.dst(_gateway_mac);
+	eth.src(_mac);
+	eth.type(Ethernet_frame::Type::IPV4);
+
+	Ipv4_packet &ip = *new (eth.data<void>()) Ipv4_packet(ip_size);
+	ip.header_length(sizeof(Ipv4_packet) / 4);
+	ip.version(4);
+	ip.time_to_live(IPV4_TTL);
+	ip.protocol(Ipv4_packet::Protocol::UDP);
+	ip.total_length(ip_size);
+	ip.src(_ip);
+	ip.dst(_peer_ip);
+	ip.checksum(Ipv4_packet::calculate_checksum(ip));
+
+	Udp_packet &udp = *new (ip.data<void>()) Udp_packet(udp_size);
+	udp.src_port(Port(UDP_PORT));
+	udp.dst_port(Port(UDP_PORT));
+	udp.length(udp_size);
+	udp.update_checksum(ip.src(), ip.dst());
+}
+
+
+void Main::_send_arp(Arp_packet::Opcode   opcode,
+                     Mac_address   const &dst_mac,
+                     Ipv4_address  const &dst_ip)
+{
+	using Ethernet_arp = Ethernet_frame_sized<sizeof(Arp_packet)>;
+	Ethernet_arp eth(dst_mac, _mac, Ethernet_frame::Type::ARP);
+	size_t const arp_size = sizeof(eth) - sizeof(Ethernet_frame);
+	Arp_packet &arp = *new (eth.data<void>()) Arp_packet(arp_size);
+	arp.hardware_address_type(Arp_packet::ETHERNET);
+	arp.protocol_address_type(Arp_packet::IPV4);
+	arp.hardware_address_size(sizeof(Mac_address));
+	arp.protocol_address_size(sizeof(Ipv4_address));
+	arp.opcode(opcode);
+	arp.src_mac(_mac);
+	arp.src_ip(_ip);
+	arp.dst_mac(dst_mac);
+	arp.dst_ip(dst_ip);
+	_submit(&eth, sizeof(eth));
+}
+
+
+void Main::_handle_arp(Ethernet_frame &eth, size_t eth_size)
+{
+	Arp_packet &arp = *new (eth.data<void>())
+		Arp_packet(eth_size - sizeof(Ethernet_frame));
+
+	if (!arp.ethernet_ipv4()) {
+		return; }
+
+	switch (arp.opcode()) {
+	case Arp_packet::REQUEST:
+		if (arp.dst_ip() == _ip) {
+			_send_arp(Arp_packet::REPLY, arp.src_mac(), arp.src_ip()); }
+		return;
+
+	case Arp_packet::REPLY:
+		if (!_resolved && arp.src_ip() == _gateway_ip) {
+			_gateway_mac = arp.src_mac();
+			_resolved    = true;
+			_build_udp_frame();
+			log("gateway ", _gateway_ip, " resolved, start sending");
+		}
+		return;
+
+	default: return; }
+}
+
+
+void Main::_handle_ip(Ethernet_frame &eth, size_t eth_size)
+{
+	Ipv4_packet &ip = *new (eth.data<void>())
+		Ipv4_packet(eth_size - sizeof(Ethernet_frame));
+
+	if (_sender || ip.dst() != _ip ||
+	    ip.protocol() != Ipv4_packet::Protocol::UDP)
+	{
+		return;
+	}
+	if (!_measuring) {
+		_measuring = true;
+		_start_us  = _now_us();
+	}
+	_rx_bytes += eth_size;
+	_rx_packets++;
+}
+
+
+void Main::_handle_nic()
+{
+	/* release acknowledged packets */
+	while (_nic.tx()->ack_avail()) {
+		_nic.tx()->release_packet(_nic.tx()->get_acked_packet()); }
+
+	/* handle received packets */
+	while (_nic.rx()->packet_avail() && _nic.rx()->ready_to_ack()) {
+
+		Packet_descriptor const pkt = _nic.rx()->get_packet();
+		try {
+			Ethernet_frame &eth = *new (_nic.rx()->packet_content(pkt))
+				Ethernet_frame(pkt.size());
+
+			switch (eth.type()) {
+			case Ethernet_frame::Type::ARP:  _handle_arp(eth, pkt.size()); break;
+			case Ethernet_frame::Type::IPV4: _handle_ip(eth, pkt.size());  break;
+			default: break; }
+		}
+		catch (Ethernet_frame::No_ethernet_frame) { }
+		catch (Arp_packet::No_arp_packet)         { }
+		catch (Ipv4_packet::No_ip_packet)         { }
+
+		_nic.rx()->acknowledge_packet(pkt);
+	}
+	/* keep the send queue saturated */
+	if (_sender && _resolved) {
+		while (_nic.tx()->ready_to_submit() &&
+		       _submit(_udp_frame, _packet_size)) { } }
+}
+
+
+void Main::_handle_tick(Duration)
+{
+	if (_sender) {
+		if (!_resolved) {
+			_send_arp(Arp_packet::REQUEST, Mac_address(0xff), _gateway_ip); }
+
+		return;
+	}
+	if (!_measuring || _done) {
+		return; }
+
+	unsigned long const elapsed_us = _now_us() - _start_us;
+	if (elapsed_us < _duration_us) {
+		return; }
+
+	_done = true;
+	log("received ", _rx_packets, " packets, ",
+	    (unsigned long)(_rx_bytes * 8 / elapsed_us), " Mbit/s");
+	log("--- NIC-router benchmark finished ---");
+}
+
+
+Main::Main(Env &env) : _env(env)
+{
+	_nic.tx_channel()->sigh_ready_to_submit(_nic_handler);
+	_nic.tx_channel()->sigh_ack_avail      (_nic_handler);
+	_nic.rx_channel()->sigh_ready_to_ack   (_nic_handler);
+	_nic.rx_channel()->sigh_packet_avail   (_nic_handler);
+
+	log("NIC-router benchmark ", _sender ? "sender" : "receiver", " ", _ip);
+	if (_sender) {
+		_send_arp(Arp_packet::REQUEST, Mac_address(0xff), _gateway_ip); }
+}
+
+
+void Component::construct(Env &env) { static Main main(env); }
@@ -0,0 +1,278 @@
+/*
+ * \brief  Benchmark of the longest-prefix match of the NIC router
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The benchmark compares the prefix tree used by the NIC router for IP and
+ * transport rules with a linear walk over a prefix-size-sorted list, which
+ * was used before. It sweeps the number of rules from 10 to 10000. Before
+ * measuring, the results of both implementations are compared for each
+ * looked-up address as well as for a few fixed corner cases.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+/* NIC router includes */
+#include <prefix_tree.h>
+
+using namespace Net;
+using namespace Genode;
+
+
+struct Lookup_mismatch : Genode::Exception { };
+
+
+struct Random
+{
+	uint32_t _state = 0x2545f491;
+
+	uint32_t next()
+	{
+		/* xorshift32 */
+		_state ^= _state << 13;
+		_state ^= _state >> 17;
+		_state ^= _state << 5;
+		return _state;
+	}
+};
+
+
+struct Rule : Prefix_tree<Rule>::Element
+{
+	Ipv4_address_prefix dst { };
+	Rule               *next { nullptr };
+};
+
+
+static uint32_t mask(uint8_t prefix) {
+	return prefix ? ~0U << (32 - prefix) : 0; }
+
+
+/**
+ * Prefix tree and prefix-size-sorted list over the same rules
+ */
+struct Rule_set
+{
+	Prefix_tree<Rule>  tree { };
+	Rule              *list { nullptr };
+
+	void insert(Rule &rule)
+	{
+		tree.insert(rule.dst, rule);
+
+		Rule **link = &list;
+		for (; *link && (*link)->dst.prefix > rule.dst.prefix;
+		     link = &(*link)->next);
+
+		rule.next = *link;
+		*link     = &rule;
+	}
+
+	Rule const *linear_match(Ipv4_address const &ip) const
+	{
+		for (Rule const *curr = list; curr; curr = curr->next)
+			if (curr->dst.prefix_matches(ip))
+				return curr;
+		return nullptr;
+	}
+
+	/**
+	 * Compare the results of both implementations for 'ip'
+	 *
+	 * Rules with equal prefixes are interchangeable. Hence, only the
+	 * matched prefixes are compared.
+	 *
+	 * \throw Lookup_mismatch
+	 */
+	void verify(Ipv4_address const &ip) const
+	{
+		Rule const * const linear = linear_match(ip);
+		Rule const * const tree_match = tree.longest_prefix_match(ip);
+
+		if (!linear && !tree_match)
+			return;
+
+		if (linear && tree_match
+		 && linear->dst.prefix == tree_match->dst.prefix
+		 && linear->dst.address == tree_match->dst.address)
+			return;
+
+		error("lookup of ", ip, " mismatches: list ",
+		      linear ? linear->dst : Ipv4_address_prefix(), " tree ",
+		      tree_match ? tree_match->dst : Ipv4_address_prefix());
+		throw Lookup_mismatch();
+	}
+};
+
+
+struct Test
+{
+	enum { LOOKUPS = 200*1000 };
+
+	Timer::Connection &timer;
+	Heap              &heap;
+	unsigned const     num;
+	Rule              *rules { nullptr };
+	Rule_set           set   { };
+	Random             random { };
+
+	unsigned long _checksum = 0;
+
+	Ipv4_address _random_dst()
+	{
+		/* half of the lookups hit a rule, the other half is random */
+		if (random.next() & 1)
+			return Ipv4_address::from_uint32_little_endian(random.next());
+
+		Rule const &rule = rules[random.next() % num];
+		uint32_t const host = rule.dst.prefix < 32
+		                    ? random.next() & ((1U << (32 - rule.dst.prefix)) - 1)
+		                    : 0;
+		return Ipv4_address::from_uint32_little_endian(
+			rule.dst.address.to_uint32_little_endian() | host);
+	}
+
+	template <typename FN>
+	unsigned long _measure(FN const &fn)
+	{
+		random = Random();
+		unsigned long const start_ms = timer.elapsed_ms();
+		for (unsigned i = 0; i < LOOKUPS; i++)
+			_checksum += (addr_t)fn(_random_dst());
+
+		return max(timer.elapsed_ms() - start_ms, 1UL);
+	}
+
+	Test(Timer::Connection &timer, Heap &heap, unsigned num)
+	:
+		timer(timer), heap(heap), num(num)
+	{
+		heap.alloc(sizeof(Rule)*num, (void **)&rules);
+
+		for (unsigned i = 0; i < num; i++) {
+			Rule &rule = *construct_at<Rule>(&rules[i]);
+
+			/* prefix sizes between 8 and 32 bits */
+			uint8_t const prefix = 8 + random.next() % 25;
+
+			rule.dst.address = Ipv4_address::from_uint32_little_endian(
+				random.next() & mask(prefix));
+			rule.dst.prefix  = prefix;
+
+			set.insert(rule);
+		}
+
+		/* compare both implementations for all looked-up addresses */
+		random = Random();
+		for (unsigned i = 0; i < LOOKUPS; i++)
+			set.verify(_random_dst());
+
+		unsigned long const list_ms = _measure([&] (Ipv4_address const &ip) {
+			return set.linear_match(ip); });
+
+		unsigned long const tree_ms = _measure([&] (Ipv4_address const &ip) {
+			return set.tree.longest_prefix_match(ip); });
+
+		log(num, " rules: ", (unsigned)LOOKUPS, " lookups, list ", list_ms,
+		    " ms, tree ", tree_ms, " ms");
+	}
+
+	~Test() { heap.free(rules, sizeof(Rule)*num); }
+};
+
+
+/**
+ * Check overlapping prefixes, the default route, and host routes
+ *
+ * \throw Lookup_mismatch
+ */
+static void test_corner_cases()
+{
+	struct Fixed_rule { char const *address; uint8_t prefix; };
+
+	static Fixed_rule const fixed_rules[] = {
+		{ "0.0.0.0",      0 }, { "10.0.0.0",     8 }, { "10.1.0.0",    16 },
+		{ "10.1.2.0",    24 }, { "10.1.2.3",    32 }, { "10.1.2.128", 25 },
+		{ "10.128.0.0",   9 }, { "192.168.1.1", 32 }, { "10.1.0.0",    16 } };
+
+	static char const * const addresses[] = {
+		"0.0.0.0", "255.255.255.255", "10.0.0.1", "10.1.0.1", "10.1.2.1",
+		"10.1.2.3", "10.1.2.4", "10.1.2.200", "10.200.0.1", "192.168.1.1",
+		"192.168.1.2", "11.0.0.0" };
+
+	enum { NUM_RULES = sizeof(fixed_rules)/sizeof(fixed_rules[0]) };
+
+	/* verify with and without the default route */
+	for (unsigned first = 0; first < 2; first++) {
+
+		Rule     rules[NUM_RULES];
+		Rule_set set;
+
+		for (unsigned i = first; i < NUM_RULES; i++) {
+			rules[i].dst.address = Ipv4_packet::ip_from_string(fixed_rules[i].address);
+			rules[i].dst.prefix  = fixed_rules[i].prefix;
+			set.insert(rules[i]);
+		}
+
+		for (char const *address : addresses)
+			set.verify(Ipv4_packet::ip_from_string(address));
+
+		/* the host route must win over all overlapping prefixes */
+		Rule const *match =
+			set.tree.longest_prefix_match(Ipv4_packet::ip_from_string("10.1.2.3"));
+		if (!match || match->dst.prefix != 32) {
+			error("host route not matched");
+			throw Lookup_mismatch();
+		}
+
+		/* only the default route matches an otherwise unmatched address */
+		match = set.tree.longest_prefix_match(Ipv4_packet::ip_from_string("11.0.0.0"));
+		if ((first == 0) != (match && match->dst.prefix == 0)) {
+			error("default route mismatch");
+			throw Lookup_mismatch();
+		}
+	}
+}
+
+
+struct Main
+{
+	Env               &env;
+	Timer::Connection  timer { env };
+	Heap               heap  { env.ram(), env.rm() };
+
+	Main(Env &env) : env(env)
+	{
+		log("--- NIC-router LPM benchmark ---");
+
+		try {
+			test_corner_cases();
+
+			unsigned const num_rules[] = { 10, 100, 1000, 10000 };
+			for (unsigned num : num_rules)
+				Test test(timer, heap, num);
+		}
+		catch (Lookup_mismatch) {
+			error("prefix tree and linear list disagree");
+			env.parent().exit(-1);
+			return;
+		}
+
+		log("--- NIC-router LPM benchmark finished ---");
+		env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
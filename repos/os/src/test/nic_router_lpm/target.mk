@@ -0,0 +1,4 @@
+TARGET   = test-nic_router_lpm
+SRC_CC   = main.cc
+LIBS     = base net
+INC_DIR += $(REP_DIR)/src/server/nic_router
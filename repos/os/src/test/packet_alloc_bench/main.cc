@@ -0,0 +1,166 @@
+/*
+ * \brief  Benchmark of packet-stream allocators
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The benchmark compares the bitmap-based 'Packet_allocator' with the
+ * 'Buddy_packet_allocator'. Both are exercised with a mix of small
+ * (acknowledgement-sized) and large (frame-sized) packets. The buffer is
+ * first filled to its limit, then packets are released and allocated in a
+ * random order to keep the buffer nearly full.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <os/packet_allocator.h>
+#include <os/buddy_packet_allocator.h>
+#include <timer_session/connection.h>
+
+using namespace Genode;
+
+
+struct Random
+{
+	uint32_t _state = 0x12345678;
+
+	uint32_t next()
+	{
+		/* xorshift32 */
+		_state ^= _state << 13;
+		_state ^= _state >> 17;
+		_state ^= _state << 5;
+		return _state;
+	}
+};
+
+
+struct Test
+{
+	enum {
+		BUFFER_SIZE = 4*1024*1024,
+		BLOCK_SIZE  = 64,
+		SMALL_SIZE  = 64,
+		LARGE_SIZE  = 1500,
+		MAX_PACKETS = BUFFER_SIZE / SMALL_SIZE,
+		STEADY_OPS  = 1000*1000,
+	};
+
+	struct Packet { addr_t addr; size_t size; };
+
+	Env               &env;
+	Timer::Connection &timer;
+	Heap              &heap;
+	Range_allocator   &alloc;
+	Random             random  { };
+	Packet            *packets { nullptr };
+	unsigned           num     { 0 };
+
+	size_t _packet_size() {
+		return (random.next() % 4) ? SMALL_SIZE : LARGE_SIZE; }
+
+	bool _alloc()
+	{
+		if (num == MAX_PACKETS)
+			return false;
+
+		size_t const size = _packet_size();
+		void *addr = nullptr;
+		if (alloc.alloc_aligned(size, &addr, 0).error())
+			return false;
+
+		packets[num++] = Packet { (addr_t)addr, size };
+		return true;
+	}
+
+	void _free()
+	{
+		unsigned const i = random.next() % num;
+		alloc.free((void *)packets[i].addr, packets[i].size);
+		packets[i] = packets[--num];
+	}
+
+	Test(Env &env, Timer::Connection &timer, Heap &heap,
+	     Range_allocator &alloc, char const *name)
+	:
+		env(env), timer(timer), heap(heap), alloc(alloc)
+	{
+		log("\nTEST: ", name, "\n");
+
+		heap.alloc(sizeof(Packet)*MAX_PACKETS, (void **)&packets);
+		alloc.add_range(BLOCK_SIZE, BUFFER_SIZE);
+
+		/* fill buffer */
+		unsigned long const fill_start_ms = timer.elapsed_ms();
+		unsigned      fill_failed = 0;
+		size_t        used        = 0;
+		for (unsigned i = 0; i < MAX_PACKETS && fill_failed < 16; i++) {
+			if (_alloc()) used += packets[num - 1].size;
+			else          fill_failed++;
+		}
+		unsigned long const fill_ms = timer.elapsed_ms() - fill_start_ms;
+
+		log("fill: ", num, " packets, ", used / 1024, " KiB of ",
+		    (unsigned)BUFFER_SIZE / 1024, " KiB used, ", fill_ms, " ms");
+
+		/* steady state with a nearly full buffer */
+		unsigned long const start_ms = timer.elapsed_ms();
+		unsigned      failed   = 0;
+		for (unsigned i = 0; i < STEADY_OPS; i++) {
+			_free();
+			if (!_alloc())
+				failed++;
+			if (!num)
+				_alloc();
+		}
+		unsigned long const ms = max(timer.elapsed_ms() - start_ms, 1UL);
+
+		log("steady state: ", (unsigned)STEADY_OPS, " free/alloc pairs in ",
+		    ms, " ms (", (unsigned long)STEADY_OPS / ms, " pairs/ms), ",
+		    failed, " allocations failed");
+	}
+
+	~Test()
+	{
+		while (num)
+			_free();
+
+		alloc.remove_range(BLOCK_SIZE, BUFFER_SIZE);
+		heap.free(packets, sizeof(Packet)*MAX_PACKETS);
+	}
+};
+
+
+struct Main
+{
+	Env               &env;
+	Timer::Connection  timer { env };
+	Heap               heap  { env.ram(), env.rm() };
+
+	Main(Env &env) : env(env)
+	{
+		log("--- packet-allocator benchmark ---");
+
+		{
+			Packet_allocator alloc(&heap, Test::BLOCK_SIZE);
+			Test test(env, timer, heap, alloc, "bitmap packet allocator");
+		}
+		{
+			Buddy_packet_allocator alloc(heap, log2((unsigned)Test::BLOCK_SIZE));
+			Test test(env, timer, heap, alloc, "buddy packet allocator");
+		}
+
+		log("--- packet-allocator benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Env &env) { static Main main(env); }
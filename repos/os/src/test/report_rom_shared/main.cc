@@ -0,0 +1,150 @@
+/*
+ * \brief  Test for report-ROM readers that share the report content
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * The test repeatedly reports content of growing size while three ROM
+ * clients share the report. Each client has to observe each report. Because
+ * the report grows with each round, the report-ROM server allocates a new
+ * snapshot per round. If retired snapshots were not freed once all readers
+ * released them, the server would exceed its RAM quota.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#include <base/log.h>
+#include <base/component.h>
+#include <base/attached_ram_dataspace.h>
+#include <base/attached_rom_dataspace.h>
+#include <os/reporter.h>
+#include <util/string.h>
+
+
+namespace Test {
+	struct Main;
+	using namespace Genode;
+}
+
+
+struct Test::Main
+{
+	enum { ROUNDS      = 64,
+	       BASE_SIZE   = 32*1024,
+	       STEP_SIZE   = 1024,
+	       BUFFER_SIZE = 128*1024 };
+
+	Env &_env;
+
+	typedef String<32> Header;
+
+	static Header _header(unsigned round) { return Header("round ", round, "\n"); }
+
+	static size_t _size(unsigned round) { return BASE_SIZE + round*STEP_SIZE; }
+
+	struct Reader
+	{
+		char const * const     name;
+		Attached_rom_dataspace rom;
+		unsigned               round = ~0U;  /* last observed round */
+
+		Reader(Env &env, char const *name) : name(name), rom(env, name) { }
+	};
+
+	Attached_ram_dataspace _buffer   { _env.ram(), _env.rm(), BUFFER_SIZE };
+	Reporter               _reporter { _env, "data", "data", BUFFER_SIZE };
+
+	unsigned _round = 0;
+
+	Reader _reader_a { _env, "reader_a" };
+	Reader _reader_b { _env, "reader_b" };
+	Reader _reader_c { _env, "reader_c" };
+
+	void _report()
+	{
+		char   * const dst    = _buffer.local_addr<char>();
+		size_t   const size   = _size(_round);
+		Header   const header = _header(_round);
+
+		memset(dst, 'x', size);
+		memcpy(dst, header.string(), header.length() - 1);
+		_reporter.report(dst, size);
+	}
+
+	void _fail(Reader const &reader, char const *msg)
+	{
+		error(reader.name, ": ", msg, " in round ", _round);
+		_env.parent().exit(-1);
+	}
+
+	void _handle_update(Reader &reader)
+	{
+		if (_round == ROUNDS)
+			return;
+
+		reader.rom.update();
+		if (!reader.rom.valid())
+			return;
+
+		char   const * const content = reader.rom.local_addr<char const>();
+		size_t         const size    = _size(_round);
+		Header         const header  = _header(_round);
+
+		if (strcmp(content, header.string(), header.length() - 1)) {
+			_fail(reader, "unexpected content");
+			return;
+		}
+
+		if (reader.rom.size() <= size || content[size - 1] != 'x' || content[size]) {
+			_fail(reader, "unexpected content size");
+			return;
+		}
+
+		reader.round = _round;
+
+		if (_reader_a.round != _round || _reader_b.round != _round
+		 || _reader_c.round != _round)
+			return;
+
+		if (++_round < ROUNDS) {
+			_report();
+			return;
+		}
+
+		log("all readers observed ", (unsigned)ROUNDS, " reports");
+		log("--- test-report_rom_shared finished ---");
+		_env.parent().exit(0);
+	}
+
+	void _handle_update_a() { _handle_update(_reader_a); }
+	void _handle_update_b() { _handle_update(_reader_b); }
+	void _handle_update_c() { _handle_update(_reader_c); }
+
+	Signal_handler<Main> _update_a_handler {
+		_env.ep(), *this, &Main::_handle_update_a };
+
+	Signal_handler<Main> _update_b_handler {
+		_env.ep(), *this, &Main::_handle_update_b };
+
+	Signal_handler<Main> _update_c_handler {
+		_env.ep(), *this, &Main::_handle_update_c };
+
+	Main(Env &env) : _env(env)
+	{
+		log("--- test-report_rom_shared started ---");
+
+		_reader_a.rom.sigh(_update_a_handler);
+		_reader_b.rom.sigh(_update_b_handler);
+		_reader_c.rom.sigh(_update_c_handler);
+
+		_reporter.enabled(true);
+		_report();
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
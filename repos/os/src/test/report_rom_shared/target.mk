@@ -0,0 +1,3 @@
+TARGET = test-report_rom_shared
+SRC_CC = main.cc
+LIBS   = base
@@ -0,0 +1,197 @@
+/*
+ * \brief  Benchmark of large flat directories
+ * \author Genode Labs
+ * \date   2017-09-04
+ *
+ * For each '<bench>' node of the configuration, the benchmark creates
+ * 'count' files within the directory at 'path', looks up each of them, lists
+ * the directory, and unlinks the files again. The directory is accessed via
+ * the VFS declared by the '<vfs>' node.
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+/* Genode includes */
+#include <vfs/file_system_factory.h>
+#include <vfs/dir_file_system.h>
+#include <timer_session/connection.h>
+#include <base/attached_rom_dataspace.h>
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/snprintf.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Failed : Genode::Exception { };
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	Env &_env;
+
+	Heap _heap { _env.ram(), _env.rm() };
+
+	Attached_rom_dataspace _config { _env, "config" };
+
+	Timer::Connection _timer { _env };
+
+	struct Io_response_handler : Vfs::Io_response_handler
+	{
+		void handle_io_response(Vfs::Vfs_handle::Context *) override { }
+
+	} _io_response_handler;
+
+	Vfs::Global_file_system_factory _fs_factory { _heap };
+
+	Vfs::Dir_file_system _vfs { _env, _heap, _config.xml().sub_node("vfs"),
+	                            _io_response_handler, _fs_factory };
+
+	typedef String<Vfs::MAX_PATH_LEN> Path;
+
+	static Path _file_path(Path const &dir, unsigned i)
+	{
+		char buf[Vfs::MAX_PATH_LEN];
+		snprintf(buf, sizeof(buf), "%s/file_%u", dir.string(), i);
+		return Path(Cstring(buf));
+	}
+
+	/**
+	 * Execute 'fn' for each file and log the duration
+	 */
+	template <typename FN>
+	void _measure(char const *op, Path const &dir, unsigned count, FN const &fn)
+	{
+		unsigned long const start_ms = _timer.elapsed_ms();
+
+		for (unsigned i = 0; i < count; i++)
+			fn(_file_path(dir, i));
+
+		unsigned long const ms = _timer.elapsed_ms() - start_ms;
+
+		log(dir, ": ", op, " ", count, " files in ", ms, " ms (",
+		    count ? (ms*1000)/count : 0, " us/op)");
+	}
+
+	unsigned _list(Path const &dir)
+	{
+		typedef Vfs::Directory_service::Dirent Dirent;
+		typedef Vfs::File_io_service::Read_result Read_result;
+
+		Vfs::Vfs_handle *handle = nullptr;
+		if (_vfs.opendir(dir.string(), false, &handle, _heap) !=
+		    Vfs::Directory_service::OPENDIR_OK)
+			throw Failed();
+
+		Vfs::Vfs_handle::Guard guard(handle);
+
+		for (unsigned i = 0;; i++) {
+
+			Dirent dirent;
+			Vfs::file_size n = 0;
+
+			handle->seek(i*sizeof(Dirent));
+
+			while (!handle->fs().queue_read(handle, sizeof(Dirent)))
+				_env.ep().wait_and_dispatch_one_io_signal();
+
+			Read_result result;
+			while ((result = handle->fs().complete_read(handle, (char *)&dirent,
+			                                            sizeof(Dirent), n))
+			       == Vfs::File_io_service::READ_QUEUED)
+				_env.ep().wait_and_dispatch_one_io_signal();
+
+			if (result != Vfs::File_io_service::READ_OK)
+				throw Failed();
+
+			if (dirent.type == Vfs::Directory_service::DIRENT_TYPE_END)
+				return i;
+		}
+	}
+
+	void _bench(Xml_node node)
+	{
+		Path     const dir   = node.attribute_value("path", Path());
+		unsigned const count = node.attribute_value("count", 100000U);
+
+		log(dir, ": ", count, " files");
+
+		Vfs::Vfs_handle *dir_handle = nullptr;
+		if (_vfs.opendir(dir.string(), true, &dir_handle, _heap) ==
+		    Vfs::Directory_service::OPENDIR_OK)
+			dir_handle->ds().close(dir_handle);
+
+		_measure("created", dir, count, [&] (Path const &path) {
+
+			Vfs::Vfs_handle *handle = nullptr;
+			if (_vfs.open(path.string(),
+			              Vfs::Directory_service::OPEN_MODE_CREATE |
+			              Vfs::Directory_service::OPEN_MODE_WRONLY,
+			              &handle, _heap) != Vfs::Directory_service::OPEN_OK) {
+				error("could not create ", path);
+				throw Failed();
+			}
+			handle->ds().close(handle);
+		});
+
+		_measure("looked up", dir, count, [&] (Path const &path) {
+
+			Vfs::Directory_service::Stat stat;
+			if (_vfs.stat(path.string(), stat) != Vfs::Directory_service::STAT_OK) {
+				error("could not look up ", path);
+				throw Failed();
+			}
+		});
+
+		{
+			unsigned long const start_ms = _timer.elapsed_ms();
+
+			unsigned const num = _list(dir);
+
+			unsigned long const ms = _timer.elapsed_ms() - start_ms;
+
+			log(dir, ": listed ", num, " entries in ", ms, " ms");
+
+			if (num != count) {
+				error("unexpected number of directory entries");
+				throw Failed();
+			}
+		}
+
+		_measure("unlinked", dir, count, [&] (Path const &path) {
+
+			if (_vfs.unlink(path.string()) != Vfs::Directory_service::UNLINK_OK) {
+				error("could not unlink ", path);
+				throw Failed();
+			}
+		});
+
+		if (_list(dir) != 0) {
+			error("directory not empty after unlinking all files");
+			throw Failed();
+		}
+	}
+
+	Main(Env &env) : _env(env)
+	{
+		_config.xml().for_each_sub_node("bench", [&] (Xml_node node) {
+			_bench(node); });
+
+		log("--- VFS directory benchmark finished ---");
+
+		_env.parent().exit(0);
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -12,8 +12,13 @@
  */
 
 #include <util/xml_node.h>
+#include <util/xml_index.h>
+#include <util/xml_generator.h>
+#include <base/arena.h>
+#include <base/attached_ram_dataspace.h>
 #include <base/component.h>
 #include <base/log.h>
+#include <timer_session/connection.h>
 
 using namespace Genode;
 
@@ -314,6 +319,165 @@ static void log_xml_info(const char *xml_string)
 }
 
 
+static void log_indexed_xml_info(Allocator &alloc, const char *xml_string)
+{
+	try {
+		Xml_index index(alloc, xml_string);
+		log(Formatted_xml_node(index.xml()));
+	} catch (Xml_node::Invalid_syntax) {
+		log("string has invalid XML syntax\n");
+	}
+}
+
+
+/***************
+ ** Benchmark **
+ ***************/
+
+/**
+ * Generate init-like configuration with 'num' start nodes
+ *
+ * \return size of the document
+ */
+static size_t generate_bench_config(char *dst, size_t dst_len, unsigned num)
+{
+	typedef String<32> Name;
+
+	Xml_generator xml(dst, dst_len, "config", [&] () {
+		for (unsigned i = 0; i < num; i++) {
+			xml.node("start", [&] () {
+				xml.attribute("name", Name("child_", i));
+				xml.attribute("caps", 100 + i % 50);
+				xml.node("resource", [&] () {
+					xml.attribute("name", "RAM");
+					xml.attribute("quantum", 4096UL*(i % 1000 + 1));
+				});
+				xml.node("provides", [&] () {
+					xml.node("service", [&] () {
+						xml.attribute("name", Name("Service_", i)); }); });
+				xml.node("route", [&] () {
+					xml.node("service", [&] () {
+						xml.attribute("name", "ROM");
+						xml.attribute("label", "config");
+						xml.node("parent", [&] () {
+							xml.attribute("label", Name("config_", i)); });
+					});
+					xml.node("service", [&] () {
+						xml.attribute("name", "LOG");
+						xml.node("child", [&] () {
+							xml.attribute("name", Name("child_", (i*7) % num)); });
+					});
+					xml.node("any-service", [&] () { xml.node("parent"); });
+				});
+			});
+		}
+	});
+	return xml.used();
+}
+
+
+struct Traversal
+{
+	unsigned long nodes    = 0;
+	unsigned long checksum = 0;
+
+	Traversal(Xml_node node) { _visit(node); }
+
+	void _visit(Xml_node node)
+	{
+		nodes++;
+		checksum += node.attribute_value("caps", 0UL)
+		          + node.attribute_value("quantum", 0UL)
+		          + node.num_sub_nodes();
+
+		node.for_each_sub_node([&] (Xml_node sub_node) { _visit(sub_node); });
+	}
+};
+
+
+/**
+ * Access sub nodes by position as done by loops over 'sub_node(i)'
+ */
+static unsigned long access_by_position(Xml_node node, unsigned num)
+{
+	unsigned long checksum = 0;
+	for (unsigned i = 0; i < num; i++)
+		checksum += node.sub_node(i).attribute_value("caps", 0UL);
+	return checksum;
+}
+
+
+struct Bench_result { unsigned long nodes, checksum, positional; };
+
+
+/**
+ * Measure the traversal of the benchmark document
+ *
+ * \param t0  time before the construction of 'root'
+ */
+static Bench_result bench_traversal(Timer::Connection &timer, char const *name,
+                                    unsigned long t0, Xml_node root)
+{
+	enum { NUM_POSITIONS = 500 };
+
+	unsigned long const t1 = timer.elapsed_ms();
+
+	Traversal const traversal(root);
+
+	unsigned long const t2 = timer.elapsed_ms();
+
+	unsigned long const positional = access_by_position(root, NUM_POSITIONS);
+
+	unsigned long const t3 = timer.elapsed_ms();
+
+	log(name, ": construction ", t1 - t0, " ms, "
+	    "traversal ", t2 - t1, " ms, "
+	    "positional access ", t3 - t2, " ms");
+
+	return Bench_result { traversal.nodes, traversal.checksum, positional };
+}
+
+
+/**
+ * \return true if the indexed traversal yields the same results
+ */
+static bool parse_bench(Env &env)
+{
+	enum { BUF_SIZE = 8*1024*1024, NUM_START_NODES = 10000 };
+
+	Timer::Connection timer(env);
+
+	Attached_ram_dataspace buf(env.ram(), env.rm(), BUF_SIZE);
+
+	size_t const size = generate_bench_config(buf.local_addr<char>(), BUF_SIZE,
+	                                          NUM_START_NODES);
+	char const * const doc = buf.local_addr<char const>();
+
+	unsigned long const plain_t0 = timer.elapsed_ms();
+	Xml_node const root(doc, size);
+	Bench_result const plain = bench_traversal(timer, "plain", plain_t0, root);
+
+	Arena arena(env.ram(), env.rm());
+
+	unsigned long const indexed_t0 = timer.elapsed_ms();
+	Xml_index const index(arena, doc, size);
+	Bench_result const indexed =
+		bench_traversal(timer, "indexed", indexed_t0, index.xml());
+
+	log("document of ", size, " bytes with ", plain.nodes, " nodes");
+
+	if (plain.nodes      != indexed.nodes
+	 || plain.checksum   != indexed.checksum
+	 || plain.positional != indexed.positional
+	 || plain.nodes      != index.num_nodes()) {
+		error("results of indexed traversal differ");
+		return false;
+	}
+	log("results of indexed traversal match");
+	return true;
+}
+
+
 void Component::construct(Genode::Env &env)
 {
 	log("--- XML-token test ---");
@@ -351,6 +515,29 @@ void Component::construct(Genode::Env &env)
 	log("-- Test parsing XML with comments --");
 	log_xml_info(xml_test_comments);
 
+	{
+		Arena arena(env.ram(), env.rm());
+
+		log("-- Test indexed XML view --");
+		log_indexed_xml_info(arena, xml_test_attributes);
+		log_indexed_xml_info(arena, xml_test_comments);
+		log_indexed_xml_info(arena, xml_test_truncated);
+
+		Xml_index index(arena, xml_test_valid);
+		log("number of indexed nodes = ", index.num_nodes());
+		Xml_node prg(index.xml().sub_node(1U));
+		log_key(prg, "filename");
+		log_key(prg, "info");
+	}
+
 	log("--- End of XML-parser test ---");
+
+	log("--- XML-parser benchmark ---");
+	if (!parse_bench(env)) {
+		env.parent().exit(-1);
+		return;
+	}
+	log("--- End of XML-parser benchmark ---");
+
 	env.parent().exit(0);
 }
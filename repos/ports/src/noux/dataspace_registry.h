@@ -18,10 +18,14 @@
 #include <base/rpc_server.h>
 #include <dataspace/client.h>
 
+/* Noux includes */
+#include <fork_state.h>
+
 namespace Noux {
 	class Dataspace_user;
 	class Dataspace_info;
 	class Dataspace_registry;
+	class Pd_session_component;
 
 	struct Static_dataspace_info;
 
@@ -89,7 +93,8 @@ class Noux::Dataspace_info : public Object_pool<Dataspace_info>::Entry
 		/**
 		 * Create shadow copy of dataspace
 		 *
-		 * \param ram          backing store used for copied dataspaces
+		 * \param dst_pd       PD session of the new process, which
+		 *                     provides the copies of RAM dataspaces
 		 * \param local_rm     region map used for temporarily attaching
 		 *                     dataspaces to the local address space
 		 * \param alloc        allocator used for creatng new 'Dataspace_info'
@@ -100,13 +105,15 @@ class Noux::Dataspace_info : public Object_pool<Dataspace_info>::Entry
 		 *                     interface of the new dataspace
 		 *                     (used if the dataspace is a sub
 		 *                     RM session)
+		 * \param fork_state   state of the fork, accumulates statistics
 		 * \return             capability for the new dataspace
 		 */
-		virtual Dataspace_capability fork(Ram_allocator      &ram,
-		                                  Region_map         &local_rm,
-		                                  Allocator          &alloc,
-		                                  Dataspace_registry &ds_registry,
-		                                  Rpc_entrypoint     &ep) = 0;
+		virtual Dataspace_capability fork(Pd_session_component &dst_pd,
+		                                  Region_map           &local_rm,
+		                                  Allocator            &alloc,
+		                                  Dataspace_registry   &ds_registry,
+		                                  Rpc_entrypoint       &ep,
+		                                  Fork_state           &fork_state) = 0;
 
 		/**
 		 * Write raw byte sequence into dataspace
@@ -186,11 +193,12 @@ struct Noux::Static_dataspace_info : Dataspace_info
 		_ds_registry.apply(ds_cap(), lambda);
 	}
 
-	Dataspace_capability fork(Ram_allocator      &,
-	                          Region_map         &,
-	                          Allocator          &,
-	                          Dataspace_registry &,
-	                          Rpc_entrypoint     &) override
+	Dataspace_capability fork(Pd_session_component &,
+	                          Region_map           &,
+	                          Allocator            &,
+	                          Dataspace_registry   &,
+	                          Rpc_entrypoint       &,
+	                          Fork_state           &) override
 	{
 		return ds_cap();
 	}
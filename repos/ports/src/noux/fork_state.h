@@ -0,0 +1,89 @@
+/*
+ * \brief  State of replaying an address space into a forked process
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _NOUX__FORK_STATE_H_
+#define _NOUX__FORK_STATE_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <base/capability.h>
+#include <dataspace/capability.h>
+#include <util/list.h>
+#include <util/noncopyable.h>
+
+namespace Noux {
+	class Fork_state;
+	using namespace Genode;
+}
+
+
+/**
+ * Record of the dataspaces forked while replaying an address space
+ *
+ * A dataspace attached at several regions of the forking process is forked
+ * only once. This way, the regions of the new process share the same copy
+ * like the regions of the forking process share the original dataspace.
+ *
+ * The state also accumulates the statistics of the fork.
+ */
+class Noux::Fork_state : Noncopyable
+{
+	private:
+
+		struct Forked_dataspace : List<Forked_dataspace>::Element
+		{
+			Dataspace_capability const src;
+			Dataspace_capability const dst;
+
+			Forked_dataspace(Dataspace_capability src, Dataspace_capability dst)
+			: src(src), dst(dst) { }
+		};
+
+		Allocator &_alloc;
+
+		List<Forked_dataspace> _forked;
+
+	public:
+
+		/* chunks of RAM dataspaces shared with the new process */
+		unsigned long chunks_shared = 0;
+
+		Fork_state(Allocator &alloc) : _alloc(alloc) { }
+
+		~Fork_state()
+		{
+			while (Forked_dataspace *ds = _forked.first()) {
+				_forked.remove(ds);
+				destroy(_alloc, ds);
+			}
+		}
+
+		/**
+		 * Return copy of dataspace if already forked, or an invalid capability
+		 */
+		Dataspace_capability forked(Dataspace_capability src) const
+		{
+			for (Forked_dataspace const *ds = _forked.first(); ds; ds = ds->next())
+				if (ds->src.local_name() == src.local_name())
+					return ds->dst;
+
+			return Dataspace_capability();
+		}
+
+		void record(Dataspace_capability src, Dataspace_capability dst)
+		{
+			_forked.insert(new (_alloc) Forked_dataspace(src, dst));
+		}
+};
+
+#endif /* _NOUX__FORK_STATE_H_ */
@@ -11,6 +11,13 @@
  * dataspaces allocated by each Noux process. When forking a process, the
  * acquired information (in the form of 'Ram_dataspace_info' objects) is used
  * to create a shadow copy of the forking address space.
+ *
+ * The shadow copy is created lazily. Each RAM dataspace handed out to a
+ * Noux process is a managed dataspace composed of chunks of a backing store.
+ * At fork time, the dataspaces of both processes refer to the same chunks,
+ * which are detached. A process that touches a chunk faults, and Noux
+ * copies the chunk if it is still shared with another process. So the memory
+ * dropped by a child that calls execve right after fork is never copied.
  */
 
 /*
@@ -25,69 +32,331 @@
 
 /* Genode includes */
 #include <pd_session/connection.h>
+#include <rm_session/connection.h>
+#include <region_map/client.h>
 #include <base/rpc_server.h>
 #include <base/env.h>
+#include <util/construct_at.h>
+#include <util/reconstructible.h>
 
 /* Noux includes */
 #include <region_map_component.h>
 #include <dataspace_registry.h>
+#include <ram_backing.h>
 
 namespace Noux {
-	struct Ram_dataspace_info;
-	struct Pd_session_component;
+	class Ram_dataspace_info;
+	class Pd_session_component;
 	using namespace Genode;
 }
 
 
-struct Noux::Ram_dataspace_info : Dataspace_info,
-                                  List<Ram_dataspace_info>::Element
+class Noux::Ram_dataspace_info : public Dataspace_info,
+                                 public List<Ram_dataspace_info>::Element
 {
-	Ram_dataspace_info(Ram_dataspace_capability ds_cap)
-	: Dataspace_info(ds_cap) { }
+	public:
+
+		enum { CHUNK_SIZE = Ram_backing::CHUNK_SIZE };
+
+		/**
+		 * Resources shared by the RAM dataspaces of a Noux process
+		 */
+		struct Resources
+		{
+			Ram_allocator &ram;       /* backing store of the chunks  */
+			Region_map    &local_rm;  /* used for copying chunks      */
+			Allocator     &alloc;     /* meta data                    */
+			Rm_connection &rm;        /* creates managed dataspaces   */
+			Entrypoint    &ep;        /* handles faults at dataspaces */
+
+			Capability<Region_map> create_region_map(size_t size)
+			{
+				for (;;) {
+					try { return rm.create(size); }
+					catch (Out_of_ram)  { rm.upgrade_ram(8*1024); }
+					catch (Out_of_caps) { rm.upgrade_caps(2); }
+				}
+			}
+
+			void attach(Region_map &dst, Dataspace_capability ds,
+			            size_t size, off_t offset, addr_t at)
+			{
+				for (;;) {
+					try {
+						dst.attach_at(ds, at, size, offset);
+						return;
+					}
+					catch (Out_of_ram)  { rm.upgrade_ram(8*1024); }
+					catch (Out_of_caps) { rm.upgrade_caps(2); }
+				}
+			}
+		};
+
+	private:
+
+		struct Chunk
+		{
+			Ram_backing *backing  = nullptr;
+			size_t       index    = 0;      /* chunk index within backing */
+			bool         attached = false;
+		};
+
+		/**
+		 * Chunk of a backing store temporarily attached to Noux
+		 */
+		struct Local_chunk
+		{
+			Region_map &rm;
+			char * const ptr;
+
+			Local_chunk(Region_map &rm, Ram_backing &backing, size_t index)
+			:
+				rm(rm),
+				ptr(rm.attach(backing.ds(), backing.chunk_size(index),
+				              index*CHUNK_SIZE))
+			{ }
+
+			~Local_chunk() { rm.detach(ptr); }
+		};
+
+		Resources &_res;
+
+		Cache_attribute const _cached;
 
-	Dataspace_capability fork(Ram_allocator      &ram,
-	                          Region_map         &local_rm,
-	                          Allocator          &alloc,
-	                          Dataspace_registry &ds_registry,
-	                          Rpc_entrypoint     &) override
-	{
-		size_t const size = Dataspace_client(ds_cap()).size();
-		Ram_dataspace_capability dst_ds_cap;
+		Capability<Region_map> const _rm_cap;
+		Region_map_client            _rm { _rm_cap };
 
-		try {
-			dst_ds_cap = ram.alloc(size);
+		size_t const _num_chunks = Ram_backing::num_chunks(size());
+		Chunk       *_chunks;
 
-			Attached_dataspace src_ds(local_rm, ds_cap());
-			Attached_dataspace dst_ds(local_rm, dst_ds_cap);
-			memcpy(dst_ds.local_addr<char>(), src_ds.local_addr<char>(), size);
+		/* true while the initial backing store is attached as a whole */
+		bool _attached_as_whole = false;
 
-			ds_registry.insert(new (alloc) Ram_dataspace_info(dst_ds_cap));
-			return dst_ds_cap;
+		Lock _lock;
 
-		} catch (...) {
-			error("fork of RAM dataspace failed");
+		/*
+		 * The fault handler is not installed before the chunks of the
+		 * dataspace get detached at fork time.
+		 */
+		Constructible<Signal_handler<Ram_dataspace_info> > _fault_handler;
+
+		size_t _chunk_size(size_t i) const {
+			return min((size_t)CHUNK_SIZE, size() - i*CHUNK_SIZE); }
 
-			if (dst_ds_cap.valid())
-				ram.free(dst_ds_cap);
+		Chunk *_alloc_chunks()
+		{
+			Chunk *chunks = (Chunk *)_res.alloc.alloc(_num_chunks*sizeof(Chunk));
+			for (size_t i = 0; i < _num_chunks; i++)
+				construct_at<Chunk>(&chunks[i]);
 
-			return Dataspace_capability();
+			return chunks;
 		}
-	}
 
-	void poke(Region_map &rm, addr_t dst_offset, char const *src, size_t len) override
-	{
-		if (!src) return;
+		void _release(Chunk &chunk)
+		{
+			if (chunk.backing->release(chunk.index))
+				destroy(_res.alloc, chunk.backing);
 
-		if ((dst_offset >= size()) || (dst_offset + len > size())) {
-			error("illegal attemt to write beyond dataspace boundary");
-			return;
+			chunk = Chunk();
 		}
 
-		try {
-			Attached_dataspace ds(rm, ds_cap());
-			memcpy(ds.local_addr<char>() + dst_offset, src, len);
-		} catch (...) { warning("poke: failed to attach RAM dataspace"); }
-	}
+		/**
+		 * Detach all chunks, which makes the next access fault
+		 */
+		void _detach_chunks()
+		{
+			if (_attached_as_whole) {
+				_rm.detach((addr_t)0);
+				_attached_as_whole = false;
+			}
+
+			for (size_t i = 0; i < _num_chunks; i++)
+				if (_chunks[i].attached) {
+					_rm.detach(i*CHUNK_SIZE);
+					_chunks[i].attached = false;
+				}
+
+			if (!_fault_handler.constructed()) {
+				_fault_handler.construct(_res.ep, *this,
+				                         &Ram_dataspace_info::_handle_fault);
+				_rm.fault_handler(*_fault_handler);
+			}
+		}
+
+		/**
+		 * Return chunk, copied first if it is shared with another process
+		 */
+		Chunk &_private_chunk(size_t i)
+		{
+			Chunk &chunk = _chunks[i];
+
+			if (!chunk.backing->shared(chunk.index))
+				return chunk;
+
+			Ram_backing &copy = *new (_res.alloc)
+				Ram_backing(_res.ram, _res.alloc, _chunk_size(i), _cached);
+
+			try {
+				Local_chunk const src(_res.local_rm, *chunk.backing, chunk.index);
+				Local_chunk const dst(_res.local_rm, copy, 0);
+				memcpy(dst.ptr, src.ptr, _chunk_size(i));
+			}
+			catch (...) {
+				destroy(_res.alloc, &copy);
+				throw;
+			}
+
+			_release(chunk);
+			chunk.backing = &copy;
+			return chunk;
+		}
+
+		/**
+		 * Resolve faults by attaching the touched chunks
+		 */
+		void _handle_fault()
+		{
+			Lock::Guard guard(_lock);
+
+			for (;;) {
+				Region_map::State const state = _rm.state();
+				if (state.type == Region_map::State::READY)
+					return;
+
+				size_t const i = state.addr/CHUNK_SIZE;
+				if (i >= _num_chunks || _chunks[i].attached) {
+					error("unexpected fault at RAM dataspace offset ", Hex(state.addr));
+					return;
+				}
+
+				try {
+					Chunk &chunk = _private_chunk(i);
+
+					/* the attachment resumes the faulting thread */
+					_res.attach(_rm, chunk.backing->ds(), _chunk_size(i),
+					            chunk.index*CHUNK_SIZE, i*CHUNK_SIZE);
+					chunk.attached = true;
+				}
+				catch (...) {
+					error("failed to resolve fault at RAM dataspace offset ",
+					      Hex(state.addr));
+					return;
+				}
+			}
+		}
+
+	public:
+
+		/**
+		 * Constructor for a new dataspace
+		 *
+		 * \param rm  managed dataspace of 'size' bytes
+		 *
+		 * \throw Out_of_ram
+		 * \throw Out_of_caps
+		 */
+		Ram_dataspace_info(Resources &res, Capability<Region_map> rm,
+		                   Cache_attribute cached)
+		:
+			Dataspace_info(Region_map_client(rm).dataspace()),
+			_res(res), _cached(cached), _rm_cap(rm), _chunks(_alloc_chunks())
+		{
+			Ram_backing *backing = nullptr;
+			try {
+				backing = new (_res.alloc)
+					Ram_backing(_res.ram, _res.alloc, size(), _cached);
+
+				_res.attach(_rm, backing->ds(), size(), 0, 0);
+			}
+			catch (...) {
+				if (backing)
+					destroy(_res.alloc, backing);
+
+				_res.alloc.free(_chunks, _num_chunks*sizeof(Chunk));
+				throw;
+			}
+
+			for (size_t i = 0; i < _num_chunks; i++) {
+				_chunks[i].backing = backing;
+				_chunks[i].index   = i;
+			}
+			_attached_as_whole = true;
+		}
+
+		/**
+		 * Constructor for the copy of a forked dataspace
+		 *
+		 * The new dataspace shares all chunks with 'src'.
+		 *
+		 * \param rm  managed dataspace of the size of 'src'
+		 */
+		Ram_dataspace_info(Resources &res, Capability<Region_map> rm,
+		                   Ram_dataspace_info &src)
+		:
+			Dataspace_info(Region_map_client(rm).dataspace()),
+			_res(res), _cached(src._cached), _rm_cap(rm),
+			_chunks(_alloc_chunks())
+		{
+			Lock::Guard guard(src._lock);
+
+			/* shared chunks must not be attached anywhere */
+			src._detach_chunks();
+
+			for (size_t i = 0; i < _num_chunks; i++) {
+				_chunks[i].backing = src._chunks[i].backing;
+				_chunks[i].index   = src._chunks[i].index;
+				_chunks[i].backing->acquire(_chunks[i].index);
+			}
+
+			_detach_chunks();
+		}
+
+		~Ram_dataspace_info()
+		{
+			_fault_handler.destruct();
+			_res.rm.destroy(_rm_cap);
+
+			Lock::Guard guard(_lock);
+
+			for (size_t i = 0; i < _num_chunks; i++)
+				_release(_chunks[i]);
+
+			_res.alloc.free(_chunks, _num_chunks*sizeof(Chunk));
+		}
+
+		inline Dataspace_capability fork(Pd_session_component &,
+		                                 Region_map           &,
+		                                 Allocator            &,
+		                                 Dataspace_registry   &,
+		                                 Rpc_entrypoint       &,
+		                                 Fork_state           &) override;
+
+		void poke(Region_map &, addr_t dst_offset, char const *src, size_t len) override
+		{
+			if (!src) return;
+
+			if ((dst_offset >= size()) || (dst_offset + len > size())) {
+				error("illegal attemt to write beyond dataspace boundary");
+				return;
+			}
+
+			Lock::Guard guard(_lock);
+
+			try {
+				while (len) {
+					size_t const i      = dst_offset/CHUNK_SIZE;
+					size_t const offset = dst_offset%CHUNK_SIZE;
+					size_t const n      = min(len, _chunk_size(i) - offset);
+
+					Chunk &chunk = _private_chunk(i);
+
+					Local_chunk const dst(_res.local_rm, *chunk.backing, chunk.index);
+					memcpy(dst.ptr + offset, src, n);
+
+					src += n; dst_offset += n; len -= n;
+				}
+			} catch (...) { warning("poke: failed to attach RAM dataspace"); }
+		}
 };
 
 
@@ -101,6 +370,9 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 
 		Pd_session &_ref_pd;
 
+		/* used for creating the managed RAM dataspaces */
+		Rm_connection _rm;
+
 		Region_map_component _address_space;
 		Region_map_component _stack_area;
 		Region_map_component _linker_area;
@@ -115,6 +387,18 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 
 		Dataspace_registry &_ds_registry;
 
+		Ram_dataspace_info::Resources _ds_resources;
+
+		Ram_dataspace_capability _insert(Ram_dataspace_info &ds_info)
+		{
+			_ds_registry.insert(&ds_info);
+			_ds_list.insert(&ds_info);
+
+			_used_ram_quota = Ram_quota { _used_ram_quota.value + ds_info.size() };
+
+			return static_cap_cast<Ram_dataspace>(ds_info.ds_cap());
+		}
+
 		template <typename FUNC>
 		auto _with_automatic_cap_upgrade(FUNC func) -> decltype(func())
 		{
@@ -135,11 +419,12 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 		                     Child_policy::Name const &name,
 		                     Dataspace_registry &ds_registry)
 		:
-			_ep(ep), _pd(env, name.string()), _ref_pd(env.pd()),
+			_ep(ep), _pd(env, name.string()), _ref_pd(env.pd()), _rm(env),
 			_address_space(alloc, _ep, ds_registry, _pd, _pd.address_space()),
 			_stack_area   (alloc, _ep, ds_registry, _pd, _pd.stack_area()),
 			_linker_area  (alloc, _ep, ds_registry, _pd, _pd.linker_area()),
-			_alloc(alloc), _ram(env.ram()), _ds_registry(ds_registry)
+			_alloc(alloc), _ram(env.ram()), _ds_registry(ds_registry),
+			_ds_resources { _ram, env.rm(), _alloc, _rm, env.ep() }
 		{
 			_ep.manage(this);
 
@@ -177,16 +462,34 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 		Region_map &linker_area_region_map()   { return _linker_area;   }
 		Region_map &stack_area_region_map()    { return _stack_area;    }
 
+		/**
+		 * Create dataspace that shares its content with a dataspace of
+		 * the forking process
+		 */
+		Ram_dataspace_capability fork_dataspace(Ram_dataspace_info &src)
+		{
+			Capability<Region_map> rm = _ds_resources.create_region_map(src.size());
+			try {
+				return _insert(*new (_alloc)
+					Ram_dataspace_info(_ds_resources, rm, src));
+			}
+			catch (...) {
+				_rm.destroy(rm);
+				throw;
+			}
+		}
+
 		void replay(Pd_session_component &dst_pd,
 		            Region_map           &local_rm,
 		            Allocator            &alloc,
 		            Dataspace_registry   &ds_registry,
-		            Rpc_entrypoint       &ep)
+		            Rpc_entrypoint       &ep,
+		            Fork_state           &fork_state)
 		{
 			/* replay region map into new protection domain */
-			_stack_area   .replay(dst_pd, dst_pd.stack_area_region_map(),    local_rm, alloc, ds_registry, ep);
-			_linker_area  .replay(dst_pd, dst_pd.linker_area_region_map(),   local_rm, alloc, ds_registry, ep);
-			_address_space.replay(dst_pd, dst_pd.address_space_region_map(), local_rm, alloc, ds_registry, ep);
+			_stack_area   .replay(dst_pd, dst_pd.stack_area_region_map(),    local_rm, alloc, ds_registry, ep, fork_state);
+			_linker_area  .replay(dst_pd, dst_pd.linker_area_region_map(),   local_rm, alloc, ds_registry, ep, fork_state);
+			_address_space.replay(dst_pd, dst_pd.address_space_region_map(), local_rm, alloc, ds_registry, ep, fork_state);
 
 			Region_map &dst_address_space = dst_pd.address_space_region_map();
 			Region_map &dst_stack_area    = dst_pd.stack_area_region_map();
@@ -268,16 +571,17 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 
 		Ram_dataspace_capability alloc(size_t size, Cache_attribute cached) override
 		{
-			Ram_dataspace_capability ds_cap = _ram.alloc(size, cached);
-
-			Ram_dataspace_info *ds_info = new (_alloc) Ram_dataspace_info(ds_cap);
-
-			_ds_registry.insert(ds_info);
-			_ds_list.insert(ds_info);
-
-			_used_ram_quota = Ram_quota { _used_ram_quota.value + size };
-
-			return ds_cap;
+			size = align_addr(size, 12);
+
+			Capability<Region_map> rm = _ds_resources.create_region_map(size);
+			try {
+				return _insert(*new (_alloc)
+					Ram_dataspace_info(_ds_resources, rm, cached));
+			}
+			catch (...) {
+				_rm.destroy(rm);
+				throw;
+			}
 		}
 
 		void free(Ram_dataspace_capability ds_cap) override
@@ -297,7 +601,6 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 				_ds_registry.remove(ds_info);
 				ds_info->dissolve_users();
 				_ds_list.remove(ds_info);
-				_ram.free(ds_cap);
 
 				_used_ram_quota = Ram_quota { _used_ram_quota.value - ds_size };
 			};
@@ -322,4 +625,24 @@ class Noux::Pd_session_component : public Rpc_object<Pd_session>
 			return _pd.native_pd(); }
 };
 
+
+Noux::Dataspace_capability
+Noux::Ram_dataspace_info::fork(Pd_session_component &dst_pd,
+                               Region_map           &,
+                               Allocator            &,
+                               Dataspace_registry   &,
+                               Rpc_entrypoint       &,
+                               Fork_state           &fork_state)
+{
+	try {
+		Dataspace_capability const ds_cap = dst_pd.fork_dataspace(*this);
+		fork_state.chunks_shared += _num_chunks;
+		return ds_cap;
+	}
+	catch (...) {
+		error("fork of RAM dataspace failed");
+		return Dataspace_capability();
+	}
+}
+
 #endif /* _NOUX__PD_SESSION_COMPONENT_H_ */
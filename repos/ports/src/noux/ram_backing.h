@@ -0,0 +1,128 @@
+/*
+ * \brief  Backing store of the RAM dataspaces of Noux processes
+ * \author Genode Labs
+ * \date   2017-09-04
+ */
+
+/*
+ * Copyright (C) 2017 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU Affero General Public License version 3.
+ */
+
+#ifndef _NOUX__RAM_BACKING_H_
+#define _NOUX__RAM_BACKING_H_
+
+/* Genode includes */
+#include <base/allocator.h>
+#include <base/lock.h>
+#include <base/ram_allocator.h>
+#include <util/noncopyable.h>
+
+namespace Noux {
+	class Ram_backing;
+	using namespace Genode;
+}
+
+
+/**
+ * RAM dataspace that holds the content of one or more Noux RAM dataspaces
+ *
+ * The backing store is divided into chunks. Each chunk is reference-counted
+ * because the RAM dataspaces of a forked process initially refer to the
+ * chunks of the forking process. A chunk with more than one reference must
+ * not be modified.
+ */
+class Noux::Ram_backing : Noncopyable
+{
+	public:
+
+		enum { CHUNK_SIZE = 64*1024 };
+
+		static size_t num_chunks(size_t size) {
+			return (size + CHUNK_SIZE - 1)/CHUNK_SIZE; }
+
+	private:
+
+		Ram_allocator &_ram;
+		Allocator     &_alloc;
+
+		size_t const _size;
+		size_t const _num_chunks = num_chunks(_size);
+
+		unsigned *_refs       = nullptr;  /* references per chunk */
+		size_t    _total_refs = 0;
+
+		Ram_dataspace_capability _ds;
+
+		Lock _lock;
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * Initially, each chunk is referenced once by the creator.
+		 *
+		 * \throw Out_of_ram
+		 * \throw Out_of_caps
+		 */
+		Ram_backing(Ram_allocator &ram, Allocator &alloc, size_t size,
+		            Cache_attribute cached)
+		:
+			_ram(ram), _alloc(alloc), _size(size)
+		{
+			_refs = (unsigned *)_alloc.alloc(_num_chunks*sizeof(unsigned));
+
+			try { _ds = _ram.alloc(_size, cached); }
+			catch (...) {
+				_alloc.free(_refs, _num_chunks*sizeof(unsigned));
+				throw;
+			}
+
+			for (size_t i = 0; i < _num_chunks; i++)
+				_refs[i] = 1;
+
+			_total_refs = _num_chunks;
+		}
+
+		~Ram_backing()
+		{
+			_ram.free(_ds);
+			_alloc.free(_refs, _num_chunks*sizeof(unsigned));
+		}
+
+		Ram_dataspace_capability ds() const { return _ds; }
+
+		size_t chunk_size(size_t index) const {
+			return min((size_t)CHUNK_SIZE, _size - index*CHUNK_SIZE); }
+
+		bool shared(size_t index)
+		{
+			Lock::Guard guard(_lock);
+			return _refs[index] > 1;
+		}
+
+		void acquire(size_t index)
+		{
+			Lock::Guard guard(_lock);
+			_refs[index]++;
+			_total_refs++;
+		}
+
+		/**
+		 * Drop reference to chunk
+		 *
+		 * \return  true if the backing store is no longer referenced and
+		 *          must be destroyed by the caller
+		 */
+		bool release(size_t index)
+		{
+			Lock::Guard guard(_lock);
+			_refs[index]--;
+			return --_total_refs == 0;
+		}
+};
+
+#endif /* _NOUX__RAM_BACKING_H_ */
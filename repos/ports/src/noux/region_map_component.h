@@ -155,19 +155,21 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 		/**
 		 * Replay attachments onto specified region map
 		 *
-		 * \param dst_ram      backing store used for allocating the
-		 *                     the copies of RAM dataspaces
+		 * \param dst_pd       PD session of the new process, which
+		 *                     provides the copies of RAM dataspaces
 		 * \param ds_registry  dataspace registry used for keeping track
 		 *                     of newly created dataspaces
 		 * \param ep           entrypoint used to serve the RPC interface
 		 *                     of forked managed dataspaces
+		 * \param fork_state   dataspaces forked so far
 		 */
-		void replay(Ram_allocator      &dst_ram,
-		            Region_map         &dst_rm,
-		            Region_map         &local_rm,
-		            Allocator          &alloc,
-		            Dataspace_registry &ds_registry,
-		            Rpc_entrypoint     &ep)
+		void replay(Pd_session_component &dst_pd,
+		            Region_map           &dst_rm,
+		            Region_map           &local_rm,
+		            Allocator            &alloc,
+		            Dataspace_registry   &ds_registry,
+		            Rpc_entrypoint       &ep,
+		            Fork_state           &fork_state)
 		{
 			Lock::Guard guard(_region_lock);
 			for (Region *curr = _regions.first(); curr; curr = curr->next_region()) {
@@ -177,13 +179,17 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 					Dataspace_capability ds;
 					if (info) {
 
-						ds = info->fork(dst_ram, local_rm, alloc, ds_registry, ep);
-
 						/*
-						 * XXX We could detect dataspaces that are attached
-						 *     more than once. For now, we create a new fork
-						 *     for each attachment.
+						 * A dataspace attached more than once is forked
+						 * only at its first attachment.
 						 */
+						ds = fork_state.forked(curr->ds);
+						if (!ds.valid()) {
+							ds = info->fork(dst_pd, local_rm, alloc,
+							                ds_registry, ep, fork_state);
+							if (ds.valid())
+								fork_state.record(curr->ds, ds);
+						}
 
 					} else {
 
@@ -328,11 +334,12 @@ class Noux::Region_map_component : public Rpc_object<Region_map>,
 		 ** Dataspace_info interface **
 		 ******************************/
 
-		Dataspace_capability fork(Ram_allocator      &,
-		                          Region_map         &,
-		                          Allocator          &,
-		                          Dataspace_registry &,
-		                          Rpc_entrypoint     &) override
+		Dataspace_capability fork(Pd_session_component &,
+		                          Region_map           &,
+		                          Allocator            &,
+		                          Dataspace_registry   &,
+		                          Rpc_entrypoint       &,
+		                          Fork_state           &) override
 		{
 			return Dataspace_capability();
 		}
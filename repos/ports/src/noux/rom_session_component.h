@@ -135,11 +135,12 @@ struct Noux::Rom_dataspace_info : Dataspace_info
 
 	~Rom_dataspace_info() { }
 
-	Dataspace_capability fork(Ram_allocator      &,
-	                          Region_map         &,
-	                          Allocator          &alloc,
-	                          Dataspace_registry &ds_registry,
-	                          Rpc_entrypoint     &) override
+	Dataspace_capability fork(Pd_session_component &,
+	                          Region_map           &,
+	                          Allocator            &alloc,
+	                          Dataspace_registry   &ds_registry,
+	                          Rpc_entrypoint       &,
+	                          Fork_state           &) override
 	{
 		ds_registry.insert(new (alloc) Rom_dataspace_info(ds_cap()));
 		return ds_cap();
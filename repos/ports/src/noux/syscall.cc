@@ -524,6 +524,9 @@ bool Noux::Child::syscall(Noux::Session::Syscall sc)
 				int const new_pid = _pid_allocator.alloc();
 				Child * child = nullptr;
 
+				unsigned long const start_us = _verbose.fork()
+				                             ? _timeout_scheduler.elapsed_us() : 0;
+
 				try {
 					/*
 					 * XXX To ease debugging, it would be useful to generate a
@@ -560,8 +563,15 @@ bool Noux::Child::syscall(Noux::Session::Syscall sc)
 
 				/* copy our address space into the new child */
 				try {
+					Fork_state fork_state(_heap);
+
 					_pd.replay(child->pd(), _env.rm(), _heap,
-					           child->ds_registry(), _ep);
+					           child->ds_registry(), _ep, fork_state);
+
+					if (_verbose.fork())
+						log("fork of pid ", pid(), " into pid ", new_pid, " took ",
+						    _timeout_scheduler.elapsed_us() - start_us, " us, ",
+						    fork_state.chunks_shared, " chunks shared");
 
 					/* start executing the main thread of the new process */
 					child->start_forked_main_thread(ip, sp, parent_cap_addr);
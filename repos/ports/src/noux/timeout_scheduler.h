@@ -54,6 +54,11 @@ class Noux::Timeout_scheduler : public Alarm_scheduler
 		}
 
 		Alarm::Time curr_time() const { return _curr_time; }
+
+		/**
+		 * Return precise time in microseconds, used for statistics
+		 */
+		unsigned long elapsed_us() { return _timer.elapsed_us(); }
 };
 
 
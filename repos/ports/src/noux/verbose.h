@@ -28,6 +28,7 @@ class Noux::Verbose : Genode::Noncopyable
 		bool const _ld;
 		bool const _syscalls;
 		bool const _quota;
+		bool const _fork;
 
 	public:
 
@@ -36,13 +37,15 @@ class Noux::Verbose : Genode::Noncopyable
 			_enabled (config.attribute_value("verbose",          false)),
 			_ld      (config.attribute_value("ld_verbose",       false)),
 			_syscalls(config.attribute_value("verbose_syscalls", false)),
-			_quota   (config.attribute_value("verbose_quota",    false))
+			_quota   (config.attribute_value("verbose_quota",    false)),
+			_fork    (config.attribute_value("verbose_fork",     false))
 		{ }
 
 		bool enabled()  const { return _enabled;  }
 		bool ld()       const { return _ld;       }
 		bool syscalls() const { return _syscalls; }
 		bool quota()    const { return _quota;    }
+		bool fork()     const { return _fork;     }
 };
 
 #endif /* _NOUX__VERBOSE_H_ */